@@ -0,0 +1,426 @@
+/****************************************************************************
+*	 DRAMSim2: A Cycle Accurate DRAM simulator 
+*	 
+*	 Copyright (C) 2010   	Elliott Cooper-Balis
+*									Paul Rosenfeld 
+*									Bruce Jacob
+*									University of Maryland
+*
+*	 This program is free software: you can redistribute it and/or modify
+*	 it under the terms of the GNU General Public License as published by
+*	 the Free Software Foundation, either version 3 of the License, or
+*	 (at your option) any later version.
+*
+*	 This program is distributed in the hope that it will be useful,
+*	 but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	 MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	 GNU General Public License for more details.
+*
+*	 You should have received a copy of the GNU General Public License
+*	 along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*****************************************************************************/
+
+
+
+//AsyncLog.cpp
+//
+//Class file for the asynchronous log backend
+//
+
+#include "AsyncLog.h"
+#include "LockFreeRing.h"
+#include "SystemConfiguration.h"
+#include "BusPacket.h"
+#include "Transaction.h"
+#include <cstring>
+#include <iostream>
+#include <fstream>
+#include <streambuf>
+#include <vector>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+using namespace DRAMSim;
+using namespace std;
+
+bool AsyncLog::active = false;
+
+#ifdef LOG_OUTPUT
+#define SINK DRAMSim::dramsim_log
+#else
+#define SINK std::cout
+#endif
+
+namespace
+{
+//growable character buffer behind the per-thread text stream, so queueing a
+//line never allocates once the buffer has seen the longest line
+class TextBuffer : public std::streambuf
+{
+public:
+	TextBuffer() : buffer(256)
+	{
+		clear();
+	}
+	void clear()
+	{
+		setp(&buffer[0], &buffer[0] + buffer.size());
+	}
+	const char *begin() const { return pbase(); }
+	size_t length() const { return pptr() - pbase(); }
+
+protected:
+	virtual int_type overflow(int_type c)
+	{
+		size_t used = length();
+		buffer.resize(buffer.size() * 2);
+		setp(&buffer[0], &buffer[0] + buffer.size());
+		pbump(used);
+		if (c != traits_type::eof())
+		{
+			*pptr() = c;
+			pbump(1);
+		}
+		return traits_type::not_eof(c);
+	}
+
+private:
+	std::vector<char> buffer;
+};
+
+struct ThreadLog
+{
+	ThreadLog() :
+		ring(ASYNC_LOG_RING_CAPACITY),
+		text(&textBuffer),
+		pushed(0),
+		written(0)
+	{
+	}
+
+	SPSCRing<AsyncLogEvent> ring;
+	TextBuffer textBuffer;
+	ostream text;
+	uint64_t pushed;	// by the owning thread
+	uint64_t written;	// by the writer thread, once the event is out
+};
+
+__thread ThreadLog *threadLog = NULL;
+
+vector<ThreadLog *> threadLogs;
+pthread_mutex_t threadLogsLock = PTHREAD_MUTEX_INITIALIZER;
+pthread_t writerThread;
+bool stopRequested = false;
+bool atExitRegistered = false;
+
+//the writer sleeps on wakeCond once every ring is empty, with writerIdle set;
+//	a thread that queues something while it is set wakes it up
+pthread_mutex_t wakeLock = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t wakeCond = PTHREAD_COND_INITIALIZER;
+bool writerIdle = false;
+
+ThreadLog *getThreadLog()
+{
+	if (threadLog == NULL)
+	{
+		threadLog = new ThreadLog();
+		pthread_mutex_lock(&threadLogsLock);
+		threadLogs.push_back(threadLog);
+		pthread_mutex_unlock(&threadLogsLock);
+	}
+	return threadLog;
+}
+
+//called after queueing; only costs a load while the writer is awake. Without
+//	a fence this can miss a writer that is just going to sleep, which then
+//	finds the event at its next check, see waitForEvents()
+void wakeWriter()
+{
+	if (__atomic_load_n(&writerIdle, __ATOMIC_RELAXED))
+	{
+		pthread_mutex_lock(&wakeLock);
+		pthread_cond_signal(&wakeCond);
+		pthread_mutex_unlock(&wakeLock);
+	}
+}
+
+void push(ThreadLog *log, const AsyncLogEvent &event)
+{
+	//nothing is dropped: wait for the writer to make room
+	while (!log->ring.push(event))
+	{
+		wakeWriter();
+		sched_yield();
+	}
+	log->pushed++;
+}
+
+void format(ostream &out, const AsyncLogEvent &event)
+{
+	switch (event.kind)
+	{
+	case ASYNC_LOG_TEXT:
+		out.write(event.text, event.length);
+		break;
+	case ASYNC_LOG_VALUE:
+		out << event.value.head << event.value.value << event.value.tail << '\n';
+		break;
+	case ASYNC_LOG_LINE:
+		out << event.value.head << '\n';
+		break;
+	case ASYNC_LOG_PACKET:
+	{
+		BusPacket packet((BusPacketType)event.type, event.packet.address, event.packet.column, event.packet.row,
+		                 event.packet.rank, event.packet.bank, (void *)event.packet.data, 0);
+		out << packet << '\n';
+		break;
+	}
+	case ASYNC_LOG_TRANSACTION:
+	{
+		Transaction transaction((TransactionType)event.type, event.packet.address, (void *)event.packet.data, 0);
+		out << transaction << '\n';
+		break;
+	}
+	}
+}
+
+//drains every ring into one block of text and writes it out; returns false
+//if there was nothing to do
+bool drain(ostream &formatted, TextBuffer &block)
+{
+	pthread_mutex_lock(&threadLogsLock);
+	vector<ThreadLog *> logs = threadLogs;
+	pthread_mutex_unlock(&threadLogsLock);
+
+	bool any = false;
+	for (size_t i=0; i<logs.size(); i++)
+	{
+		AsyncLogEvent event;
+		uint64_t n = 0;
+		while (logs[i]->ring.pop(event))
+		{
+			format(formatted, event);
+			n++;
+		}
+		if (n == 0)
+		{
+			continue;
+		}
+		SINK.write(block.begin(), block.length());
+		SINK.flush();
+		block.clear();
+		__atomic_store_n(&logs[i]->written, logs[i]->written + n, __ATOMIC_RELEASE);
+		any = true;
+	}
+	return any;
+}
+
+bool anyQueued()
+{
+	pthread_mutex_lock(&threadLogsLock);
+	bool queued = false;
+	for (size_t i=0; i<threadLogs.size() && !queued; i++)
+	{
+		queued = threadLogs[i]->ring.count() > 0;
+	}
+	pthread_mutex_unlock(&threadLogsLock);
+	return queued;
+}
+
+//sleeps until something is queued or the writer is asked to stop, looking at
+//the rings every ASYNC_LOG_SLEEP_CHECK_US in case a wakeup was missed
+void waitForEvents()
+{
+	pthread_mutex_lock(&wakeLock);
+	__atomic_store_n(&writerIdle, true, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	while (!anyQueued() && !__atomic_load_n(&stopRequested, __ATOMIC_ACQUIRE))
+	{
+		struct timespec deadline;
+		clock_gettime(CLOCK_REALTIME, &deadline);
+		deadline.tv_nsec += ASYNC_LOG_SLEEP_CHECK_US * 1000L;
+		if (deadline.tv_nsec >= 1000000000L)
+		{
+			deadline.tv_sec++;
+			deadline.tv_nsec -= 1000000000L;
+		}
+		pthread_cond_timedwait(&wakeCond, &wakeLock, &deadline);
+	}
+	__atomic_store_n(&writerIdle, false, __ATOMIC_RELAXED);
+	pthread_mutex_unlock(&wakeLock);
+}
+
+void *writerMain(void *)
+{
+	TextBuffer block;
+	ostream formatted(&block);
+	unsigned emptyDrains = 0;
+	for (;;)
+	{
+		bool stopping = __atomic_load_n(&stopRequested, __ATOMIC_ACQUIRE);
+		if (drain(formatted, block))
+		{
+			emptyDrains = 0;
+		}
+		else if (stopping)
+		{
+			break;
+		}
+		//while output keeps coming, yielding is cheaper than being woken
+		else if (++emptyDrains < ASYNC_LOG_SPIN_DRAINS)
+		{
+			sched_yield();
+		}
+		else
+		{
+			waitForEvents();
+			emptyDrains = 0;
+		}
+	}
+	return NULL;
+}
+
+void stopAtExit()
+{
+	AsyncLog::stop();
+}
+
+//the writer thread does not survive a fork(); the child prints directly
+void resetInChild()
+{
+	AsyncLog::active = false;
+	threadLogs.clear();
+	threadLog = NULL;
+}
+}
+
+void AsyncLog::start()
+{
+	if (active)
+	{
+		return;
+	}
+	stopRequested = false;
+	if (pthread_create(&writerThread, NULL, writerMain, NULL) != 0)
+	{
+		ERROR("== Error - could not start the log writer thread");
+		exit(-1);
+	}
+	if (!atExitRegistered)
+	{
+		atexit(stopAtExit);
+		pthread_atfork(NULL, NULL, resetInChild);
+		atExitRegistered = true;
+	}
+	active = true;
+}
+
+void AsyncLog::stop()
+{
+	if (!active)
+	{
+		return;
+	}
+	active = false;
+	pthread_mutex_lock(&wakeLock);
+	__atomic_store_n(&stopRequested, true, __ATOMIC_RELEASE);
+	pthread_cond_signal(&wakeCond);
+	pthread_mutex_unlock(&wakeLock);
+	pthread_join(writerThread, NULL);
+}
+
+void AsyncLog::flush()
+{
+	if (!active)
+	{
+		return;
+	}
+	pthread_mutex_lock(&threadLogsLock);
+	vector<ThreadLog *> logs = threadLogs;
+	pthread_mutex_unlock(&threadLogsLock);
+	for (size_t i=0; i<logs.size(); i++)
+	{
+		while (__atomic_load_n(&logs[i]->written, __ATOMIC_ACQUIRE) < __atomic_load_n(&logs[i]->pushed, __ATOMIC_RELAXED))
+		{
+			sched_yield();
+		}
+	}
+}
+
+ostream &AsyncLog::beginText()
+{
+	ThreadLog *log = getThreadLog();
+	log->textBuffer.clear();
+	//floats come out the way the sink is set up (ex: by printStats()); hex
+	//and dec stick to this stream from one line to the next, as on the sink
+	log->text.precision(SINK.precision());
+	log->text.setf(SINK.flags() & ios::floatfield, ios::floatfield);
+	return log->text;
+}
+
+void AsyncLog::endText()
+{
+	ThreadLog *log = threadLog;
+	const char *text = log->textBuffer.begin();
+	size_t length = log->textBuffer.length();
+
+	AsyncLogEvent event;
+	event.kind = ASYNC_LOG_TEXT;
+	while (length > 0)
+	{
+		event.length = length < ASYNC_LOG_TEXT_BYTES ? length : ASYNC_LOG_TEXT_BYTES;
+		memcpy(event.text, text, event.length);
+		push(log, event);
+		text += event.length;
+		length -= event.length;
+	}
+	wakeWriter();
+}
+
+void AsyncLog::value(const char *head, uint64_t value, const char *tail)
+{
+	AsyncLogEvent event;
+	event.kind = ASYNC_LOG_VALUE;
+	event.value.head = head;
+	event.value.value = value;
+	event.value.tail = tail;
+	push(getThreadLog(), event);
+	wakeWriter();
+}
+
+void AsyncLog::line(const char *text)
+{
+	AsyncLogEvent event;
+	event.kind = ASYNC_LOG_LINE;
+	event.value.head = text;
+	push(getThreadLog(), event);
+	wakeWriter();
+}
+
+void AsyncLog::packet(const BusPacket &packet)
+{
+	AsyncLogEvent event;
+	event.kind = ASYNC_LOG_PACKET;
+	event.type = packet.busPacketType;
+	event.packet.address = packet.physicalAddress;
+	event.packet.data = packet.data;
+	event.packet.rank = packet.rank;
+	event.packet.bank = packet.bank;
+	event.packet.row = packet.row;
+	event.packet.column = packet.column;
+	push(getThreadLog(), event);
+	wakeWriter();
+}
+
+void AsyncLog::transaction(const Transaction &transaction)
+{
+	AsyncLogEvent event;
+	event.kind = ASYNC_LOG_TRANSACTION;
+	event.type = transaction.transactionType;
+	event.packet.address = transaction.address;
+	event.packet.data = transaction.data;
+	push(getThreadLog(), event);
+	wakeWriter();
+}
@@ -0,0 +1,125 @@
+/****************************************************************************
+*	 DRAMSim2: A Cycle Accurate DRAM simulator 
+*	 
+*	 Copyright (C) 2010   	Elliott Cooper-Balis
+*									Paul Rosenfeld 
+*									Bruce Jacob
+*									University of Maryland
+*
+*	 This program is free software: you can redistribute it and/or modify
+*	 it under the terms of the GNU General Public License as published by
+*	 the Free Software Foundation, either version 3 of the License, or
+*	 (at your option) any later version.
+*
+*	 This program is distributed in the hope that it will be useful,
+*	 but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	 MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	 GNU General Public License for more details.
+*
+*	 You should have received a copy of the GNU General Public License
+*	 along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*****************************************************************************/
+
+#ifndef ASYNCLOG_H
+#define ASYNCLOG_H
+
+//AsyncLog.h
+//
+//Asynchronous backend for the PRINT macros (PrintMacros.h), turned on with
+//ASYNC_LOG_OUTPUT in the system ini file. Every thread that prints gets its
+//own single producer ring of fixed-size events; a background writer thread
+//drains the rings, formats the events and writes them out in large blocks,
+//and sleeps on a condition variable while they stay empty. Queueing only
+//signals it when it is asleep, without a fence; the one wakeup that can be
+//missed that way is caught by the writer checking the rings every
+//ASYNC_LOG_SLEEP_CHECK_US while it sleeps.
+//PRINT lines are still formatted by the caller and queued as text, but bus
+//packets, transactions and the per-cycle power lines are queued as raw
+//fields and only formatted by the writer, so tracing with DEBUG_BUS and
+//friends no longer costs a formatted, flushed line on the simulation thread.
+//
+//A full ring makes the printing thread wait for the writer; nothing is ever
+//dropped. Whatever is still queued is written out at exit().
+//
+
+#include <ostream>
+#include <stdint.h>
+
+//bytes of text carried by one event; longer lines take several
+#define ASYNC_LOG_TEXT_BYTES 56
+//events per thread ring
+#define ASYNC_LOG_RING_CAPACITY 16384
+//empty passes over the rings before the writer goes to sleep
+#define ASYNC_LOG_SPIN_DRAINS 256
+//how often the sleeping writer looks at the rings anyway
+#define ASYNC_LOG_SLEEP_CHECK_US 1000
+
+namespace DRAMSim
+{
+class BusPacket;
+class Transaction;
+
+enum AsyncLogEventKind
+{
+	ASYNC_LOG_TEXT,
+	ASYNC_LOG_VALUE,	// head, a number, tail and a newline
+	ASYNC_LOG_LINE,	// head and a newline
+	ASYNC_LOG_PACKET,
+	ASYNC_LOG_TRANSACTION
+};
+
+struct AsyncLogEvent
+{
+	uint8_t kind;
+	uint8_t type;	// BusPacketType or TransactionType
+	uint16_t length;	// of text
+	uint32_t unused;
+	union
+	{
+		char text[ASYNC_LOG_TEXT_BYTES];
+		struct
+		{
+			uint64_t address;
+			const void *data;	// only its value is printed
+			uint32_t rank;
+			uint32_t bank;
+			uint32_t row;
+			uint32_t column;
+		} packet;
+		struct
+		{
+			const char *head;	// string literals, so they outlive the event
+			const char *tail;
+			uint64_t value;
+		} value;
+	};
+};
+
+class AsyncLog
+{
+public:
+	//starts the writer thread; does nothing if it is already running
+	static void start();
+	//writes out everything queued so far and stops the writer thread
+	static void stop();
+	//waits until everything queued so far has been written
+	static void flush();
+
+	//text is formatted into a per-thread stream between these two
+	static std::ostream &beginText();
+	static void endText();
+
+	static void value(const char *head, uint64_t value, const char *tail);
+	//text must be a string literal
+	static void line(const char *text);
+	static void packet(const BusPacket &packet);
+	static void transaction(const Transaction &transaction);
+
+	//checked by the PRINT macros
+	static bool active;
+};
+}
+
+#endif
+
@@ -129,7 +129,7 @@ void Bank::write(const BusPacket *busPacket)
 	{
 		// found it, just plaster in the new data
 		foundNode->data = busPacket->data;
-		if (DEBUG_BANKS)
+		if (TRACE_ON(TRACE_COMMANDS, DEBUG_BANKS))
 		{
 			PRINTN(" -- Bank "<<busPacket->bank<<" writing to physical address 0x" << hex << busPacket->physicalAddress<<dec<<":");
 			BusPacket::printData(busPacket->data);
@@ -36,6 +36,12 @@
 using namespace std;
 using namespace DRAMSim;
 
+const char *DRAMSim::stallReasonNames[STALL_REASONS] =
+{
+	"command_bus", "tRCD", "tRP", "tRAS", "tRC", "tRRD", "tFAW", "tCCD", "write_to_read", "read_to_write",
+	"rank_switch", "column_to_precharge", "row_conflict", "refresh", "power_down", "row_access_cap"
+};
+
 //All banks start precharged
 BankState::BankState():
 		currentBankState(Idle),
@@ -45,6 +51,10 @@ BankState::BankState():
 		nextActivate(0),
 		nextPrecharge(0),
 		nextPowerUp(0),
+		nextReadReason(STALL_COMMAND_BUS),
+		nextWriteReason(STALL_COMMAND_BUS),
+		nextActivateReason(STALL_COMMAND_BUS),
+		nextPrechargeReason(STALL_COMMAND_BUS),
 		lastCommand(READ),
 		stateChangeCountdown(0)
 {}
@@ -36,6 +36,7 @@
 
 #include "SystemConfiguration.h"
 #include "BusPacket.h"
+#include "StallReason.h"
 
 namespace DRAMSim
 {
@@ -60,12 +61,52 @@ public:
 	uint64_t nextPrecharge;
 	uint64_t nextPowerUp;
 
+	//which constraint set each of the times above
+	StallReason nextReadReason;
+	StallReason nextWriteReason;
+	StallReason nextActivateReason;
+	StallReason nextPrechargeReason;
+
 	BusPacketType lastCommand;
 	uint stateChangeCountdown;
 
 	//Functions
 	BankState();
 	void print();
+
+	//push a time out to cycle (never back), remembering why
+	void delayRead(uint64_t cycle, StallReason reason)
+	{
+		if (cycle > nextRead)
+		{
+			nextRead = cycle;
+			nextReadReason = reason;
+		}
+	}
+	void delayWrite(uint64_t cycle, StallReason reason)
+	{
+		if (cycle > nextWrite)
+		{
+			nextWrite = cycle;
+			nextWriteReason = reason;
+		}
+	}
+	void delayActivate(uint64_t cycle, StallReason reason)
+	{
+		if (cycle > nextActivate)
+		{
+			nextActivate = cycle;
+			nextActivateReason = reason;
+		}
+	}
+	void delayPrecharge(uint64_t cycle, StallReason reason)
+	{
+		if (cycle > nextPrecharge)
+		{
+			nextPrecharge = cycle;
+			nextPrechargeReason = reason;
+		}
+	}
 };
 }
 
@@ -0,0 +1,73 @@
+/****************************************************************************
+*	 DRAMSim2: A Cycle Accurate DRAM simulator 
+*	 
+*	 Copyright (C) 2010   	Elliott Cooper-Balis
+*									Paul Rosenfeld 
+*									Bruce Jacob
+*									University of Maryland
+*
+*	 This program is free software: you can redistribute it and/or modify
+*	 it under the terms of the GNU General Public License as published by
+*	 the Free Software Foundation, either version 3 of the License, or
+*	 (at your option) any later version.
+*
+*	 This program is distributed in the hope that it will be useful,
+*	 but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	 MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	 GNU General Public License for more details.
+*
+*	 You should have received a copy of the GNU General Public License
+*	 along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*****************************************************************************/
+#ifndef BATCHTYPES_H
+#define BATCHTYPES_H
+
+//BatchTypes.h
+//
+//Plain structures exchanged through the batch-stepping interface
+//(MemorySystem::addTransactions() / MemorySystem::advance()) and the
+//thread-safe submission/completion rings. They are
+//shared by MemorySystem.h and the public DRAMSim.h header so that a host
+//simulator can hand over and collect whole arrays of requests without a
+//per-transaction call or callback
+//
+
+#include <stdint.h>
+
+namespace DRAMSim
+{
+//a request handed to addTransactions()
+struct TransactionRequest
+{
+	uint64_t id;
+	uint64_t address;
+	bool isWrite;
+};
+
+//a request pushed into the submission ring by a host thread; timestamp is
+//the memory system cycle at which it should be admitted
+struct SubmittedTransaction
+{
+	uint64_t timestamp;
+	uint64_t id;
+	uint64_t address;
+	unsigned producerID;
+	bool isWrite;
+};
+
+//one finished transaction as written out by advance()
+struct CompletionRecord
+{
+	uint64_t id;
+	uint64_t address;
+	uint64_t issueCycle;	// cycle the request was handed to the memory system
+	uint64_t doneCycle;		// cycle the read data returned / the write burst finished
+	bool isWrite;
+};
+
+//at most one read return and one write burst can finish in the same cycle
+#define MAX_COMPLETIONS_PER_CYCLE 2
+}
+
+#endif
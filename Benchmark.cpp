@@ -0,0 +1,579 @@
+/****************************************************************************
+*	 DRAMSim2: A Cycle Accurate DRAM simulator 
+*	 
+*	 Copyright (C) 2010   	Elliott Cooper-Balis
+*									Paul Rosenfeld 
+*									Bruce Jacob
+*									University of Maryland
+*
+*	 This program is free software: you can redistribute it and/or modify
+*	 it under the terms of the GNU General Public License as published by
+*	 the Free Software Foundation, either version 3 of the License, or
+*	 (at your option) any later version.
+*
+*	 This program is distributed in the hope that it will be useful,
+*	 but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	 MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	 GNU General Public License for more details.
+*
+*	 You should have received a copy of the GNU General Public License
+*	 along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*****************************************************************************/
+
+//Benchmark.cpp
+//
+//Measures the simulator's own speed: simulated cycles and completed
+//transactions per host second of MemorySystem::update for every device,
+//row buffer policy and queuing structure under idle, streaming, random and
+//bank conflict traffic, plus isolated loops over addressMapping,
+//CommandQueue::pop and parseTraceLine. Results are written as JSON so runs
+//can be compared across changes.
+//
+//The configuration is process-wide, so each device/policy/structure
+//combination is simulated in a child process of its own. Children run one
+//at a time to keep the timings undisturbed.
+//
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <getopt.h>
+#include <glob.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <cstring>
+#include <ctime>
+
+#include "SystemConfiguration.h"
+#include "MemorySystem.h"
+#include "CommandQueue.h"
+#include "IniReader.h"
+#include "TraceReader.h"
+#include "TrafficGenerator.h"
+
+using namespace DRAMSim;
+using namespace std;
+
+#define BENCH_MAX_RESULTS 8
+//requests in flight, for the traffic patterns and the command queue alike
+#define BENCH_OUTSTANDING 64
+
+struct BenchResult
+{
+	char name[32];			// "update" or the micro-benchmark
+	char traffic[16];		// update only
+	uint64_t iterations;	// simulated cycles or calls
+	uint64_t transactions;	// completed transactions, or calls that did work
+	double seconds;
+};
+
+struct BenchCase
+{
+	string device;
+	string rowBufferPolicy;
+	string queuingStructure;
+	string systemIni;
+	unsigned megsOfMemory;
+	bool mappingBench;
+};
+
+static const char *trafficNames[] = {"idle", "stream", "random", "bank_conflict"};
+static const char *trafficSpecs[] = {NULL, "stream,reads=0.67", "uniform,reads=0.67", "rowhostile,reads=0.67"};
+#define NUM_TRAFFIC (sizeof(trafficNames)/sizeof(trafficNames[0]))
+
+static double hostSeconds()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1E-9;
+}
+
+static void setResult(BenchResult &result, const char *name, const char *traffic)
+{
+	memset(&result, 0, sizeof(result));
+	strncpy(result.name, name, sizeof(result.name)-1);
+	strncpy(result.traffic, traffic, sizeof(result.traffic)-1);
+}
+
+void usage()
+{
+	cout << "dramsim-bench Usage: " << endl;
+	cout << "dramsim-bench -s system.ini [-d ini/device.ini ...] [options]" <<endl;
+	cout << "\t-s, --systemini=FILENAME \tbase memory system parameters; both row buffer policies and"<<endl;
+	cout << "\t\t\t\t\tqueuing structures are substituted into it"<<endl;
+	cout << "\t-d, --deviceini=FILENAME \tdevice to benchmark; may be given several times [default=ini/*.ini]"<<endl;
+	cout << "\t-p, --pwd=DIRECTORY\t\tdirectory the ini files are relative to"<<endl;
+	cout << "\t-c, --numcycles=# \t\tcycles simulated per traffic pattern [default=100000]"<<endl;
+	cout << "\t-n, --iterations=# \t\tcalls per micro-benchmark [default=1000000]"<<endl;
+	cout << "\t-m, --size=# \t\t\tsize of the memory system in megabytes [default=2048]"<<endl;
+	cout << "\t-o, --output=FILENAME \t\tJSON output [default=stdout]"<<endl;
+}
+
+//one MemorySystem::update loop; a NULL spec leaves the memory system idle
+void benchUpdate(BenchResult &result, const BenchCase &bc, const string &pwd, const char *traffic, const char *spec, uint64_t cycles)
+{
+	setResult(result, "update", traffic);
+
+	MemorySystem *memorySystem = new MemorySystem(0, bc.device, bc.systemIni, pwd, "bench", bc.megsOfMemory);
+	TrafficGenerator *generator = NULL;
+	if (spec != NULL)
+	{
+		TrafficGeneratorConfig config = TrafficGenerator::parseSpec(spec);
+		config.rate = 1.0;
+		config.maxOutstanding = BENCH_OUTSTANDING;
+		generator = new TrafficGenerator(memorySystem, config);
+	}
+
+	double start = hostSeconds();
+	if (generator != NULL)
+	{
+		for (uint64_t i=0; i<cycles; i++)
+		{
+			generator->update();
+			memorySystem->update();
+		}
+		result.transactions = generator->Completed();
+	}
+	else
+	{
+		for (uint64_t i=0; i<cycles; i++)
+		{
+			memorySystem->update();
+		}
+	}
+	result.seconds = hostSeconds() - start;
+	result.iterations = cycles;
+
+	delete generator;
+	delete memorySystem;
+}
+
+//decodes pseudo-random addresses through the configured mapping scheme
+void benchAddressMapping(BenchResult &result, MemorySystem *memorySystem, uint64_t iterations)
+{
+	setResult(result, "addressMapping", "");
+
+	uint64_t x = 0x9E3779B97F4A7C15ULL;
+	uint64_t sink = 0;
+	uint rank, bank, row, col;
+	double start = hostSeconds();
+	for (uint64_t i=0; i<iterations; i++)
+	{
+		x ^= x << 13;
+		x ^= x >> 7;
+		x ^= x << 17;
+		memorySystem->memoryController->addressMapping(x, rank, bank, row, col);
+		sink += rank + bank + row + col;
+	}
+	result.seconds = hostSeconds() - start;
+	result.iterations = iterations;
+	result.transactions = sink == 0 ? 0 : iterations;
+}
+
+//keeps BENCH_OUTSTANDING ACTIVATE/column command pairs to random banks in a
+//command queue and pops it once per call, tracking only what pop()
+//needs of the bank state
+void benchCommandQueuePop(BenchResult &result, uint64_t iterations)
+{
+	setResult(result, "CommandQueue::pop", "");
+
+	vector< vector<BankState> > bankStates(NUM_RANKS, vector<BankState>(NUM_BANKS, BankState()));
+	CommandQueue *commandQueue = new CommandQueue(bankStates);
+	BusPacketType columnCommand = rowBufferPolicy == ClosePage ? READ_P : READ;
+
+	uint64_t x = 0x2545F4914F6CDD1DULL;
+	uint64_t popped = 0;
+	unsigned pending = 0;
+	double start = hostSeconds();
+	for (uint64_t i=0; i<iterations; i++)
+	{
+		x ^= x << 13;
+		x ^= x >> 7;
+		x ^= x << 17;
+		uint rank = x % NUM_RANKS;
+		uint bank = (x >> 8) % NUM_BANKS;
+		uint row = (x >> 16) % NUM_ROWS;
+		if (pending < 2*BENCH_OUTSTANDING && commandQueue->hasRoomFor(2, rank, bank))
+		{
+			commandQueue->enqueue(new BusPacket(ACTIVATE, 0, 0, row, rank, bank, NULL, 0));
+			commandQueue->enqueue(new BusPacket(columnCommand, 0, 0, row, rank, bank, NULL, 0));
+			pending += 2;
+		}
+
+		BusPacket *busPacket;
+		if (commandQueue->pop(&busPacket))
+		{
+			BankState &state = bankStates[busPacket->rank][busPacket->bank];
+			switch (busPacket->busPacketType)
+			{
+			case ACTIVATE:
+				state.currentBankState = RowActive;
+				state.openRowAddress = busPacket->row;
+				pending--;
+				break;
+			case READ_P:
+			case WRITE_P:
+				state.currentBankState = Idle;
+				pending--;
+				break;
+			case PRECHARGE:
+				//made up by the queue itself in open page mode
+				state.currentBankState = Idle;
+				break;
+			default:
+				pending--;
+				break;
+			}
+			delete busPacket;
+			popped++;
+		}
+		commandQueue->step();
+	}
+	result.seconds = hostSeconds() - start;
+	result.iterations = iterations;
+	result.transactions = popped;
+
+	delete commandQueue;
+}
+
+//parses an in-memory trace of each text format
+void benchParseTraceLine(vector<BenchResult> &results, uint64_t iterations)
+{
+	static const TraceType types[] = {k6, mase, misc};
+	static const char *names[] = {"k6", "mase", "misc"};
+	for (size_t t=0; t<3; t++)
+	{
+		ostringstream trace;
+		uint64_t x = 0x9E3779B97F4A7C15ULL;
+		for (unsigned i=0; i<4096; i++)
+		{
+			x ^= x << 13;
+			x ^= x >> 7;
+			x ^= x << 17;
+			uint64_t address = (x >> 20) & ~0x3FULL;
+			bool isWrite = (x & 3) == 0;
+			trace << "0x" << hex << address << dec;
+			switch (types[t])
+			{
+			case k6:
+				trace << " " << (isWrite ? "P_MEM_WR" : "P_MEM_RD") << " " << i*10;
+				break;
+			case mase:
+				trace << " " << (isWrite ? "WRITE" : "READ") << " " << i*10;
+				break;
+			case misc:
+				trace << " " << (isWrite ? "write" : "read");
+				break;
+			}
+			trace << "\n";
+		}
+		string text = trace.str();
+		vector<const char *> lines;
+		for (size_t pos = 0; pos < text.size(); pos = text.find('\n', pos) + 1)
+		{
+			lines.push_back(text.c_str() + pos);
+		}
+		lines.push_back(text.c_str() + text.size());
+
+		BenchResult result;
+		setResult(result, "parseTraceLine", names[t]);
+		TraceRecord record;
+		uint64_t sink = 0;
+		size_t numLines = lines.size() - 1;
+		double start = hostSeconds();
+		for (uint64_t i=0; i<iterations; i++)
+		{
+			size_t l = i % numLines;
+			if (parseTraceLine(lines[l], lines[l+1] - 1, types[t], record, false))
+			{
+				sink += record.address + record.cycle;
+			}
+		}
+		result.seconds = hostSeconds() - start;
+		result.iterations = iterations;
+		result.transactions = sink == 0 ? 0 : iterations;
+		results.push_back(result);
+	}
+}
+
+//runs in a child process
+unsigned runCase(BenchResult *results, const BenchCase &bc, const string &pwd, uint64_t cycles, uint64_t iterations)
+{
+	unsigned n = 0;
+	for (size_t t=0; t<NUM_TRAFFIC; t++)
+	{
+		benchUpdate(results[n++], bc, pwd, trafficNames[t], trafficSpecs[t], cycles);
+	}
+
+	//a memory system sets up the configuration the micro-benchmarks use
+	MemorySystem *memorySystem = new MemorySystem(0, bc.device, bc.systemIni, pwd, "bench", bc.megsOfMemory);
+	benchCommandQueuePop(results[n++], iterations);
+	if (bc.mappingBench)
+	{
+		benchAddressMapping(results[n++], memorySystem, iterations);
+	}
+	delete memorySystem;
+	return n;
+}
+
+void printJSONResult(ostream &json, const BenchResult &result, const BenchCase *bc, bool last)
+{
+	json << "    {\"benchmark\": \"" << result.name << "\"";
+	if (bc != NULL)
+	{
+		json << ", \"device\": \"" << bc->device << "\", \"row_buffer_policy\": \"" << bc->rowBufferPolicy
+		     << "\", \"queuing_structure\": \"" << bc->queuingStructure << "\"";
+	}
+	if (result.traffic[0] != '\0')
+	{
+		json << ", \"" << (bc != NULL ? "traffic" : "format") << "\": \"" << result.traffic << "\"";
+	}
+	double seconds = result.seconds > 0 ? result.seconds : 1E-9;
+	if (strcmp(result.name, "update") == 0)
+	{
+		json << ", \"cycles\": " << result.iterations << ", \"transactions\": " << result.transactions
+		     << ", \"host_seconds\": " << result.seconds
+		     << ", \"cycles_per_second\": " << (uint64_t)(result.iterations / seconds)
+		     << ", \"transactions_per_second\": " << (uint64_t)(result.transactions / seconds);
+	}
+	else
+	{
+		json << ", \"calls\": " << result.iterations << ", \"host_seconds\": " << result.seconds
+		     << ", \"calls_per_second\": " << (uint64_t)(result.iterations / seconds)
+		     << ", \"ns_per_call\": " << result.seconds * 1E9 / result.iterations;
+		if (strcmp(result.name, "CommandQueue::pop") == 0)
+		{
+			json << ", \"issued\": " << result.transactions;
+		}
+	}
+	json << "}" << (last ? "" : ",") << "\n";
+}
+
+int main(int argc, char **argv)
+{
+	vector<string> deviceInis;
+	string systemIni = "";
+	string pwd = "";
+	string outputFilename = "";
+	uint64_t cycles = 100000, iterations = 1000000;
+	unsigned megsOfMemory = 2048;
+
+	while (1)
+	{
+		static struct option long_options[] =
+		{
+			{"deviceini", required_argument, 0, 'd'},
+			{"systemini", required_argument, 0, 's'},
+			{"pwd", required_argument, 0, 'p'},
+			{"numcycles", required_argument, 0, 'c'},
+			{"iterations", required_argument, 0, 'n'},
+			{"size", required_argument, 0, 'm'},
+			{"output", required_argument, 0, 'o'},
+			{"help", no_argument, 0, 'h'},
+			{0, 0, 0, 0}
+		};
+		int option_index=0;
+		int c = getopt_long(argc, argv, "d:s:p:c:n:m:o:h", long_options, &option_index);
+		if (c == -1)
+		{
+			break;
+		}
+		switch (c)
+		{
+		case 'd':
+			deviceInis.push_back(optarg);
+			break;
+		case 's':
+			systemIni = optarg;
+			break;
+		case 'p':
+			pwd = optarg;
+			break;
+		case 'c':
+			cycles = strtoull(optarg, NULL, 10);
+			break;
+		case 'n':
+			iterations = strtoull(optarg, NULL, 10);
+			break;
+		case 'm':
+			megsOfMemory = atoi(optarg);
+			break;
+		case 'o':
+			outputFilename = optarg;
+			break;
+		case 'h':
+			usage();
+			exit(0);
+		default:
+			usage();
+			exit(-1);
+		}
+	}
+
+	if (systemIni.length() == 0)
+	{
+		ERROR("Please provide a system ini file");
+		usage();
+		exit(-1);
+	}
+	if (cycles == 0 || iterations == 0)
+	{
+		ERROR("== numcycles and iterations must be positive");
+		exit(-1);
+	}
+	if (pwd.length() > 0 && systemIni[0] != '/')
+	{
+		systemIni = pwd + "/" + systemIni;
+	}
+	if (deviceInis.size() == 0)
+	{
+		string pattern = (pwd.length() > 0 ? pwd + "/" : "") + "ini/*.ini";
+		glob_t globbed;
+		if (glob(pattern.c_str(), 0, NULL, &globbed) == 0)
+		{
+			for (size_t i=0; i<globbed.gl_pathc; i++)
+			{
+				deviceInis.push_back(globbed.gl_pathv[i]);
+			}
+		}
+		globfree(&globbed);
+		if (deviceInis.size() == 0)
+		{
+			ERROR("== No device ini files found under '"<<pattern<<"'");
+			exit(-1);
+		}
+		//already includes pwd
+		pwd = "";
+	}
+
+	SHOW_SIM_OUTPUT = 0;
+	MemorySystem::disableSideOutputs();
+
+	static const char *policies[] = {"open_page", "close_page"};
+	static const char *structures[] = {"per_rank", "per_rank_per_bank"};
+	vector<BenchCase> cases;
+	vector<string> variants;
+	for (size_t p=0; p<2; p++)
+	{
+		for (size_t s=0; s<2; s++)
+		{
+			vector<string> keys, values;
+			keys.push_back("ROW_BUFFER_POLICY");
+			values.push_back(policies[p]);
+			keys.push_back("QUEUING_STRUCTURE");
+			values.push_back(structures[s]);
+			variants.push_back(IniReader::WriteIniVariant(systemIni, keys, values));
+		}
+	}
+	for (size_t d=0; d<deviceInis.size(); d++)
+	{
+		for (size_t v=0; v<variants.size(); v++)
+		{
+			BenchCase bc;
+			bc.device = deviceInis[d];
+			bc.rowBufferPolicy = policies[v/2];
+			bc.queuingStructure = structures[v%2];
+			bc.systemIni = variants[v];
+			bc.megsOfMemory = megsOfMemory;
+			bc.mappingBench = v == 0;
+			cases.push_back(bc);
+		}
+	}
+
+	vector<BenchResult> parserResults;
+	benchParseTraceLine(parserResults, iterations);
+
+	vector< vector<BenchResult> > caseResults(cases.size());
+	for (size_t i=0; i<cases.size(); i++)
+	{
+		cerr << "== " << cases[i].device << " " << cases[i].rowBufferPolicy << " " << cases[i].queuingStructure << endl;
+		int fds[2];
+		if (pipe(fds) != 0)
+		{
+			ERROR("== Error - could not create a pipe");
+			exit(-1);
+		}
+		cout.flush();
+		pid_t pid = fork();
+		if (pid < 0)
+		{
+			ERROR("== Error - could not fork a worker");
+			exit(-1);
+		}
+		if (pid == 0)
+		{
+			close(fds[0]);
+			//the JSON may be going to stdout, keep the model's banners out of it
+			int devNull = open("/dev/null", O_WRONLY);
+			if (devNull >= 0)
+			{
+				dup2(devNull, STDOUT_FILENO);
+				close(devNull);
+			}
+			BenchResult results[BENCH_MAX_RESULTS];
+			unsigned n = runCase(results, cases[i], pwd, cycles, iterations);
+			ssize_t written = write(fds[1], results, n*sizeof(BenchResult));
+			_exit(written == (ssize_t)(n*sizeof(BenchResult)) ? 0 : 1);
+		}
+		close(fds[1]);
+		BenchResult result;
+		while (read(fds[0], &result, sizeof(result)) == sizeof(result))
+		{
+			caseResults[i].push_back(result);
+		}
+		close(fds[0]);
+		int status;
+		waitpid(pid, &status, 0);
+		if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+		{
+			ERROR("== Benchmark of '"<<cases[i].device<<"' ("<<cases[i].rowBufferPolicy<<", "<<cases[i].queuingStructure<<") failed");
+		}
+	}
+	for (size_t v=0; v<variants.size(); v++)
+	{
+		unlink(variants[v].c_str());
+	}
+
+	ofstream outputFile;
+	if (outputFilename.length() > 0)
+	{
+		outputFile.open(outputFilename.c_str());
+		if (!outputFile)
+		{
+			ERROR("== Error - could not open output file '"<<outputFilename<<"'");
+			exit(-1);
+		}
+	}
+	ostream &json = outputFilename.length() > 0 ? outputFile : cout;
+
+	char hostname[256] = "";
+	gethostname(hostname, sizeof(hostname)-1);
+	json << "{\n";
+	json << "  \"host\": \"" << hostname << "\",\n";
+	json << "  \"timestamp\": " << time(NULL) << ",\n";
+	json << "  \"system_ini\": \"" << systemIni << "\",\n";
+	json << "  \"cycles\": " << cycles << ",\n";
+	json << "  \"iterations\": " << iterations << ",\n";
+	json << "  \"results\": [\n";
+	size_t remaining = parserResults.size();
+	for (size_t i=0; i<cases.size(); i++)
+	{
+		remaining += caseResults[i].size();
+	}
+	for (size_t i=0; i<parserResults.size(); i++)
+	{
+		printJSONResult(json, parserResults[i], NULL, --remaining == 0);
+	}
+	for (size_t i=0; i<cases.size(); i++)
+	{
+		for (size_t j=0; j<caseResults[i].size(); j++)
+		{
+			printJSONResult(json, caseResults[i][j], &cases[i], --remaining == 0);
+		}
+	}
+	json << "  ]\n";
+	json << "}\n";
+	return 0;
+}
@@ -0,0 +1,278 @@
+/****************************************************************************
+*	 DRAMSim2: A Cycle Accurate DRAM simulator 
+*	 
+*	 Copyright (C) 2010   	Elliott Cooper-Balis
+*									Paul Rosenfeld 
+*									Bruce Jacob
+*									University of Maryland
+*
+*	 This program is free software: you can redistribute it and/or modify
+*	 it under the terms of the GNU General Public License as published by
+*	 the Free Software Foundation, either version 3 of the License, or
+*	 (at your option) any later version.
+*
+*	 This program is distributed in the hope that it will be useful,
+*	 but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	 MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	 GNU General Public License for more details.
+*
+*	 You should have received a copy of the GNU General Public License
+*	 along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*****************************************************************************/
+
+
+
+//BinaryTrace.cpp
+//
+//Class file for the binary trace reader and writer
+//
+
+#include "BinaryTrace.h"
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace DRAMSim;
+using namespace std;
+
+#define BINARY_TRACE_DATA_WORDS 4	// 32 bytes, as in parseTraceLine()
+
+bool BinaryTraceReader::isBinaryTrace(const string &filename)
+{
+	char magic[8];
+	FILE *f = fopen(filename.c_str(), "rb");
+	if (f == NULL)
+	{
+		return false;
+	}
+	bool isBinary = fread(magic, 1, sizeof(magic), f) == sizeof(magic) &&
+	                memcmp(magic, BINARY_TRACE_MAGIC, sizeof(magic)) == 0;
+	fclose(f);
+	return isBinary;
+}
+
+BinaryTraceReader::BinaryTraceReader(const string &filename, bool withData) :
+		base(NULL),
+		mappedLength(0),
+		header(NULL),
+		entries(NULL),
+		dataStream(NULL),
+		nextEntry(0),
+		cycle(0),
+		lineNumber(0),
+		withData(withData)
+{
+	int fd = ::open(filename.c_str(), O_RDONLY);
+	if (fd < 0)
+	{
+		ERROR("== Error - Could not open trace file '"<<filename<<"'");
+		exit(0);
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0)
+	{
+		ERROR("== Error - Could not stat trace file '"<<filename<<"'");
+		exit(0);
+	}
+
+	mappedLength = st.st_size;
+	if (mappedLength < sizeof(BinaryTraceHeader))
+	{
+		ERROR("== Error - Binary trace file '"<<filename<<"' is truncated");
+		exit(0);
+	}
+
+	void *m = mmap(NULL, mappedLength, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (m == MAP_FAILED)
+	{
+		ERROR("== Error - Could not map trace file '"<<filename<<"'");
+		exit(0);
+	}
+	madvise(m, mappedLength, MADV_SEQUENTIAL);
+	::close(fd);
+
+	base = (const char *)m;
+	header = (const BinaryTraceHeader *)base;
+	entries = (const BinaryTraceEntry *)(base + sizeof(BinaryTraceHeader));
+
+	if (memcmp(header->magic, BINARY_TRACE_MAGIC, sizeof(header->magic)) != 0)
+	{
+		ERROR("== Error - '"<<filename<<"' is not a binary trace");
+		exit(0);
+	}
+	if (header->version != BINARY_TRACE_VERSION)
+	{
+		ERROR("== Error - Binary trace '"<<filename<<"' has version "<<header->version<<", expected "<<BINARY_TRACE_VERSION);
+		exit(0);
+	}
+	if (header->sourceFormat > misc)
+	{
+		ERROR("== Error - Binary trace '"<<filename<<"' has an unknown source format "<<header->sourceFormat);
+		exit(0);
+	}
+
+	uint64_t entriesEnd = sizeof(BinaryTraceHeader) + header->recordCount * sizeof(BinaryTraceEntry);
+	if (entriesEnd > mappedLength ||
+	    (header->dataOffset != 0 && (header->dataOffset < entriesEnd || header->dataOffset > mappedLength)))
+	{
+		ERROR("== Error - Binary trace file '"<<filename<<"' is truncated");
+		exit(0);
+	}
+	if (header->dataOffset != 0)
+	{
+		dataStream = (const uint64_t *)(base + header->dataOffset);
+	}
+}
+
+BinaryTraceReader::~BinaryTraceReader()
+{
+	munmap((void *)base, mappedLength);
+}
+
+bool BinaryTraceReader::next(TraceRecord &record)
+{
+	while (nextEntry < header->recordCount)
+	{
+		const BinaryTraceEntry &entry = entries[nextEntry++];
+		lineNumber += entry.linesSkipped;
+
+		if (entry.type == BINARY_TRACE_CYCLE_SKIP)
+		{
+			cycle += entry.address;
+			continue;
+		}
+
+		cycle += entry.cycleDelta;
+		record.cycle = cycle;
+		record.address = entry.address;
+		record.lineNumber = lineNumber++;
+		record.type = entry.type == BINARY_TRACE_WRITE ? DATA_WRITE : DATA_READ;
+		record.data = NULL;
+		record.sourceID = 0;
+
+		if (entry.flags & BINARY_TRACE_HAS_DATA)
+		{
+			if (dataStream == NULL ||
+			    (const char *)(dataStream + BINARY_TRACE_DATA_WORDS) > base + mappedLength)
+			{
+				ERROR("== Error - Binary trace data stream is truncated at record "<<nextEntry-1);
+				exit(0);
+			}
+			if (withData)
+			{
+				uint64_t *dataBuffer = (uint64_t *)calloc(sizeof(uint64_t), BINARY_TRACE_DATA_WORDS);
+				memcpy(dataBuffer, dataStream, BINARY_TRACE_DATA_WORDS * sizeof(uint64_t));
+				record.data = dataBuffer;
+			}
+			dataStream += BINARY_TRACE_DATA_WORDS;
+		}
+		return true;
+	}
+	return false;
+}
+
+BinaryTraceWriter::BinaryTraceWriter(const string &filename, TraceType sourceFormat) :
+		out(NULL),
+		dataOut(NULL),
+		lastCycle(0),
+		lastLineNumber(0),
+		first(true)
+{
+	out = fopen(filename.c_str(), "wb");
+	if (out == NULL)
+	{
+		ERROR("== Error - Could not open output file '"<<filename<<"'");
+		exit(0);
+	}
+	dataOut = tmpfile();
+	if (dataOut == NULL)
+	{
+		ERROR("== Error - Could not create a temporary file for the data stream");
+		exit(0);
+	}
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, BINARY_TRACE_MAGIC, sizeof(header.magic));
+	header.version = BINARY_TRACE_VERSION;
+	header.sourceFormat = sourceFormat;
+
+	//placeholder, rewritten by close() once the counts are known
+	fwrite(&header, sizeof(header), 1, out);
+}
+
+BinaryTraceWriter::~BinaryTraceWriter()
+{
+	close();
+}
+
+void BinaryTraceWriter::write(const TraceRecord &record)
+{
+	BinaryTraceEntry entry;
+	memset(&entry, 0, sizeof(entry));
+
+	//blank lines in the source only show up as gaps in the line numbers
+	uint64_t linesSkipped = first ? record.lineNumber : record.lineNumber - lastLineNumber - 1;
+	uint64_t delta = record.cycle - lastCycle;
+	while (linesSkipped > 0xFFFF || delta > 0xFFFFFFFFULL)
+	{
+		entry.type = BINARY_TRACE_CYCLE_SKIP;
+		entry.linesSkipped = linesSkipped > 0xFFFF ? 0xFFFF : linesSkipped;
+		entry.address = delta > 0xFFFFFFFFULL ? delta : 0;
+		linesSkipped -= entry.linesSkipped;
+		delta -= entry.address;
+		fwrite(&entry, sizeof(entry), 1, out);
+		header.recordCount++;
+	}
+
+	entry.address = record.address;
+	entry.cycleDelta = delta;
+	entry.type = record.type == DATA_WRITE ? BINARY_TRACE_WRITE : BINARY_TRACE_READ;
+	entry.flags = 0;
+	entry.linesSkipped = linesSkipped;
+	if (record.data != NULL)
+	{
+		entry.flags |= BINARY_TRACE_HAS_DATA;
+		fwrite(record.data, sizeof(uint64_t), BINARY_TRACE_DATA_WORDS, dataOut);
+	}
+	fwrite(&entry, sizeof(entry), 1, out);
+	header.recordCount++;
+
+	lastCycle = record.cycle;
+	lastLineNumber = record.lineNumber;
+	first = false;
+}
+
+void BinaryTraceWriter::close()
+{
+	if (out == NULL)
+	{
+		return;
+	}
+
+	if (ftell(dataOut) > 0)
+	{
+		header.dataOffset = ftell(out);
+		rewind(dataOut);
+		char buffer[65536];
+		size_t n;
+		while ((n = fread(buffer, 1, sizeof(buffer), dataOut)) > 0)
+		{
+			fwrite(buffer, 1, n, out);
+		}
+	}
+	fclose(dataOut);
+	dataOut = NULL;
+
+	fseek(out, 0, SEEK_SET);
+	fwrite(&header, sizeof(header), 1, out);
+	if (fclose(out) != 0)
+	{
+		ERROR("== Error - Could not write binary trace");
+		exit(0);
+	}
+	out = NULL;
+}
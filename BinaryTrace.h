@@ -0,0 +1,118 @@
+/****************************************************************************
+*	 DRAMSim2: A Cycle Accurate DRAM simulator 
+*	 
+*	 Copyright (C) 2010   	Elliott Cooper-Balis
+*									Paul Rosenfeld 
+*									Bruce Jacob
+*									University of Maryland
+*
+*	 This program is free software: you can redistribute it and/or modify
+*	 it under the terms of the GNU General Public License as published by
+*	 the Free Software Foundation, either version 3 of the License, or
+*	 (at your option) any later version.
+*
+*	 This program is distributed in the hope that it will be useful,
+*	 but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	 MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	 GNU General Public License for more details.
+*
+*	 You should have received a copy of the GNU General Public License
+*	 along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*****************************************************************************/
+#ifndef BINARYTRACE_H
+#define BINARYTRACE_H
+
+//BinaryTrace.h
+//
+//Compact binary trace format. A file is a BinaryTraceHeader followed by
+//recordCount 16-byte BinaryTraceEntry records and, optionally, a data
+//side-stream holding 32 bytes of write data for every entry flagged
+//BINARY_TRACE_HAS_DATA, in record order. Cycles are stored as the delta
+//to the previous record. Fields are stored in host byte order.
+//
+//Use dramsim-traceconv to convert k6, mase and misc text traces;
+//TraceReader::open() recognizes the format by its magic number.
+//
+
+#include "TraceReader.h"
+#include <cstdio>
+
+#define BINARY_TRACE_MAGIC "DSIMBTR1"
+#define BINARY_TRACE_VERSION 1
+
+// BinaryTraceEntry::type
+#define BINARY_TRACE_READ 0
+#define BINARY_TRACE_WRITE 1
+#define BINARY_TRACE_CYCLE_SKIP 2	// no request; address holds a cycle delta (mod 2^64) that does not fit in 32 bits
+
+// BinaryTraceEntry::flags
+#define BINARY_TRACE_HAS_DATA 0x1
+
+namespace DRAMSim
+{
+
+struct BinaryTraceHeader
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t sourceFormat;	// TraceType of the text trace this was converted from
+	uint64_t recordCount;
+	uint64_t dataOffset;	// file offset of the data side-stream, 0 if there is none
+};
+
+struct BinaryTraceEntry
+{
+	uint64_t address;
+	uint32_t cycleDelta;
+	uint8_t type;
+	uint8_t flags;
+	uint16_t linesSkipped;	// blank lines before this one in the source, so line numbers survive
+};
+
+class BinaryTraceReader : public TraceReader
+{
+public:
+	BinaryTraceReader(const string &filename, bool withData);
+	virtual ~BinaryTraceReader();
+	virtual bool next(TraceRecord &record);
+	virtual TraceType sourceFormat() const { return (TraceType)header->sourceFormat; }
+
+	static bool isBinaryTrace(const string &filename);
+
+private:
+	const char *base;
+	size_t mappedLength;
+	const BinaryTraceHeader *header;
+	const BinaryTraceEntry *entries;
+	const uint64_t *dataStream;
+	uint64_t nextEntry;
+	uint64_t cycle;
+	uint64_t lineNumber;
+	bool withData;
+};
+
+class BinaryTraceWriter
+{
+public:
+	BinaryTraceWriter(const string &filename, TraceType sourceFormat);
+	virtual ~BinaryTraceWriter();
+
+	void write(const TraceRecord &record);
+	//writes the data side-stream and the final header
+	void close();
+
+	uint64_t records() const { return header.recordCount; }
+
+private:
+	FILE *out;
+	FILE *dataOut;	// side-stream is collected here and appended on close()
+	BinaryTraceHeader header;
+	uint64_t lastCycle;
+	uint64_t lastLineNumber;
+	bool first;
+};
+
+}
+
+#endif
@@ -37,12 +37,7 @@ using namespace DRAMSim;
 using namespace std;
 
 
-#if (USE_SCIC_MEMSYS_QUERY == 1)
-BusPacket::BusPacket(BusPacketType packtype, uint64_t physicalAddr, uint col, uint rw, uint r, uint b, void *dat, uint64_t txID, uint64_t timeTracker) :
-_timeTracker(timeTracker)
-#else
-BusPacket::BusPacket(BusPacketType packtype, uint64_t physicalAddr, uint col, uint rw, uint r, uint b, uint64_t txID, void *dat)
-#endif
+BusPacket::BusPacket(BusPacketType packtype, uint64_t physicalAddr, uint col, uint rw, uint r, uint b, void *dat, uint64_t txID)
 {
 	physicalAddress = physicalAddr;
 	busPacketType = packtype;
@@ -52,6 +47,9 @@ BusPacket::BusPacket(BusPacketType packtype, uint64_t physicalAddr, uint col, ui
 	column = col;
 	row = rw;
 	transID = txID;
+	timeIssued = 0;
+	timeAdded = 0;
+	sourceID = 0;
 }
 
 BusPacket::BusPacket() {}
@@ -102,54 +100,49 @@ void BusPacket::print()
 	{
 		return;
 	}
+	else if (busPacketType > DATA)
+	{
+		ERROR("Trying to print unknown kind of bus packet");
+		exit(-1);
+	}
+	else if (busPacketType == DATA && data != NULL)
+	{
+		//the data may be gone by the time a deferred line is formatted
+		PRINT(*this);
+	}
 	else
 	{
-		switch (busPacketType)
-		{
-		case READ:
-			PRINT("BP [READ] pa[0x"<<hex<<physicalAddress<<dec<<"] r["<<rank<<"] b["<<bank<<"] row["<<row<<"] col["<<column<<"]");
-			break;
-		case READ_P:
-			PRINT("BP [READ_P] pa[0x"<<hex<<physicalAddress<<dec<<"] r["<<rank<<"] b["<<bank<<"] row["<<row<<"] col["<<column<<"]");
-			break;
-		case WRITE:
-			PRINT("BP [WRITE] pa[0x"<<hex<<physicalAddress<<dec<<"] r["<<rank<<"] b["<<bank<<"] row["<<row<<"] col["<<column<<"]");
-			break;
-		case WRITE_P:
-			PRINT("BP [WRITE_P] pa[0x"<<hex<<physicalAddress<<dec<<"] r["<<rank<<"] b["<<bank<<"] row["<<row<<"] col["<<column<<"]");
-			break;
-		case ACTIVATE:
-			PRINT("BP [ACT] pa[0x"<<hex<<physicalAddress<<dec<<"] r["<<rank<<"] b["<<bank<<"] row["<<row<<"] col["<<column<<"]");
-			break;
-		case PRECHARGE:
-			PRINT("BP [PRE] pa[0x"<<hex<<physicalAddress<<dec<<"] r["<<rank<<"] b["<<bank<<"] row["<<row<<"] col["<<column<<"]");
-			break;
-		case REFRESH:
-			PRINT("BP [REF] pa[0x"<<hex<<physicalAddress<<dec<<"] r["<<rank<<"] b["<<bank<<"] row["<<row<<"] col["<<column<<"]");
-			break;
-		case DATA:
-			PRINTN("BP [DATA] pa[0x"<<hex<<physicalAddress<<dec<<"] r["<<rank<<"] b["<<bank<<"] row["<<row<<"] col["<<column<<"] data["<<data<<"]=");
-			BusPacket::printData(data);
-			PRINT("");
-			break;
-		default:
-			ERROR("Trying to print unknown kind of bus packet");
-			exit(-1);
-		}
+		PRINT_DEFERRED(packet(*this), *this);
 	}
 }
 
 void BusPacket::printData(const void *data)
 {
-	if (data == NULL)
+	PRINTN(DataWords(data));
+}
+
+std::ostream &DRAMSim::operator<<(std::ostream &out, const BusPacket::DataWords &words)
+{
+	if (words.data == NULL)
 	{
-		PRINTN("NO DATA");
-		return;
+		return out << "NO DATA";
 	}
-	PRINTN("'" << hex);
+	out << "'" << hex;
 	for (int i=0; i < 4; i++)
 	{
-		PRINTN(((uint64_t *)data)[i]);
+		out << ((const uint64_t *)words.data)[i];
+	}
+	return out << "'" << dec;
+}
+
+std::ostream &DRAMSim::operator<<(std::ostream &out, const BusPacket &packet)
+{
+	static const char *names[] = {"READ", "READ_P", "WRITE", "WRITE_P", "ACT", "PRE", "REF", "DATA"};
+	out << "BP [" << names[packet.busPacketType] << "] pa[0x"<<hex<<packet.physicalAddress<<dec<<"] r["<<packet.rank<<"] b["<<packet.bank
+	    <<"] row["<<packet.row<<"] col["<<packet.column<<"]";
+	if (packet.busPacketType == DATA)
+	{
+		out << " data["<<packet.data<<"]=" << BusPacket::DataWords(packet.data);
 	}
-	PRINTN("'" << dec);
+	return out;
 }
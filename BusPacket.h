@@ -34,6 +34,7 @@
 //
 
 #include "SystemConfiguration.h"
+#include "LatencyBreakdown.h"
 
 namespace DRAMSim
 {
@@ -50,13 +51,6 @@ enum BusPacketType
 };
 
 
-#if (USE_SCIC_MEMSYS_QUERY == 1)
-#ifndef NULL_SIG64
-#define NULL_SIG64			((1 << 64) - 1)
-#endif
-#endif
-
-
 class BusPacket
 {
 public:
@@ -69,20 +63,29 @@ public:
 	uint64_t physicalAddress;
 	void *data;
 	uint64_t transID;
+	uint64_t timeIssued; // issue cycle of the originating transaction
+	uint64_t timeAdded; // cycle the originating transaction entered the transaction queue
+	unsigned sourceID; // source of the originating transaction
+	LatencyStamps stamps; // progress of the originating transaction, on its column command and data
 
-#if (USE_SCIC_MEMSYS_QUERY == 1)
-	uint64_t _timeTracker;
-	BusPacket(BusPacketType packtype, uint64_t physicalAddr, uint col, uint rw, uint r, uint b, void *dat, uint64_t txID, uint64_t timeTracker = NULL_SIG64);
-#else
 	//Functions
 	BusPacket(BusPacketType packtype, uint64_t physicalAddr, uint col, uint rw, uint r, uint b, void *dat, uint64_t txID);
-#endif
 	BusPacket();
 
 	void print();
 	void print(uint64_t currentClockCycle, bool dataStart);
 	static void printData(const void *data);
+
+	//streams the 32 bytes of write data behind a pointer
+	struct DataWords
+	{
+		DataWords(const void *data) : data(data) {}
+		const void *data;
+	};
 };
+
+std::ostream &operator<<(std::ostream &out, const BusPacket &packet);
+std::ostream &operator<<(std::ostream &out, const BusPacket::DataWords &words);
 }
 
 #endif
@@ -0,0 +1,212 @@
+/****************************************************************************
+*	 DRAMSim2: A Cycle Accurate DRAM simulator 
+*	 
+*	 Copyright (C) 2010   	Elliott Cooper-Balis
+*									Paul Rosenfeld 
+*									Bruce Jacob
+*									University of Maryland
+*
+*	 This program is free software: you can redistribute it and/or modify
+*	 it under the terms of the GNU General Public License as published by
+*	 the Free Software Foundation, either version 3 of the License, or
+*	 (at your option) any later version.
+*
+*	 This program is distributed in the hope that it will be useful,
+*	 but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	 MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	 GNU General Public License for more details.
+*
+*	 You should have received a copy of the GNU General Public License
+*	 along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*****************************************************************************/
+
+
+
+//ClosedLoopReplay.cpp
+//
+//Class file for the closed-loop trace replay
+//
+
+#include "ClosedLoopReplay.h"
+
+using namespace DRAMSim;
+using namespace std;
+
+#define CLOSED_LOOP_SEQUENCE_MASK ((1ULL << CLOSED_LOOP_SOURCE_SHIFT) - 1)
+
+ClosedLoopReplay::ClosedLoopReplay(MemorySystem *ms, unsigned window, bool thinkTime) :
+		memorySystem(ms),
+		window(window),
+		thinkTime(thinkTime)
+{
+	if (window == 0)
+	{
+		ERROR("== Closed-loop replay needs a window of at least one read");
+		exit(-1);
+	}
+	readCB = new Callback_4Param<ClosedLoopReplay, void, uint, uint64_t, uint64_t, uint64_t>(this, &ClosedLoopReplay::readComplete);
+	writeCB = new Callback_4Param<ClosedLoopReplay, void, uint, uint64_t, uint64_t, uint64_t>(this, &ClosedLoopReplay::writeComplete);
+	memorySystem->RegisterCallbacks(readCB, writeCB, NULL);
+}
+
+ClosedLoopReplay::~ClosedLoopReplay()
+{
+	memorySystem->RegisterCallbacks(NULL, NULL, NULL);
+	delete readCB;
+	delete writeCB;
+	for (size_t i=0; i<sources.size(); i++)
+	{
+		if (sources[i].pending)
+		{
+			free(sources[i].record.data);
+		}
+		delete sources[i].reader;
+	}
+}
+
+unsigned ClosedLoopReplay::addSource(TraceReader *reader)
+{
+	Source source = Source();
+	source.reader = reader;
+	sources.push_back(source);
+	readIssueCycles.push_back(map<uint64_t, uint64_t>());
+	return sources.size() - 1;
+}
+
+bool ClosedLoopReplay::issue(Source &source, unsigned sourceID)
+{
+	uint64_t cycle = memorySystem->currentClockCycle;
+
+	if (!source.pending)
+	{
+		if (source.traceDone)
+		{
+			return false;
+		}
+		if (!source.reader->next(source.record))
+		{
+			source.traceDone = true;
+			return false;
+		}
+		source.pending = true;
+		source.transaction = Transaction(source.record.type, source.record.address, source.record.data,
+		                                 ((uint64_t)sourceID << CLOSED_LOOP_SOURCE_SHIFT) | source.nextSequence);
+		source.transaction.sourceID = sourceID;
+
+		//the gap to the previous record is time the core spends computing
+		//after issuing it; records that go back in time issue right away
+		source.readyCycle = 0;
+		if (thinkTime && source.nextSequence > 0 && source.record.cycle > source.lastTraceCycle)
+		{
+			source.readyCycle = source.lastIssueCycle + (source.record.cycle - source.lastTraceCycle);
+		}
+		source.lastTraceCycle = source.record.cycle;
+	}
+
+	if (cycle < source.readyCycle)
+	{
+		source.thinkCycles++;
+		return false;
+	}
+
+	bool isRead = source.record.type == DATA_READ;
+	if (isRead && source.outstandingReads >= window)
+	{
+		source.windowStallCycles++;
+		return false;
+	}
+
+	if (!memorySystem->addTransaction(source.transaction))
+	{
+		source.backpressureCycles++;
+		return false;
+	}
+
+	uint64_t sequence = source.nextSequence;
+	source.pending = false;
+	source.nextSequence++;
+	source.lastIssueCycle = cycle;
+	if (isRead)
+	{
+		source.reads++;
+		source.outstandingReads++;
+		readIssueCycles[sourceID][sequence] = cycle;
+	}
+	else
+	{
+		source.writes++;
+		source.outstandingWrites++;
+	}
+	return true;
+}
+
+void ClosedLoopReplay::update()
+{
+	//rotate which source goes first so that no core is always ahead in the queue
+	size_t n = sources.size();
+	for (size_t k=0; k<n; k++)
+	{
+		size_t i = (memorySystem->currentClockCycle + k) % n;
+		issue(sources[i], i);
+	}
+}
+
+bool ClosedLoopReplay::done() const
+{
+	for (size_t i=0; i<sources.size(); i++)
+	{
+		const Source &source = sources[i];
+		if (!source.traceDone || source.pending || source.outstandingReads > 0 || source.outstandingWrites > 0)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void ClosedLoopReplay::readComplete(uint id, uint64_t address, uint64_t doneCycle, uint64_t txID)
+{
+	unsigned sourceID = txID >> CLOSED_LOOP_SOURCE_SHIFT;
+	if (sourceID >= sources.size())
+	{
+		ERROR("== Read completion for unknown source "<<sourceID);
+		exit(-1);
+	}
+	Source &source = sources[sourceID];
+	map<uint64_t, uint64_t>::iterator it = readIssueCycles[sourceID].find(txID & CLOSED_LOOP_SEQUENCE_MASK);
+	if (it == readIssueCycles[sourceID].end())
+	{
+		ERROR("== Read completion for a read that is not outstanding (id "<<txID<<")");
+		exit(-1);
+	}
+	source.totalReadLatency += doneCycle - it->second;
+	readIssueCycles[sourceID].erase(it);
+	source.outstandingReads--;
+	source.readsCompleted++;
+}
+
+void ClosedLoopReplay::writeComplete(uint id, uint64_t address, uint64_t doneCycle, uint64_t txID)
+{
+	unsigned sourceID = txID >> CLOSED_LOOP_SOURCE_SHIFT;
+	if (sourceID >= sources.size())
+	{
+		ERROR("== Write completion for unknown source "<<sourceID);
+		exit(-1);
+	}
+	sources[sourceID].outstandingWrites--;
+}
+
+void ClosedLoopReplay::printStats()
+{
+	PRINT(" == Closed-loop replay (window "<<window<<" reads"<<(thinkTime ? ", think time from trace" : "")<<") ==");
+	for (size_t i=0; i<sources.size(); i++)
+	{
+		Source &source = sources[i];
+		PRINT("   Source "<<i<<" : "<<source.reads<<" reads, "<<source.writes<<" writes issued"<<(source.traceDone && !source.pending ? " (trace done)" : ""));
+		PRINT("      Average read latency     : "<<(source.readsCompleted ? (double)source.totalReadLatency/source.readsCompleted : 0)<<" cycles over "<<source.readsCompleted<<" reads");
+		PRINT("      Cycles stalled on window : "<<source.windowStallCycles);
+		PRINT("      Cycles thinking          : "<<source.thinkCycles);
+		PRINT("      Cycles refused by queue  : "<<source.backpressureCycles);
+	}
+}
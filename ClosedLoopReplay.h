@@ -0,0 +1,103 @@
+/****************************************************************************
+*	 DRAMSim2: A Cycle Accurate DRAM simulator 
+*	 
+*	 Copyright (C) 2010   	Elliott Cooper-Balis
+*									Paul Rosenfeld 
+*									Bruce Jacob
+*									University of Maryland
+*
+*	 This program is free software: you can redistribute it and/or modify
+*	 it under the terms of the GNU General Public License as published by
+*	 the Free Software Foundation, either version 3 of the License, or
+*	 (at your option) any later version.
+*
+*	 This program is distributed in the hope that it will be useful,
+*	 but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	 MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	 GNU General Public License for more details.
+*
+*	 You should have received a copy of the GNU General Public License
+*	 along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*****************************************************************************/
+#ifndef CLOSEDLOOPREPLAY_H
+#define CLOSEDLOOPREPLAY_H
+
+//ClosedLoopReplay.h
+//
+//Replays traces the way a core would issue them: each source (one trace)
+//may have at most a window of reads outstanding and stalls in order once
+//the window is full, until the ReturnReadData callback frees a slot.
+//Writes are posted and don't count against the window. With think time
+//enabled, the cycle gap between two consecutive trace records is kept as
+//the gap between issuing them, instead of being used as absolute time.
+//
+//The source of a transaction is kept in the top bits of its id.
+//
+
+#include "MemorySystem.h"
+#include "TraceReader.h"
+#include <map>
+
+#define CLOSED_LOOP_SOURCE_SHIFT 48
+
+namespace DRAMSim
+{
+class ClosedLoopReplay
+{
+public:
+	//registers the replay's read and write callbacks with ms
+	ClosedLoopReplay(MemorySystem *ms, unsigned window, bool thinkTime);
+	virtual ~ClosedLoopReplay();
+
+	//takes ownership of reader; returns the source id
+	unsigned addSource(TraceReader *reader);
+
+	//issues whatever the windows allow; call once per cycle, before MemorySystem::update()
+	void update();
+	//true once every trace is exhausted and nothing is outstanding
+	bool done() const;
+	void printStats();
+
+	void readComplete(uint id, uint64_t address, uint64_t doneCycle, uint64_t txID);
+	void writeComplete(uint id, uint64_t address, uint64_t doneCycle, uint64_t txID);
+
+private:
+	struct Source
+	{
+		TraceReader *reader;
+		TraceRecord record;		// next request, valid while pending
+		Transaction transaction;	// the same, offered again as is until accepted
+		bool pending;
+		bool traceDone;
+		uint64_t lastTraceCycle;
+		uint64_t lastIssueCycle;
+		uint64_t readyCycle;	// earliest issue cycle of the pending request (think time)
+		uint64_t nextSequence;
+		unsigned outstandingReads;
+		unsigned outstandingWrites;
+
+		uint64_t reads;
+		uint64_t writes;
+		uint64_t readsCompleted;
+		uint64_t totalReadLatency;
+		uint64_t windowStallCycles;
+		uint64_t thinkCycles;
+		uint64_t backpressureCycles;
+	};
+
+	//returns true if the source could issue and the controller took it
+	bool issue(Source &source, unsigned sourceID);
+
+	MemorySystem *memorySystem;
+	unsigned window;
+	bool thinkTime;
+	vector<Source> sources;
+	//issue cycle of every outstanding read, per source, by sequence number
+	vector< map<uint64_t, uint64_t> > readIssueCycles;
+	Callback_t *readCB;
+	Callback_t *writeCB;
+};
+}
+
+#endif
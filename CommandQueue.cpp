@@ -38,6 +38,7 @@ using namespace DRAMSim;
 
 CommandQueue::CommandQueue(vector< vector<BankState> > &states) :
 		bankStates(states),
+		prechargeForConflict(false),
 		nextBank(0),
 		nextRank(0),
 		nextBankPRE(0),
@@ -96,6 +97,14 @@ CommandQueue::CommandQueue(vector< vector<BankState> > &states) :
 		//init the empty vectors here so we don't seg fault later
 		tFAWCountdown.push_back(vector<uint>());
 	}
+
+	for (size_t i=0;i<STALL_REASONS;i++)
+	{
+		stallCycles[i] = vector<uint64_t>(NUM_RANKS*NUM_BANKS,0);
+	}
+	heads = vector<BusPacket *>(NUM_RANKS*NUM_BANKS,NULL);
+	headReasons = vector<StallReason>(NUM_RANKS*NUM_BANKS,STALL_COMMAND_BUS);
+	headsAfter = vector<BusPacket *>(NUM_RANKS*NUM_BANKS,NULL);
 }
 CommandQueue::~CommandQueue()
 {
@@ -172,6 +181,81 @@ bool CommandQueue::pop(BusPacket **busPacket)
 		}
 	}
 
+	if (!STALL_STATS_OUTPUT)
+	{
+		return issue(busPacket);
+	}
+
+	//note why the oldest command of each bank can't go before one command is
+	//	picked, then charge a cycle to every one still the oldest afterwards
+	for (size_t i=0;i<NUM_RANKS;i++)
+	{
+		findBankHeads(i, &heads[i*NUM_BANKS]);
+		for (size_t j=0;j<NUM_BANKS;j++)
+		{
+			if (heads[i*NUM_BANKS+j] != NULL)
+			{
+				headReasons[i*NUM_BANKS+j] = stallReason(heads[i*NUM_BANKS+j]);
+			}
+		}
+	}
+
+	bool issued = issue(busPacket);
+
+	//only the rank a command went to can have lost queued commands
+	for (size_t i=0;i<NUM_RANKS;i++)
+	{
+		bool changed = issued && (*busPacket)->rank == i;
+		if (changed)
+		{
+			findBankHeads(i, &headsAfter[i*NUM_BANKS]);
+		}
+		for (size_t j=0;j<NUM_BANKS;j++)
+		{
+			if (heads[i*NUM_BANKS+j] != NULL && (!changed || headsAfter[i*NUM_BANKS+j] == heads[i*NUM_BANKS+j]))
+			{
+				stallCycles[headReasons[i*NUM_BANKS+j]][i*NUM_BANKS+j]++;
+			}
+		}
+	}
+	return issued;
+}
+
+//the oldest queued command of every bank of a rank; a per rank queue holds
+//	the commands of all its banks in order, so it is searched for them
+void CommandQueue::findBankHeads(size_t rank, BusPacket **bankHeads)
+{
+	for (size_t b=0;b<NUM_BANKS;b++)
+	{
+		bankHeads[b] = NULL;
+	}
+	if (queuingStructure==PerRankPerBank)
+	{
+		for (size_t b=0;b<NUM_BANKS;b++)
+		{
+			if (!queues[rank][b].empty())
+			{
+				bankHeads[b] = queues[rank][b][0];
+			}
+		}
+		return;
+	}
+
+	BusPacket1D &queue = queues[rank][0];
+	size_t found = 0;
+	for (size_t i=0;i<queue.size() && found<NUM_BANKS;i++)
+	{
+		if (bankHeads[queue[i]->bank] == NULL)
+		{
+			bankHeads[queue[i]->bank] = queue[i];
+			found++;
+		}
+	}
+}
+
+//picks the next command to send, if any
+bool CommandQueue::issue(BusPacket **busPacket)
+{
 	//
 	//Dequeue the correct item based on the structure and whether
 	//	or not we are using open or closed page
@@ -333,6 +417,7 @@ bool CommandQueue::pop(BusPacket **busPacket)
 						{
 							rowAccessCounters[refreshRank][b]=0;
 							*busPacket = new BusPacket(PRECHARGE, 0, 0, 0, refreshRank, b, 0, 0);
+							prechargeForConflict = false;
 							sendingREForPRE = true;
 						}
 						break;
@@ -457,6 +542,7 @@ bool CommandQueue::pop(BusPacket **busPacket)
 									sendingPRE = true;
 									rowAccessCounters[nextRankPRE][nextBankPRE]=0;
 									*busPacket = new BusPacket(PRECHARGE, 0, 0, 0, nextRankPRE, nextBankPRE, 0, 0);
+									prechargeForConflict = otherRowPending(nextRankPRE, nextBankPRE);
 									break;
 								}
 							}
@@ -602,6 +688,7 @@ bool CommandQueue::pop(BusPacket **busPacket)
 							rowAccessCounters[refreshRank][i]=0;
 
 							*busPacket = new BusPacket(PRECHARGE, 0, 0, 0, refreshRank, i, 0, 0);
+							prechargeForConflict = false;
 							sendingREForPRE = true;
 						}
 						break;
@@ -721,6 +808,7 @@ bool CommandQueue::pop(BusPacket **busPacket)
 
 									sendingPRE = true;
 									*busPacket = new BusPacket(PRECHARGE, 0, 0, 0, nextRankPRE, nextBankPRE, 0, 0);
+									prechargeForConflict = otherRowPending(nextRankPRE, nextBankPRE);
 									break;
 								}
 							}
@@ -925,6 +1013,94 @@ bool CommandQueue::isIssuable(BusPacket *busPacket)
 	return false;
 }
 
+//why busPacket isn't issuable this cycle, mirrors isIssuable()
+//	STALL_COMMAND_BUS if it is and only lost out to another command
+StallReason CommandQueue::stallReason(BusPacket *busPacket)
+{
+	BankState &bankState = bankStates[busPacket->rank][busPacket->bank];
+	if (refreshWaiting && busPacket->rank == refreshRank)
+	{
+		return STALL_REFRESH;
+	}
+
+	switch (bankState.currentBankState)
+	{
+	case PowerDown:
+		return STALL_POWER_DOWN;
+	case Precharging:
+		return STALL_TRP;
+	case Refreshing:
+		if (busPacket->busPacketType != ACTIVATE)
+		{
+			return STALL_REFRESH;
+		}
+		break;
+	case Idle:
+		if (busPacket->busPacketType != ACTIVATE)
+		{
+			return STALL_ROW_CONFLICT;
+		}
+		break;
+	case RowActive:
+		if (busPacket->busPacketType == ACTIVATE || busPacket->row != bankState.openRowAddress)
+		{
+			return currentClockCycle < bankState.nextPrecharge ? bankState.nextPrechargeReason : STALL_ROW_CONFLICT;
+		}
+		break;
+	}
+
+	switch (busPacket->busPacketType)
+	{
+	case ACTIVATE:
+		if (currentClockCycle < bankState.nextActivate)
+		{
+			return bankState.nextActivateReason;
+		}
+		if (tFAWCountdown[busPacket->rank].size() >= 4)
+		{
+			return STALL_TFAW;
+		}
+		break;
+	case WRITE:
+	case WRITE_P:
+	case READ_P:
+	case READ:
+		if (rowAccessCounters[busPacket->rank][busPacket->bank] >= TOTAL_ROW_ACCESSES)
+		{
+			return STALL_ROW_ACCESS_CAP;
+		}
+		if (busPacket->busPacketType == WRITE || busPacket->busPacketType == WRITE_P)
+		{
+			if (currentClockCycle < bankState.nextWrite)
+			{
+				return bankState.nextWriteReason;
+			}
+		}
+		else if (currentClockCycle < bankState.nextRead)
+		{
+			return bankState.nextReadReason;
+		}
+		break;
+	default:
+		break;
+	}
+	return STALL_COMMAND_BUS;
+}
+
+//whether a queued command goes to another row than the one open in a bank
+bool CommandQueue::otherRowPending(uint rank, uint bank)
+{
+	BusPacket1D &queue = queuingStructure==PerRankPerBank ? queues[rank][bank] : queues[rank][0];
+	for (size_t i=0;i<queue.size();i++)
+	{
+		if (queue[i]->bank == bank && queue[i]->row != bankStates[rank][bank].openRowAddress)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
 //figures out if a rank's queue is empty
 bool CommandQueue::isEmpty(uint rank)
 {
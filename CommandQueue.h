@@ -59,6 +59,7 @@ public:
 	bool pop(BusPacket **busPacket);
 	bool hasRoomFor(uint numberToEnqueue, uint rank, uint bank);
 	bool isIssuable(BusPacket *busPacket);
+	StallReason stallReason(BusPacket *busPacket);
 	bool isEmpty(uint rank);
 	void needRefresh(uint rank);
 	void print();
@@ -68,8 +69,18 @@ public:
 	
 	BusPacket3D queues; // 3D array of BusPacket pointers
 	vector< vector<BankState> > &bankStates;
+
+	//cycles the oldest command of a bank waited, per reason and bank, only kept with
+	//	STALL_STATS_OUTPUT; reset by the controller every epoch
+	vector<uint64_t> stallCycles[STALL_REASONS];
+	//whether the last PRE pop() returned closed a row for a queued access to
+	//	another row of the bank, rather than for a refresh or an idle bank
+	bool prechargeForConflict;
 private:
+	bool issue(BusPacket **busPacket);
 	void nextRankAndBank(unsigned &rank, unsigned &bank);
+	void findBankHeads(size_t rank, BusPacket **bankHeads);
+	bool otherRowPending(uint rank, uint bank);
 	//fields
 	uint nextBank;
 	uint nextRank;
@@ -83,6 +94,12 @@ private:
 	vector< vector<uint> > tFAWCountdown;
 	vector< vector<uint> > rowAccessCounters;
 
+	//oldest command of each bank at the start of pop() and why it could not
+	//	go, and the same after a command was picked; NULL if a bank has none
+	vector<BusPacket *> heads;
+	vector<StallReason> headReasons;
+	vector<BusPacket *> headsAfter;
+
 	bool sendAct;
 };
 }
@@ -0,0 +1,341 @@
+/****************************************************************************
+*	 DRAMSim2: A Cycle Accurate DRAM simulator 
+*	 
+*	 Copyright (C) 2010   	Elliott Cooper-Balis
+*									Paul Rosenfeld 
+*									Bruce Jacob
+*									University of Maryland
+*
+*	 This program is free software: you can redistribute it and/or modify
+*	 it under the terms of the GNU General Public License as published by
+*	 the Free Software Foundation, either version 3 of the License, or
+*	 (at your option) any later version.
+*
+*	 This program is distributed in the hope that it will be useful,
+*	 but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	 MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	 GNU General Public License for more details.
+*
+*	 You should have received a copy of the GNU General Public License
+*	 along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*****************************************************************************/
+
+
+
+//CompressedTrace.cpp
+//
+//Class file for the streaming compressed trace reader
+//
+
+#include "CompressedTrace.h"
+#include "LZCodec.h"
+#include <cstring>
+#include <cstdio>
+#include <vector>
+#include <zlib.h>
+
+using namespace DRAMSim;
+using namespace std;
+
+namespace
+{
+class GzipBlockSource : public TraceBlockSource
+{
+public:
+	GzipBlockSource(const string &filename)
+	{
+		file = gzopen(filename.c_str(), "rb");
+		if (file == NULL)
+		{
+			ERROR("== Error - Could not open trace file '"<<filename<<"'");
+			exit(0);
+		}
+		gzbuffer(file, 1<<18);
+	}
+	virtual ~GzipBlockSource()
+	{
+		gzclose(file);
+	}
+	virtual size_t read(char *buffer, size_t capacity)
+	{
+		int n = gzread(file, buffer, capacity);
+		if (n < 0)
+		{
+			int err;
+			ERROR("== Error - Could not decompress trace: "<<gzerror(file, &err));
+			exit(0);
+		}
+		return n;
+	}
+private:
+	gzFile file;
+};
+
+class LZBlockSource : public TraceBlockSource
+{
+public:
+	LZBlockSource(const string &filename)
+	{
+		file = fopen(filename.c_str(), "rb");
+		if (file == NULL)
+		{
+			ERROR("== Error - Could not open trace file '"<<filename<<"'");
+			exit(0);
+		}
+		char magic[8];
+		if (fread(magic, 1, sizeof(magic), file) != sizeof(magic) || memcmp(magic, LZ_STREAM_MAGIC, sizeof(magic)) != 0)
+		{
+			ERROR("== Error - '"<<filename<<"' is not an LZ compressed trace");
+			exit(0);
+		}
+	}
+	virtual ~LZBlockSource()
+	{
+		fclose(file);
+	}
+	virtual size_t read(char *buffer, size_t capacity)
+	{
+		uint32_t sizes[2];	// uncompressed, compressed
+		size_t n = fread(sizes, sizeof(uint32_t), 2, file);
+		if (n == 0 && feof(file))
+		{
+			return 0;
+		}
+		if (n != 2 || sizes[0] > LZ_BLOCK_SIZE || sizes[0] > capacity || sizes[1] > lzCompressBound(LZ_BLOCK_SIZE))
+		{
+			ERROR("== Error - Corrupt block header in LZ compressed trace");
+			exit(0);
+		}
+		compressed.resize(sizes[1]);
+		if (fread(&compressed[0], 1, sizes[1], file) != sizes[1] ||
+		    !lzDecompress(&compressed[0], sizes[1], (uint8_t *)buffer, sizes[0]))
+		{
+			ERROR("== Error - Corrupt block in LZ compressed trace");
+			exit(0);
+		}
+		return sizes[0];
+	}
+private:
+	FILE *file;
+	vector<uint8_t> compressed;
+};
+}
+
+bool CompressedTraceReader::isCompressedTrace(const string &filename, TraceCodec &codec)
+{
+	unsigned char magic[8];
+	FILE *f = fopen(filename.c_str(), "rb");
+	if (f == NULL)
+	{
+		return false;
+	}
+	size_t n = fread(magic, 1, sizeof(magic), f);
+	fclose(f);
+
+	if (n >= 2 && magic[0] == 0x1f && magic[1] == 0x8b)
+	{
+		codec = TRACE_CODEC_GZIP;
+		return true;
+	}
+	if (n == sizeof(magic) && memcmp(magic, LZ_STREAM_MAGIC, sizeof(magic)) == 0)
+	{
+		codec = TRACE_CODEC_LZ;
+		return true;
+	}
+	return false;
+}
+
+CompressedTraceReader::CompressedTraceReader(const string &filename, TraceCodec codec, TraceType type, bool withData) :
+		traceType(type),
+		withData(withData),
+		source(NULL),
+		stopRequested(false),
+		current(0),
+		holdingBlock(false),
+		sourceDone(false),
+		cursor(NULL),
+		end(NULL),
+		lineNumber(0)
+{
+	if (codec == TRACE_CODEC_GZIP)
+	{
+		source = new GzipBlockSource(filename);
+	}
+	else
+	{
+		source = new LZBlockSource(filename);
+	}
+
+	for (int i=0;i<2;i++)
+	{
+		blocks[i].data = (char *)malloc(COMPRESSED_TRACE_BLOCK_SIZE);
+		blocks[i].length = 0;
+		blocks[i].full = false;
+	}
+
+	pthread_mutex_init(&lock, NULL);
+	pthread_cond_init(&blockFilled, NULL);
+	pthread_cond_init(&blockEmptied, NULL);
+	if (pthread_create(&thread, NULL, threadMain, this) != 0)
+	{
+		ERROR("== Error - could not start the trace reader thread");
+		exit(-1);
+	}
+}
+
+CompressedTraceReader::~CompressedTraceReader()
+{
+	pthread_mutex_lock(&lock);
+	stopRequested = true;
+	pthread_cond_signal(&blockEmptied);
+	pthread_mutex_unlock(&lock);
+	pthread_join(thread, NULL);
+
+	pthread_cond_destroy(&blockEmptied);
+	pthread_cond_destroy(&blockFilled);
+	pthread_mutex_destroy(&lock);
+	for (int i=0;i<2;i++)
+	{
+		free(blocks[i].data);
+	}
+	delete source;
+}
+
+void *CompressedTraceReader::threadMain(void *arg)
+{
+	((CompressedTraceReader *)arg)->run();
+	return NULL;
+}
+
+//decodes into the two blocks in turn; an empty block marks the end of the trace
+void CompressedTraceReader::run()
+{
+	unsigned index = 0;
+	while (true)
+	{
+		pthread_mutex_lock(&lock);
+		while (blocks[index].full && !stopRequested)
+		{
+			pthread_cond_wait(&blockEmptied, &lock);
+		}
+		bool stop = stopRequested;
+		pthread_mutex_unlock(&lock);
+		if (stop)
+		{
+			break;
+		}
+
+		size_t length = source->read(blocks[index].data, COMPRESSED_TRACE_BLOCK_SIZE);
+
+		pthread_mutex_lock(&lock);
+		blocks[index].length = length;
+		blocks[index].full = true;
+		pthread_cond_signal(&blockFilled);
+		pthread_mutex_unlock(&lock);
+
+		if (length == 0)
+		{
+			break;
+		}
+		index ^= 1;
+	}
+}
+
+//waits for the next decoded block; returns false at the end of the trace
+bool CompressedTraceReader::acquireBlock()
+{
+	pthread_mutex_lock(&lock);
+	while (!blocks[current].full)
+	{
+		pthread_cond_wait(&blockFilled, &lock);
+	}
+	pthread_mutex_unlock(&lock);
+
+	if (blocks[current].length == 0)
+	{
+		sourceDone = true;
+		return false;
+	}
+	holdingBlock = true;
+	cursor = blocks[current].data;
+	end = cursor + blocks[current].length;
+	return true;
+}
+
+//hands the block back to the reader thread
+void CompressedTraceReader::releaseBlock()
+{
+	pthread_mutex_lock(&lock);
+	blocks[current].full = false;
+	pthread_cond_signal(&blockEmptied);
+	pthread_mutex_unlock(&lock);
+	holdingBlock = false;
+	current ^= 1;
+}
+
+bool CompressedTraceReader::parseLine(const char *line, const char *lineEnd, TraceRecord &record)
+{
+	bool parsed = parseTraceLine(line, lineEnd, traceType, record, withData);
+	record.lineNumber = lineNumber++;
+	if (!parsed)
+	{
+		DEBUG("WARNING: Skipping line "<<record.lineNumber<< " in tracefile");
+	}
+	return parsed;
+}
+
+bool CompressedTraceReader::next(TraceRecord &record)
+{
+	while (!sourceDone)
+	{
+		if (cursor == end)
+		{
+			if (holdingBlock)
+			{
+				releaseBlock();
+			}
+			if (!acquireBlock())
+			{
+				//a last line without a line terminator
+				if (!carry.empty())
+				{
+					string line;
+					line.swap(carry);
+					if (parseLine(line.data(), line.data() + line.size(), record))
+					{
+						return true;
+					}
+				}
+				return false;
+			}
+			continue;
+		}
+
+		const char *lineEnd = (const char *)memchr(cursor, '\n', end - cursor);
+		if (lineEnd == NULL)
+		{
+			carry.append(cursor, end);
+			cursor = end;
+			continue;
+		}
+
+		bool parsed;
+		if (carry.empty())
+		{
+			parsed = parseLine(cursor, lineEnd, record);
+		}
+		else
+		{
+			carry.append(cursor, lineEnd);
+			parsed = parseLine(carry.data(), carry.data() + carry.size(), record);
+			carry.clear();
+		}
+		cursor = lineEnd + 1;
+		if (parsed)
+		{
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,105 @@
+/****************************************************************************
+*	 DRAMSim2: A Cycle Accurate DRAM simulator 
+*	 
+*	 Copyright (C) 2010   	Elliott Cooper-Balis
+*									Paul Rosenfeld 
+*									Bruce Jacob
+*									University of Maryland
+*
+*	 This program is free software: you can redistribute it and/or modify
+*	 it under the terms of the GNU General Public License as published by
+*	 the Free Software Foundation, either version 3 of the License, or
+*	 (at your option) any later version.
+*
+*	 This program is distributed in the hope that it will be useful,
+*	 but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	 MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	 GNU General Public License for more details.
+*
+*	 You should have received a copy of the GNU General Public License
+*	 along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*****************************************************************************/
+#ifndef COMPRESSEDTRACE_H
+#define COMPRESSEDTRACE_H
+
+//CompressedTrace.h
+//
+//Streams gzip and LZ (LZCodec.h) compressed text traces without
+//decompressing them to disk. A reader thread decodes the file into one of
+//two blocks while next() parses the lines of the other, so decompression
+//overlaps with simulation and the simulator only waits if it catches up
+//with the decoder. The trace type still comes from the filename prefix
+//(ex: k6_foo.trc.gz).
+//
+
+#include "TraceReader.h"
+#include <pthread.h>
+
+#define COMPRESSED_TRACE_BLOCK_SIZE (4<<20)
+
+namespace DRAMSim
+{
+enum TraceCodec
+{
+	TRACE_CODEC_GZIP,
+	TRACE_CODEC_LZ
+};
+
+//produces the decompressed bytes of a trace, one block at a time
+class TraceBlockSource
+{
+public:
+	virtual ~TraceBlockSource() {}
+	//fills up to capacity bytes (at least LZ_BLOCK_SIZE); returns 0 at the end
+	virtual size_t read(char *buffer, size_t capacity) = 0;
+};
+
+class CompressedTraceReader : public TraceReader
+{
+public:
+	CompressedTraceReader(const string &filename, TraceCodec codec, TraceType type, bool withData);
+	virtual ~CompressedTraceReader();
+	virtual bool next(TraceRecord &record);
+	virtual TraceType sourceFormat() const { return traceType; }
+
+	//recognizes a compressed trace by its magic number
+	static bool isCompressedTrace(const string &filename, TraceCodec &codec);
+
+private:
+	struct Block
+	{
+		char *data;
+		size_t length;
+		bool full;		// decoded and not yet consumed
+	};
+
+	static void *threadMain(void *arg);
+	void run();
+	bool acquireBlock();
+	void releaseBlock();
+	bool parseLine(const char *line, const char *lineEnd, TraceRecord &record);
+
+	TraceType traceType;
+	bool withData;
+	TraceBlockSource *source;
+
+	pthread_t thread;
+	pthread_mutex_t lock;
+	pthread_cond_t blockFilled;
+	pthread_cond_t blockEmptied;
+	bool stopRequested;
+	Block blocks[2];
+
+	//consumer side
+	unsigned current;
+	bool holdingBlock;
+	bool sourceDone;
+	const char *cursor;
+	const char *end;
+	string carry;	// start of a line that continues in the next block
+	uint64_t lineNumber;
+};
+}
+
+#endif
@@ -29,6 +29,7 @@
  * provide all necessary functionality to talk to an external simulator
  */
 #include "Callback.h"
+#include "BatchTypes.h"
 using std::string;
 
 namespace DRAMSim 
@@ -36,9 +37,17 @@ namespace DRAMSim
 	class MemorySystem
 	{
 		public:
-			bool addTransaction(bool isWrite, uint64_t addr);
+			// returns false when the transaction queue is full; the request is
+			// then NOT kept and must be offered again in a later cycle
+			bool addTransaction(bool isWrite, uint64_t addr, uint64_t txID);
 			bool WillAcceptTransaction();
+			uint AvailableSlots();
 			void update();
+			uint addTransactions(const TransactionRequest *requests, uint count);
+			void enableSubmissionRings(unsigned capacity);
+			bool submitTransaction(unsigned producerID, uint64_t timestamp, bool isWrite, uint64_t addr, uint64_t txID);
+			bool pollCompletion(CompletionRecord &completion);
+			uint advance(uint64_t nCycles, CompletionRecord *completions, uint capacity, uint64_t *cyclesElapsed = NULL);
 			void printStats();
 			void RegisterCallbacks( 
 				TransactionCompleteCB *readDone,
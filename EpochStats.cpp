@@ -0,0 +1,316 @@
+/****************************************************************************
+*	 DRAMSim2: A Cycle Accurate DRAM simulator 
+*	 
+*	 Copyright (C) 2010   	Elliott Cooper-Balis
+*									Paul Rosenfeld 
+*									Bruce Jacob
+*									University of Maryland
+*
+*	 This program is free software: you can redistribute it and/or modify
+*	 it under the terms of the GNU General Public License as published by
+*	 the Free Software Foundation, either version 3 of the License, or
+*	 (at your option) any later version.
+*
+*	 This program is distributed in the hope that it will be useful,
+*	 but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	 MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	 GNU General Public License for more details.
+*
+*	 You should have received a copy of the GNU General Public License
+*	 along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*****************************************************************************/
+
+
+
+//EpochStats.cpp
+//
+//Class file for the binary epoch statistics writer and reader
+//
+
+#include "EpochStats.h"
+#include "IniReader.h"
+#include <cstring>
+#include <sstream>
+
+using namespace DRAMSim;
+using namespace std;
+
+const char *DRAMSim::epochStatsRankColumnNames[EPOCH_STATS_RANK_COLUMNS] =
+{
+	"background_energy", "burst_energy", "actpre_energy", "refresh_energy", "refresh_cycles", "power_down_cycles"
+};
+
+const char *DRAMSim::epochStatsBankColumnNames[EPOCH_STATS_BANK_COLUMNS] =
+{
+	"reads", "writes", "read_latency",
+	"row_hits", "row_misses", "row_conflicts", "activates", "column_accesses",
+	"stall_command_bus", "stall_tRCD", "stall_tRP", "stall_tRAS", "stall_tRC", "stall_tRRD", "stall_tFAW", "stall_tCCD",
+	"stall_write_to_read", "stall_read_to_write", "stall_rank_switch", "stall_column_to_precharge", "stall_row_conflict",
+	"stall_refresh", "stall_power_down", "stall_row_access_cap"
+};
+
+namespace
+{
+const char padding[8] = {0};
+
+inline size_t padTo8(size_t length)
+{
+	return (8 - (length & 7)) & 7;
+}
+
+//bytes of a record before its histogram entries
+inline size_t fixedRecordBytes(const EpochStatsHeader &header)
+{
+	size_t banks = (size_t)header.numRanks * header.numBanks;
+	size_t lengths = 2 * banks * sizeof(uint32_t);
+	return sizeof(EpochStatsRecord) +
+	       (header.rankColumns * header.numRanks + header.bankColumns * banks) * sizeof(uint64_t) +
+	       lengths + padTo8(lengths);
+}
+}
+
+EpochStatsWriter::EpochStatsWriter(const string &filename, unsigned systemID) :
+		out(NULL),
+		recordCount(0)
+{
+	out = fopen(filename.c_str(), "wb");
+	if (out == NULL)
+	{
+		ERROR("== Error - Could not open stats file '"<<filename<<"'");
+		exit(0);
+	}
+	buffer.reserve(EPOCH_STATS_BUFFER_BYTES);
+
+	ostringstream iniValues;
+	IniReader::WriteValuesOut(iniValues);
+	string iniText = iniValues.str();
+
+	EpochStatsHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, EPOCH_STATS_MAGIC, sizeof(header.magic));
+	header.version = EPOCH_STATS_VERSION;
+	header.systemID = systemID;
+	header.numRanks = NUM_RANKS;
+	header.numBanks = NUM_BANKS;
+	header.rankColumns = EPOCH_STATS_RANK_COLUMNS;
+	header.bankColumns = EPOCH_STATS_BANK_COLUMNS;
+	header.histogramBuckets = LatencyHistogram().NumBuckets();
+	header.bytesPerTransaction = (64*BL)/8;
+	header.tCK = tCK;
+	header.Vdd = Vdd;
+	header.epochLength = EPOCH_LENGTH;
+	header.iniTextLength = iniText.size();
+
+	append(&header, sizeof(header));
+	append(iniText.data(), iniText.size());
+	append(padding, padTo8(iniText.size()));
+}
+
+EpochStatsWriter::~EpochStatsWriter()
+{
+	close();
+}
+
+void EpochStatsWriter::append(const void *data, size_t length)
+{
+	buffer.insert(buffer.end(), (const char *)data, (const char *)data + length);
+}
+
+void EpochStatsWriter::write(const EpochStatsRecord &record,
+                             const vector<uint64_t> *rankColumns[EPOCH_STATS_RANK_COLUMNS],
+                             const vector<uint64_t> *bankColumns[EPOCH_STATS_BANK_COLUMNS],
+                             const vector<LatencyHistogram> &readLatency,
+                             const vector<LatencyHistogram> &writeLatency)
+{
+	if (out == NULL)
+	{
+		return;
+	}
+
+	size_t start = buffer.size();
+	append(&record, sizeof(record));
+	for (size_t c=0; c<EPOCH_STATS_RANK_COLUMNS; c++)
+	{
+		append(&(*rankColumns[c])[0], NUM_RANKS * sizeof(uint64_t));
+	}
+	for (size_t c=0; c<EPOCH_STATS_BANK_COLUMNS; c++)
+	{
+		append(&(*bankColumns[c])[0], NUM_RANKS * NUM_BANKS * sizeof(uint64_t));
+	}
+
+	//the lengths are filled in as the histograms are walked
+	size_t banks = NUM_RANKS * NUM_BANKS;
+	size_t lengthsStart = buffer.size();
+	buffer.resize(lengthsStart + 2 * banks * sizeof(uint32_t));
+	append(padding, padTo8(2 * banks * sizeof(uint32_t)));
+
+	uint32_t histogramEntries = 0;
+	for (size_t h=0; h<2*banks; h++)
+	{
+		const LatencyHistogram &histogram = h < banks ? readLatency[h] : writeLatency[h-banks];
+		uint32_t length = 0;
+		if (histogram.Count() > 0)
+		{
+			for (size_t b=0; b<histogram.NumBuckets(); b++)
+			{
+				if (histogram.BucketCount(b) == 0)
+				{
+					continue;
+				}
+				//an epoch never sees more than 2^32 requests in one bucket
+				EpochStatsHistogramEntry entry = { (uint32_t)b, (uint32_t)histogram.BucketCount(b) };
+				append(&entry, sizeof(entry));
+				length++;
+			}
+		}
+		memcpy(&buffer[lengthsStart + h * sizeof(uint32_t)], &length, sizeof(length));
+		histogramEntries += length;
+	}
+
+	EpochStatsRecord *written = (EpochStatsRecord *)&buffer[start];
+	written->recordBytes = buffer.size() - start;
+	written->histogramEntries = histogramEntries;
+	recordCount++;
+
+	if (buffer.size() >= EPOCH_STATS_BUFFER_BYTES)
+	{
+		flush();
+	}
+}
+
+void EpochStatsWriter::flush()
+{
+	if (out == NULL)
+	{
+		return;
+	}
+	if (!buffer.empty() && fwrite(&buffer[0], 1, buffer.size(), out) != buffer.size())
+	{
+		ERROR("== Error - Could not write the stats file");
+		exit(0);
+	}
+	buffer.clear();
+	fflush(out);
+}
+
+void EpochStatsWriter::close()
+{
+	if (out == NULL)
+	{
+		return;
+	}
+	flush();
+	fclose(out);
+	out = NULL;
+}
+
+bool EpochStatsReader::isEpochStats(const string &filename)
+{
+	char magic[8];
+	FILE *f = fopen(filename.c_str(), "rb");
+	if (f == NULL)
+	{
+		return false;
+	}
+	bool isStats = fread(magic, 1, sizeof(magic), f) == sizeof(magic) &&
+	               memcmp(magic, EPOCH_STATS_MAGIC, sizeof(magic)) == 0;
+	fclose(f);
+	return isStats;
+}
+
+EpochStatsReader::EpochStatsReader(const string &filename) :
+		in(NULL),
+		filename(filename),
+		recordNumber(0)
+{
+	in = fopen(filename.c_str(), "rb");
+	if (in == NULL)
+	{
+		ERROR("== Error - Could not open stats file '"<<filename<<"'");
+		exit(0);
+	}
+	if (fread(&header, sizeof(header), 1, in) != 1)
+	{
+		ERROR("== Error - Stats file '"<<filename<<"' is truncated");
+		exit(0);
+	}
+	if (memcmp(header.magic, EPOCH_STATS_MAGIC, sizeof(header.magic)) != 0)
+	{
+		ERROR("== Error - '"<<filename<<"' is not a stats file");
+		exit(0);
+	}
+	if (header.version != EPOCH_STATS_VERSION || header.rankColumns != EPOCH_STATS_RANK_COLUMNS ||
+	    header.bankColumns != EPOCH_STATS_BANK_COLUMNS || header.histogramBuckets != LatencyHistogram().NumBuckets())
+	{
+		ERROR("== Error - Stats file '"<<filename<<"' has version "<<header.version<<", expected "<<EPOCH_STATS_VERSION);
+		exit(0);
+	}
+
+	iniText.resize(header.iniTextLength + padTo8(header.iniTextLength));
+	if (!iniText.empty() && fread(&iniText[0], 1, iniText.size(), in) != iniText.size())
+	{
+		ERROR("== Error - Stats file '"<<filename<<"' is truncated");
+		exit(0);
+	}
+	iniText.resize(header.iniTextLength);
+}
+
+EpochStatsReader::~EpochStatsReader()
+{
+	fclose(in);
+}
+
+bool EpochStatsReader::next(EpochStats &epoch)
+{
+	if (fread(&epoch.record, sizeof(epoch.record), 1, in) != 1)
+	{
+		return false;
+	}
+	size_t fixedBytes = fixedRecordBytes(header);
+	if (epoch.record.recordBytes != fixedBytes + epoch.record.histogramEntries * sizeof(EpochStatsHistogramEntry))
+	{
+		ERROR("== Error - Stats file '"<<filename<<"' has a malformed record "<<recordNumber);
+		exit(0);
+	}
+	recordBuffer.resize(epoch.record.recordBytes - sizeof(epoch.record));
+	if (fread(&recordBuffer[0], 1, recordBuffer.size(), in) != recordBuffer.size())
+	{
+		ERROR("== Error - Stats file '"<<filename<<"' is truncated at record "<<recordNumber);
+		exit(0);
+	}
+	recordNumber++;
+
+	size_t banks = (size_t)header.numRanks * header.numBanks;
+	const uint64_t *column = (const uint64_t *)&recordBuffer[0];
+	for (size_t c=0; c<EPOCH_STATS_RANK_COLUMNS; c++)
+	{
+		epoch.rankColumns[c].assign(column, column + header.numRanks);
+		column += header.numRanks;
+	}
+	for (size_t c=0; c<EPOCH_STATS_BANK_COLUMNS; c++)
+	{
+		epoch.bankColumns[c].assign(column, column + banks);
+		column += banks;
+	}
+
+	const uint32_t *lengths = (const uint32_t *)column;
+	const EpochStatsHistogramEntry *entry = (const EpochStatsHistogramEntry *)&recordBuffer[fixedBytes - sizeof(epoch.record)];
+	const EpochStatsHistogramEntry *entriesEnd = entry + epoch.record.histogramEntries;
+	epoch.readLatency.assign(banks, LatencyHistogram());
+	epoch.writeLatency.assign(banks, LatencyHistogram());
+	for (size_t h=0; h<2*banks; h++)
+	{
+		LatencyHistogram &histogram = h < banks ? epoch.readLatency[h] : epoch.writeLatency[h-banks];
+		for (uint32_t i=0; i<lengths[h]; i++, entry++)
+		{
+			if (entry >= entriesEnd || entry->bucket >= header.histogramBuckets)
+			{
+				ERROR("== Error - Stats file '"<<filename<<"' has a malformed record "<<recordNumber-1);
+				exit(0);
+			}
+			histogram.recordBucket(entry->bucket, entry->count);
+		}
+	}
+	return true;
+}
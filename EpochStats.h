@@ -0,0 +1,190 @@
+/****************************************************************************
+*	 DRAMSim2: A Cycle Accurate DRAM simulator 
+*	 
+*	 Copyright (C) 2010   	Elliott Cooper-Balis
+*									Paul Rosenfeld 
+*									Bruce Jacob
+*									University of Maryland
+*
+*	 This program is free software: you can redistribute it and/or modify
+*	 it under the terms of the GNU General Public License as published by
+*	 the Free Software Foundation, either version 3 of the License, or
+*	 (at your option) any later version.
+*
+*	 This program is distributed in the hope that it will be useful,
+*	 but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	 MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	 GNU General Public License for more details.
+*
+*	 You should have received a copy of the GNU General Public License
+*	 along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*****************************************************************************/
+
+#ifndef EPOCHSTATS_H
+#define EPOCHSTATS_H
+
+//EpochStats.h
+//
+//Binary per-epoch statistics stream, written instead of the text stats when
+//BINARY_STATS_OUTPUT is set. A file is an EpochStatsHeader, the ini values
+//as they would appear at the top of a .vis file (padded to 8 bytes), and one
+//record per epoch. Every record has the same schema:
+//
+//	EpochStatsRecord
+//	uint64_t rank columns  [EPOCH_STATS_RANK_COLUMNS][numRanks]
+//	uint64_t bank columns  [EPOCH_STATS_BANK_COLUMNS][numRanks*numBanks]
+//	uint32_t histogram lengths, read then write for every bank [2*numRanks*numBanks] (padded to 8 bytes)
+//	EpochStatsHistogramEntry [histogramEntries], the non-empty buckets of those histograms in order
+//
+//Counters are those of the epoch alone, as printStats() sees them. Fields are
+//stored in host byte order. Use dramsim-statsconv to get CSV or a .vis file.
+//
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "LatencyHistogram.h"
+#include "StallReason.h"
+
+#define EPOCH_STATS_MAGIC "DSIMEST1"
+#define EPOCH_STATS_VERSION 3
+
+// EpochStatsRecord::flags
+#define EPOCH_STATS_FINAL 0x1	// the partial epoch printed with the final stats
+
+// records are collected in memory and written out in blocks of about this size
+#define EPOCH_STATS_BUFFER_BYTES (1<<20)
+
+namespace DRAMSim
+{
+
+// energies are accumulated in mA*cycles, as in the memory controller
+enum EpochStatsRankColumn
+{
+	EPOCH_BACKGROUND_ENERGY,
+	EPOCH_BURST_ENERGY,
+	EPOCH_ACTPRE_ENERGY,
+	EPOCH_REFRESH_ENERGY,
+	EPOCH_REFRESH_CYCLES,
+	EPOCH_POWER_DOWN_CYCLES,
+	EPOCH_STATS_RANK_COLUMNS
+};
+
+enum EpochStatsBankColumn
+{
+	EPOCH_READS,
+	EPOCH_WRITES,
+	EPOCH_READ_LATENCY,	// sum of the read latencies, in cycles
+	EPOCH_ROW_HITS,
+	EPOCH_ROW_MISSES,
+	EPOCH_ROW_CONFLICTS,
+	EPOCH_ACTIVATES,
+	EPOCH_COLUMN_ACCESSES,
+	EPOCH_STALL_CYCLES,	// one column per StallReason, cycles the head of the bank's queue waited
+	EPOCH_STATS_BANK_COLUMNS = EPOCH_STALL_CYCLES + STALL_REASONS
+};
+
+extern const char *epochStatsRankColumnNames[EPOCH_STATS_RANK_COLUMNS];
+extern const char *epochStatsBankColumnNames[EPOCH_STATS_BANK_COLUMNS];
+
+struct EpochStatsHeader
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t systemID;
+	uint32_t numRanks;
+	uint32_t numBanks;
+	uint32_t rankColumns;
+	uint32_t bankColumns;
+	uint32_t histogramBuckets;
+	uint32_t bytesPerTransaction;
+	float tCK;
+	float Vdd;
+	uint64_t epochLength;
+	uint64_t iniTextLength;	// unpadded
+};
+
+struct EpochStatsRecord
+{
+	uint64_t recordBytes;	// including this header
+	uint64_t cycle;
+	uint64_t cyclesElapsed;
+	uint64_t transactions;
+	uint64_t admitted;
+	uint64_t admissionWait;
+	uint64_t commandBusCycles;
+	uint64_t dataBusCycles;
+	uint64_t readToWrite;
+	uint64_t writeToRead;
+	uint64_t rankSwitches;
+	uint32_t flags;
+	uint32_t histogramEntries;
+};
+
+struct EpochStatsHistogramEntry
+{
+	uint32_t bucket;
+	uint32_t count;
+};
+
+class EpochStatsWriter
+{
+public:
+	EpochStatsWriter(const std::string &filename, unsigned systemID);
+	virtual ~EpochStatsWriter();
+
+	void write(const EpochStatsRecord &record,
+	           const std::vector<uint64_t> *rankColumns[EPOCH_STATS_RANK_COLUMNS],
+	           const std::vector<uint64_t> *bankColumns[EPOCH_STATS_BANK_COLUMNS],
+	           const std::vector<LatencyHistogram> &readLatency,
+	           const std::vector<LatencyHistogram> &writeLatency);
+	void flush();
+	void close();
+
+	uint64_t records() const { return recordCount; }
+
+private:
+	void append(const void *data, size_t length);
+
+	FILE *out;
+	std::vector<char> buffer;
+	uint64_t recordCount;
+};
+
+//one decoded record
+struct EpochStats
+{
+	EpochStatsRecord record;
+	std::vector<uint64_t> rankColumns[EPOCH_STATS_RANK_COLUMNS];
+	std::vector<uint64_t> bankColumns[EPOCH_STATS_BANK_COLUMNS];
+	std::vector<LatencyHistogram> readLatency;
+	std::vector<LatencyHistogram> writeLatency;
+};
+
+class EpochStatsReader
+{
+public:
+	EpochStatsReader(const std::string &filename);
+	virtual ~EpochStatsReader();
+	bool next(EpochStats &epoch);
+
+	const EpochStatsHeader &Header() const { return header; }
+	const std::string &IniText() const { return iniText; }
+
+	static bool isEpochStats(const std::string &filename);
+
+private:
+	FILE *in;
+	std::string filename;
+	EpochStatsHeader header;
+	std::string iniText;
+	std::vector<char> recordBuffer;
+	uint64_t recordNumber;
+};
+
+}
+
+#endif
+
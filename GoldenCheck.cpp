@@ -0,0 +1,642 @@
+/****************************************************************************
+*	 DRAMSim2: A Cycle Accurate DRAM simulator 
+*	 
+*	 Copyright (C) 2010   	Elliott Cooper-Balis
+*									Paul Rosenfeld 
+*									Bruce Jacob
+*									University of Maryland
+*
+*	 This program is free software: you can redistribute it and/or modify
+*	 it under the terms of the GNU General Public License as published by
+*	 the Free Software Foundation, either version 3 of the License, or
+*	 (at your option) any later version.
+*
+*	 This program is distributed in the hope that it will be useful,
+*	 but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	 MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	 GNU General Public License for more details.
+*
+*	 You should have received a copy of the GNU General Public License
+*	 along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*****************************************************************************/
+
+//GoldenCheck.cpp
+//
+//Cycle-equivalence harness for changes to the simulation engine. "record"
+//runs one configuration and writes a golden log of every command the
+//controller issues (with its cycle), every completion callback, and the
+//statistics counters and energies at each epoch boundary and at the end.
+//"compare" reports the first line at which two golden logs differ, with
+//the lines leading up to it. "check" records every device, row buffer
+//policy, queuing structure and traffic source with a reference build and
+//with this build, and compares each pair.
+//
+//The configuration is process-wide, so two engines can't share a process;
+//the reference is always a separate executable.
+//
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <deque>
+#include <getopt.h>
+#include <glob.h>
+#include <unistd.h>
+#include <limits.h>
+#include <sys/wait.h>
+#include <cstring>
+
+#include "SystemConfiguration.h"
+#include "MemorySystem.h"
+#include "IniReader.h"
+#include "TraceReader.h"
+#include "TracePipeline.h"
+#include "TrafficGenerator.h"
+
+using namespace DRAMSim;
+using namespace std;
+
+//lines shown before and after the first divergence
+#define GOLDEN_CONTEXT_LINES 8
+
+static const char *commandNames[] = {"READ", "READ_P", "WRITE", "WRITE_P", "ACTIVATE", "PRECHARGE", "REFRESH", "DATA"};
+
+void usage()
+{
+	cout << "dramsim-golden Usage: " << endl;
+	cout << "dramsim-golden record -s system.ini -d ini/device.ini (-t trace | -g SPEC) [-c #] [-m #] [-p pwd] -o out.golden" <<endl;
+	cout << "\twrites the command stream, completions and statistics of one run"<<endl;
+	cout << "dramsim-golden compare reference.golden candidate.golden" <<endl;
+	cout << "\treports the first divergence between two golden logs"<<endl;
+	cout << "dramsim-golden check -r path/to/reference/dramsim-golden -s system.ini [-d ini/device.ini ...] [-t trace ...] [-g SPEC ...] [options]" <<endl;
+	cout << "\trecords with both builds and compares every device [default=ini/*.ini], row buffer policy, queuing"<<endl;
+	cout << "\tstructure and traffic source [default=the uniform, stream and rowhostile generators]"<<endl;
+	cout << "\t-c, --numcycles=# \t\tcycles simulated per run [default=100000]"<<endl;
+	cout << "\t-m, --size=# \t\t\tsize of the memory system in megabytes [default=2048]"<<endl;
+	cout << "\t-k, --keep \t\t\tkeep the golden logs of identical runs too"<<endl;
+}
+
+class GoldenRecorder
+{
+public:
+	GoldenRecorder(MemorySystem *ms, ostream &out, TrafficGenerator *generator) :
+			memorySystem(ms),
+			out(out),
+			generator(generator)
+	{
+		commandCB = new Callback_3Param<GoldenRecorder, void, uint, const BusPacket *, uint64_t>(this, &GoldenRecorder::commandIssued);
+		readCB = new Callback_4Param<GoldenRecorder, void, uint, uint64_t, uint64_t, uint64_t>(this, &GoldenRecorder::readComplete);
+		writeCB = new Callback_4Param<GoldenRecorder, void, uint, uint64_t, uint64_t, uint64_t>(this, &GoldenRecorder::writeComplete);
+		//the generator's own callbacks are replaced, completions are forwarded to it
+		memorySystem->RegisterCallbacks(readCB, writeCB, NULL);
+		memorySystem->RegisterCommandCallback(commandCB);
+	}
+
+	~GoldenRecorder()
+	{
+		memorySystem->RegisterCallbacks(NULL, NULL, NULL);
+		memorySystem->RegisterCommandCallback(NULL);
+		delete commandCB;
+		delete readCB;
+		delete writeCB;
+	}
+
+	void commandIssued(uint id, const BusPacket *packet, uint64_t cycle)
+	{
+		out << "C " << cycle << " " << commandNames[packet->busPacketType] << " rank=" << packet->rank
+		    << " bank=" << packet->bank << " row=" << packet->row << " col=" << packet->column
+		    << " tx=" << packet->transID << "\n";
+	}
+
+	void readComplete(uint id, uint64_t address, uint64_t doneCycle, uint64_t txID)
+	{
+		out << "R " << doneCycle << " tx=" << txID << " addr=0x" << hex << address << dec << "\n";
+		if (generator != NULL)
+		{
+			generator->readComplete(id, address, doneCycle, txID);
+		}
+	}
+
+	void writeComplete(uint id, uint64_t address, uint64_t doneCycle, uint64_t txID)
+	{
+		out << "W " << doneCycle << " tx=" << txID << " addr=0x" << hex << address << dec << "\n";
+		if (generator != NULL)
+		{
+			generator->writeComplete(id, address, doneCycle, txID);
+		}
+	}
+
+	//the counters printStats reports, before they are reset for the next epoch
+	void snapshot(uint64_t cycle)
+	{
+		MemoryController *mc = memorySystem->memoryController;
+		out << "S " << cycle << " transactions=" << mc->TotalTransactions() << " admitted=" << mc->TotalAdmitted()
+		    << " admission_wait=" << mc->TotalAdmissionWait() << "\n";
+		for (size_t r=0; r<NUM_RANKS; r++)
+		{
+			out << "S " << cycle << " rank=" << r << " background=" << (*mc->BackgroundEnergy())[r]
+			    << " burst=" << (*mc->BurstEnergy())[r] << " actpre=" << (*mc->ActpreEnergy())[r]
+			    << " refresh=" << (*mc->RefreshEnergy())[r] << "\n";
+			for (size_t b=0; b<NUM_BANKS; b++)
+			{
+				size_t i = r*NUM_BANKS + b;
+				out << "S " << cycle << " rank=" << r << " bank=" << b << " reads=" << mc->TotalReadsPerBank()[i]
+				    << " writes=" << mc->TotalWritesPerBank()[i] << " latency=" << mc->TotalEpochLatency()[i] << "\n";
+			}
+		}
+	}
+
+private:
+	MemorySystem *memorySystem;
+	ostream &out;
+	TrafficGenerator *generator;
+	CommandCallback_t *commandCB;
+	Callback_t *readCB;
+	Callback_t *writeCB;
+};
+
+int record(int argc, char **argv)
+{
+	string systemIni = "", deviceIni = "", pwd = "", trace = "", generatorSpec = "", outputFilename = "";
+	uint64_t numCycles = 100000;
+	unsigned megsOfMemory = 2048;
+
+	while (1)
+	{
+		static struct option long_options[] =
+		{
+			{"systemini", required_argument, 0, 's'},
+			{"deviceini", required_argument, 0, 'd'},
+			{"pwd", required_argument, 0, 'p'},
+			{"tracefile", required_argument, 0, 't'},
+			{"generator", required_argument, 0, 'g'},
+			{"numcycles", required_argument, 0, 'c'},
+			{"size", required_argument, 0, 'm'},
+			{"output", required_argument, 0, 'o'},
+			{0, 0, 0, 0}
+		};
+		int option_index=0;
+		int c = getopt_long(argc, argv, "s:d:p:t:g:c:m:o:", long_options, &option_index);
+		if (c == -1)
+		{
+			break;
+		}
+		switch (c)
+		{
+		case 's':
+			systemIni = optarg;
+			break;
+		case 'd':
+			deviceIni = optarg;
+			break;
+		case 'p':
+			pwd = optarg;
+			break;
+		case 't':
+			trace = optarg;
+			break;
+		case 'g':
+			generatorSpec = optarg;
+			break;
+		case 'c':
+			numCycles = strtoull(optarg, NULL, 10);
+			break;
+		case 'm':
+			megsOfMemory = atoi(optarg);
+			break;
+		case 'o':
+			outputFilename = optarg;
+			break;
+		default:
+			usage();
+			exit(-1);
+		}
+	}
+	if (systemIni.length() == 0 || deviceIni.length() == 0 || outputFilename.length() == 0 ||
+	        (trace.length() == 0) == (generatorSpec.length() == 0))
+	{
+		ERROR("record needs a system ini, a device ini, an output file and either a trace or a generator");
+		usage();
+		exit(-1);
+	}
+
+	ofstream out(outputFilename.c_str());
+	if (!out)
+	{
+		ERROR("== Error - could not open output file '"<<outputFilename<<"'");
+		exit(-1);
+	}
+
+	SHOW_SIM_OUTPUT = 0;
+	MemorySystem::disableSideOutputs();
+	MemorySystem *memorySystem = new MemorySystem(0, deviceIni, systemIni, pwd, "golden", megsOfMemory);
+
+	//only what stays the same between builds goes in the header
+	out << "# device=" << deviceIni.substr(deviceIni.find_last_of("/")+1) << " row_buffer_policy=" << ROW_BUFFER_POLICY
+	    << " queuing_structure=" << QUEUING_STRUCTURE << " traffic="
+	    << (trace.length() > 0 ? trace.substr(trace.find_last_of("/")+1) : generatorSpec) << " cycles=" << numCycles << "\n";
+
+	TrafficGenerator *generator = NULL;
+	TraceReader *traceReader = NULL;
+	if (generatorSpec.length() > 0)
+	{
+		generator = new TrafficGenerator(memorySystem, TrafficGenerator::parseSpec(generatorSpec));
+	}
+	else
+	{
+		if (pwd.length() > 0 && trace[0] != '/')
+		{
+			trace = pwd + "/" + trace;
+		}
+		traceReader = new PipelinedTraceReader(TraceReader::open(trace), dramsim_log2(BL*JEDEC_DATA_BUS_BITS/8));
+	}
+	GoldenRecorder *recorder = new GoldenRecorder(memorySystem, out, generator);
+
+	//trace requests are offered in order, no earlier than their timestamp
+	TraceRecord traceRecord;
+	Transaction trans;
+	bool pending = false;
+	bool traceDone = traceReader == NULL;
+
+	for (uint64_t i=0; i<numCycles; i++)
+	{
+		uint64_t cycle = memorySystem->memoryController->currentClockCycle;
+		if (cycle > 0 && cycle % EPOCH_LENGTH == 0)
+		{
+			recorder->snapshot(cycle);
+		}
+
+		if (generator != NULL)
+		{
+			generator->update();
+		}
+		while (!traceDone)
+		{
+			if (!pending)
+			{
+				if (!traceReader->next(traceRecord))
+				{
+					traceDone = true;
+					break;
+				}
+				trans = Transaction(traceRecord.type, traceRecord.address, traceRecord.data, traceRecord.lineNumber);
+				pending = true;
+			}
+			if (traceRecord.cycle > i || !memorySystem->addTransaction(trans))
+			{
+				break;
+			}
+			pending = false;
+		}
+		memorySystem->update();
+	}
+	recorder->snapshot(memorySystem->memoryController->currentClockCycle);
+	out << "# end\n";
+
+	delete recorder;
+	delete generator;
+	delete traceReader;
+	delete memorySystem;
+	return 0;
+}
+
+//returns true if both logs are identical, otherwise reports the first divergence
+bool compare(const string &referenceFilename, const string &candidateFilename, ostream &report)
+{
+	ifstream reference(referenceFilename.c_str()), candidate(candidateFilename.c_str());
+	if (!reference || !candidate)
+	{
+		report << "== Could not open '" << (!reference ? referenceFilename : candidateFilename) << "'" << endl;
+		return false;
+	}
+
+	deque<string> context;
+	string referenceLine, candidateLine;
+	uint64_t lineNumber = 0, commands = 0, completions = 0;
+	while (true)
+	{
+		bool haveReference = !getline(reference, referenceLine).fail();
+		bool haveCandidate = !getline(candidate, candidateLine).fail();
+		lineNumber++;
+		if (!haveReference && !haveCandidate)
+		{
+			report << "== Identical: " << commands << " commands, " << completions << " completions" << endl;
+			return true;
+		}
+		if (haveReference && haveCandidate && referenceLine == candidateLine)
+		{
+			commands += referenceLine[0] == 'C';
+			completions += referenceLine[0] == 'R' || referenceLine[0] == 'W';
+			context.push_back(referenceLine);
+			if (context.size() > GOLDEN_CONTEXT_LINES)
+			{
+				context.pop_front();
+			}
+			continue;
+		}
+
+		//name the stream the divergence is in and the cycle it happened at
+		const string &line = haveReference ? referenceLine : candidateLine;
+		const char *stream = "header";
+		switch (line[0])
+		{
+		case 'C':
+			stream = "command stream";
+			break;
+		case 'R':
+		case 'W':
+			stream = "completions";
+			break;
+		case 'S':
+			stream = "statistics";
+			break;
+		}
+		report << "== First divergence at line " << lineNumber << " (" << stream;
+		if (line[0] != '#')
+		{
+			report << ", cycle " << line.substr(2, line.find(' ', 2) - 2);
+		}
+		report << ") after " << commands << " identical commands and " << completions << " completions" << endl;
+		report << "   identical lines before it:" << endl;
+		for (size_t i=0; i<context.size(); i++)
+		{
+			report << "     " << context[i] << endl;
+		}
+
+		report << "   reference (" << referenceFilename << "):" << endl;
+		if (!haveReference)
+		{
+			report << "     <end of log>" << endl;
+		}
+		for (unsigned i=0; haveReference && i<GOLDEN_CONTEXT_LINES; i++)
+		{
+			report << "   " << (i == 0 ? "> " : "  ") << referenceLine << endl;
+			haveReference = !getline(reference, referenceLine).fail();
+		}
+		report << "   candidate (" << candidateFilename << "):" << endl;
+		if (!haveCandidate)
+		{
+			report << "     <end of log>" << endl;
+		}
+		for (unsigned i=0; haveCandidate && i<GOLDEN_CONTEXT_LINES; i++)
+		{
+			report << "   " << (i == 0 ? "> " : "  ") << candidateLine << endl;
+			haveCandidate = !getline(candidate, candidateLine).fail();
+		}
+		return false;
+	}
+}
+
+//runs "binary record args..." and waits for it
+bool runRecord(const string &binary, const vector<string> &args)
+{
+	pid_t pid = fork();
+	if (pid < 0)
+	{
+		ERROR("== Error - could not fork");
+		exit(-1);
+	}
+	if (pid == 0)
+	{
+		vector<char *> argv;
+		argv.push_back((char *)binary.c_str());
+		argv.push_back((char *)"record");
+		for (size_t i=0; i<args.size(); i++)
+		{
+			argv.push_back((char *)args[i].c_str());
+		}
+		argv.push_back(NULL);
+		execv(binary.c_str(), &argv[0]);
+		ERROR("== Error - could not run '"<<binary<<"'");
+		_exit(127);
+	}
+	int status;
+	waitpid(pid, &status, 0);
+	return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+int check(int argc, char **argv)
+{
+	string referenceBinary = "", systemIni = "", pwd = "", numCycles = "100000", megsOfMemory = "2048";
+	vector<string> deviceInis, traffic;
+	bool keep = false;
+
+	while (1)
+	{
+		static struct option long_options[] =
+		{
+			{"reference", required_argument, 0, 'r'},
+			{"systemini", required_argument, 0, 's'},
+			{"deviceini", required_argument, 0, 'd'},
+			{"pwd", required_argument, 0, 'p'},
+			{"tracefile", required_argument, 0, 't'},
+			{"generator", required_argument, 0, 'g'},
+			{"numcycles", required_argument, 0, 'c'},
+			{"size", required_argument, 0, 'm'},
+			{"keep", no_argument, 0, 'k'},
+			{0, 0, 0, 0}
+		};
+		int option_index=0;
+		int c = getopt_long(argc, argv, "r:s:d:p:t:g:c:m:k", long_options, &option_index);
+		if (c == -1)
+		{
+			break;
+		}
+		switch (c)
+		{
+		case 'r':
+			referenceBinary = optarg;
+			break;
+		case 's':
+			systemIni = optarg;
+			break;
+		case 'd':
+			deviceInis.push_back(optarg);
+			break;
+		case 'p':
+			pwd = optarg;
+			break;
+		case 't':
+			traffic.push_back(string("-t") + optarg);
+			break;
+		case 'g':
+			traffic.push_back(string("-g") + optarg);
+			break;
+		case 'c':
+			numCycles = optarg;
+			break;
+		case 'm':
+			megsOfMemory = optarg;
+			break;
+		case 'k':
+			keep = true;
+			break;
+		default:
+			usage();
+			exit(-1);
+		}
+	}
+	if (referenceBinary.length() == 0 || systemIni.length() == 0)
+	{
+		ERROR("check needs a reference build (-r) and a system ini file");
+		usage();
+		exit(-1);
+	}
+
+	char candidateBinary[PATH_MAX];
+	ssize_t length = readlink("/proc/self/exe", candidateBinary, sizeof(candidateBinary)-1);
+	if (length <= 0)
+	{
+		ERROR("== Error - could not find this executable");
+		exit(-1);
+	}
+	candidateBinary[length] = '\0';
+
+	if (pwd.length() > 0 && systemIni[0] != '/')
+	{
+		systemIni = pwd + "/" + systemIni;
+	}
+	if (deviceInis.size() == 0)
+	{
+		string pattern = (pwd.length() > 0 ? pwd + "/" : "") + "ini/*.ini";
+		glob_t globbed;
+		if (glob(pattern.c_str(), 0, NULL, &globbed) == 0)
+		{
+			for (size_t i=0; i<globbed.gl_pathc; i++)
+			{
+				deviceInis.push_back(globbed.gl_pathv[i]);
+			}
+		}
+		globfree(&globbed);
+		if (deviceInis.size() == 0)
+		{
+			ERROR("== No device ini files found under '"<<pattern<<"'");
+			exit(-1);
+		}
+	}
+	else if (pwd.length() > 0)
+	{
+		for (size_t i=0; i<deviceInis.size(); i++)
+		{
+			if (deviceInis[i][0] != '/')
+			{
+				deviceInis[i] = pwd + "/" + deviceInis[i];
+			}
+		}
+	}
+	if (traffic.size() == 0)
+	{
+		traffic.push_back("-guniform,seed=1,rate=0.5,outstanding=32,reads=0.67");
+		traffic.push_back("-gstream,seed=2,rate=0.5,outstanding=32,reads=0.67");
+		traffic.push_back("-growhostile,seed=3,rate=0.5,outstanding=32,reads=0.67");
+	}
+
+	char directory[] = "/tmp/dramsim-golden-XXXXXX";
+	if (mkdtemp(directory) == NULL)
+	{
+		ERROR("== Error - could not create a directory for the golden logs");
+		exit(-1);
+	}
+
+	static const char *policies[] = {"open_page", "close_page"};
+	static const char *structures[] = {"per_rank", "per_rank_per_bank"};
+	vector<string> variants;
+	for (size_t p=0; p<2; p++)
+	{
+		for (size_t s=0; s<2; s++)
+		{
+			vector<string> keys, values;
+			keys.push_back("ROW_BUFFER_POLICY");
+			values.push_back(policies[p]);
+			keys.push_back("QUEUING_STRUCTURE");
+			values.push_back(structures[s]);
+			variants.push_back(IniReader::WriteIniVariant(systemIni, keys, values));
+		}
+	}
+
+	unsigned runs = 0, divergent = 0;
+	for (size_t d=0; d<deviceInis.size(); d++)
+	{
+		for (size_t v=0; v<variants.size(); v++)
+		{
+			for (size_t t=0; t<traffic.size(); t++)
+			{
+				ostringstream name;
+				name << directory << "/" << runs;
+				vector<string> args;
+				args.push_back("-s" + variants[v]);
+				args.push_back("-d" + deviceInis[d]);
+				args.push_back(traffic[t]);
+				args.push_back("-c" + numCycles);
+				args.push_back("-m" + megsOfMemory);
+
+				cout << "== " << deviceInis[d] << " " << policies[v/2] << " " << structures[v%2] << " "
+				     << traffic[t].substr(2) << endl;
+				runs++;
+
+				vector<string> referenceArgs = args, candidateArgs = args;
+				referenceArgs.push_back("-o" + name.str() + ".reference");
+				candidateArgs.push_back("-o" + name.str() + ".candidate");
+				if (!runRecord(referenceBinary, referenceArgs) || !runRecord(candidateBinary, candidateArgs))
+				{
+					cout << "== Recording failed" << endl;
+					divergent++;
+					continue;
+				}
+				if (compare(name.str() + ".reference", name.str() + ".candidate", cout))
+				{
+					if (!keep)
+					{
+						unlink((name.str() + ".reference").c_str());
+						unlink((name.str() + ".candidate").c_str());
+					}
+				}
+				else
+				{
+					divergent++;
+				}
+			}
+		}
+	}
+	for (size_t v=0; v<variants.size(); v++)
+	{
+		unlink(variants[v].c_str());
+	}
+	if (divergent == 0 && !keep)
+	{
+		rmdir(directory);
+	}
+
+	cout << "== " << runs - divergent << " of " << runs << " runs are cycle-identical";
+	if (divergent > 0 || keep)
+	{
+		cout << ", golden logs are in " << directory;
+	}
+	cout << endl;
+	return divergent == 0 ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+	if (argc < 2)
+	{
+		usage();
+		exit(-1);
+	}
+	string mode = argv[1];
+	if (mode == "record")
+	{
+		return record(argc-1, argv+1);
+	}
+	else if (mode == "compare" && argc == 4)
+	{
+		return compare(argv[2], argv[3], cout) ? 0 : 1;
+	}
+	else if (mode == "check")
+	{
+		return check(argc-1, argv+1);
+	}
+	usage();
+	exit(mode == "-h" || mode == "--help" ? 0 : -1);
+}
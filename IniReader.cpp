@@ -27,6 +27,8 @@
 
 
 #include "IniReader.h"
+#include <unistd.h>
+#include <cstdlib>
 
 using namespace std;
 
@@ -106,6 +108,13 @@ bool DEBUG_BANKS;
 bool DEBUG_POWER;
 bool USE_LOW_POWER;
 bool VIS_FILE_OUTPUT;
+bool BINARY_STATS_OUTPUT;
+bool ASYNC_LOG_OUTPUT;
+bool SHARED_STATS_OUTPUT;
+bool LATENCY_LOG_OUTPUT;
+bool ROW_HEAT_OUTPUT;
+bool STALL_STATS_OUTPUT;
+string TIMELINE_WINDOW;
 
 bool VERIFICATION_OUTPUT;
 
@@ -188,11 +197,18 @@ static ConfigMap configMap[] =
 	DEFINE_BOOL_PARAM(DEBUG_BANKS,SYS_PARAM),
 	DEFINE_BOOL_PARAM(DEBUG_POWER,SYS_PARAM),
 	DEFINE_BOOL_PARAM(VIS_FILE_OUTPUT,SYS_PARAM),
+	DEFINE_BOOL_PARAM(BINARY_STATS_OUTPUT,SYS_PARAM),
+	DEFINE_BOOL_PARAM(ASYNC_LOG_OUTPUT,SYS_PARAM),
+	DEFINE_BOOL_PARAM(SHARED_STATS_OUTPUT,SYS_PARAM),
+	DEFINE_BOOL_PARAM(LATENCY_LOG_OUTPUT,SYS_PARAM),
+	DEFINE_BOOL_PARAM(ROW_HEAT_OUTPUT,SYS_PARAM),
+	DEFINE_BOOL_PARAM(STALL_STATS_OUTPUT,SYS_PARAM),
+	DEFINE_STRING_PARAM(TIMELINE_WINDOW,SYS_PARAM),
 	DEFINE_BOOL_PARAM(VERIFICATION_OUTPUT,SYS_PARAM),
 	{"", NULL, UINT, SYS_PARAM, false} // tracer value to signify end of list; if you delete it, epic fail will result
 };
 
-void IniReader::WriteParams(std::ofstream &visDataOut, paramType type)
+void IniReader::WriteParams(std::ostream &visDataOut, paramType type)
 {
 	for (size_t i=0; configMap[i].variablePtr != NULL; i++)
 	{
@@ -229,7 +245,7 @@ void IniReader::WriteParams(std::ofstream &visDataOut, paramType type)
 		}
 	}
 }
-void IniReader::WriteValuesOut(std::ofstream &visDataOut)
+void IniReader::WriteValuesOut(std::ostream &visDataOut)
 {
 	visDataOut<<"!!SYSTEM_INI"<<endl;
 
@@ -571,4 +587,52 @@ void IniReader::InitEnumsFromStrings()
 
 }
 
+string IniReader::WriteIniVariant(string filename, vector<string> keys, vector<string> values)
+{
+	if (keys.size() != values.size())
+	{
+		ERROR("== Error - every overridden key needs a value");
+		exit(-1);
+	}
+	ifstream iniFile(filename.c_str());
+	if (!iniFile.is_open())
+	{
+		ERROR("Unable to load ini file "<<filename);
+		exit(-1);
+	}
+	char variantFilename[] = "/tmp/dramsim-ini-XXXXXX";
+	int fd = mkstemp(variantFilename);
+	if (fd < 0)
+	{
+		ERROR("== Error - could not create a temporary ini file");
+		exit(-1);
+	}
+	close(fd);
+
+	ofstream variantFile(variantFilename);
+	string line;
+	while (getline(iniFile, line))
+	{
+		bool overridden = false;
+		for (size_t i=0; i<keys.size(); i++)
+		{
+			if (line.compare(0, keys[i].size(), keys[i]) == 0 && line.size() > keys[i].size() &&
+			        (line[keys[i].size()] == '=' || line[keys[i].size()] == ' ' || line[keys[i].size()] == '\t'))
+			{
+				overridden = true;
+				break;
+			}
+		}
+		if (!overridden)
+		{
+			variantFile << line << endl;
+		}
+	}
+	for (size_t i=0; i<keys.size(); i++)
+	{
+		variantFile << keys[i] << "=" << values[i] << endl;
+	}
+	return variantFilename;
+}
+
 } // namespace DRAMSim
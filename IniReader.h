@@ -67,10 +67,13 @@ public:
 	static void ReadIniFile(string filename, bool isSystemParam);
 	static void InitEnumsFromStrings();
 	static bool CheckIfAllSet();
-	static void WriteValuesOut(std::ofstream &visDataOut);
+	static void WriteValuesOut(std::ostream &visDataOut);
+	// copies an ini file into a new temporary file with the given keys
+	// replaced, and returns its name; the caller removes it
+	static string WriteIniVariant(string filename, vector<string> keys, vector<string> values);
 
 private:
-	static void WriteParams(std::ofstream &visDataOut, paramType t);
+	static void WriteParams(std::ostream &visDataOut, paramType t);
 	static void Trim(string &str);
 };
 }
@@ -0,0 +1,212 @@
+/****************************************************************************
+*	 DRAMSim2: A Cycle Accurate DRAM simulator 
+*	 
+*	 Copyright (C) 2010   	Elliott Cooper-Balis
+*									Paul Rosenfeld 
+*									Bruce Jacob
+*									University of Maryland
+*
+*	 This program is free software: you can redistribute it and/or modify
+*	 it under the terms of the GNU General Public License as published by
+*	 the Free Software Foundation, either version 3 of the License, or
+*	 (at your option) any later version.
+*
+*	 This program is distributed in the hope that it will be useful,
+*	 but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	 MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	 GNU General Public License for more details.
+*
+*	 You should have received a copy of the GNU General Public License
+*	 along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*****************************************************************************/
+
+
+
+//LZCodec.cpp
+//
+//Block compressor and decompressor for the bundled LZ codec
+//
+
+#include "LZCodec.h"
+#include <cstring>
+#include <vector>
+
+using namespace DRAMSim;
+using namespace std;
+
+#define LZ_MIN_MATCH 4
+#define LZ_MAX_OFFSET 65535
+#define LZ_HASH_BITS 14
+//matches never cover the last bytes of a block, so the tail is always literals
+#define LZ_TAIL_LITERALS 5
+
+namespace
+{
+inline uint32_t read32(const uint8_t *p)
+{
+	uint32_t v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+inline uint32_t hash32(uint32_t v)
+{
+	return (v * 2654435761U) >> (32 - LZ_HASH_BITS);
+}
+
+inline uint8_t *writeLength(uint8_t *op, size_t length)
+{
+	while (length >= 255)
+	{
+		*op++ = 255;
+		length -= 255;
+	}
+	*op++ = (uint8_t)length;
+	return op;
+}
+
+inline uint8_t *writeSequence(uint8_t *op, const uint8_t *literals, size_t literalCount,
+                              size_t offset, size_t matchLength)
+{
+	uint8_t *token = op++;
+	*token = (literalCount >= 15 ? 15 : literalCount) << 4;
+	if (literalCount >= 15)
+	{
+		op = writeLength(op, literalCount - 15);
+	}
+	memcpy(op, literals, literalCount);
+	op += literalCount;
+
+	//the final sequence has no match
+	if (matchLength == 0)
+	{
+		return op;
+	}
+
+	*op++ = offset & 0xFF;
+	*op++ = offset >> 8;
+	size_t extra = matchLength - LZ_MIN_MATCH;
+	*token |= extra >= 15 ? 15 : extra;
+	if (extra >= 15)
+	{
+		op = writeLength(op, extra - 15);
+	}
+	return op;
+}
+
+//reads an extended length; returns false if it runs past the end of the block
+inline bool readLength(const uint8_t *&ip, const uint8_t *end, size_t &length)
+{
+	uint8_t b;
+	do
+	{
+		if (ip >= end)
+		{
+			return false;
+		}
+		b = *ip++;
+		length += b;
+	} while (b == 255);
+	return true;
+}
+}
+
+size_t DRAMSim::lzCompressBound(size_t n)
+{
+	return n + n/255 + 16;
+}
+
+size_t DRAMSim::lzCompress(const uint8_t *in, size_t n, uint8_t *out)
+{
+	//positions are stored + 1 so that 0 means empty
+	vector<uint32_t> table(1 << LZ_HASH_BITS, 0);
+	uint8_t *op = out;
+	size_t anchor = 0;
+	size_t ip = 0;
+	size_t matchLimit = n > LZ_TAIL_LITERALS ? n - LZ_TAIL_LITERALS : 0;
+
+	while (ip + LZ_MIN_MATCH <= matchLimit)
+	{
+		uint32_t sequence = read32(in + ip);
+		uint32_t h = hash32(sequence);
+		size_t candidate = table[h];
+		table[h] = ip + 1;
+
+		if (candidate == 0 || ip - (candidate - 1) > LZ_MAX_OFFSET || read32(in + candidate - 1) != sequence)
+		{
+			ip++;
+			continue;
+		}
+
+		size_t ref = candidate - 1;
+		size_t length = LZ_MIN_MATCH;
+		while (ip + length < matchLimit && in[ref + length] == in[ip + length])
+		{
+			length++;
+		}
+		op = writeSequence(op, in + anchor, ip - anchor, ip - ref, length);
+		ip += length;
+		anchor = ip;
+	}
+
+	op = writeSequence(op, in + anchor, n - anchor, 0, 0);
+	return op - out;
+}
+
+bool DRAMSim::lzDecompress(const uint8_t *in, size_t n, uint8_t *out, size_t rawSize)
+{
+	const uint8_t *ip = in;
+	const uint8_t *end = in + n;
+	uint8_t *op = out;
+	uint8_t *outEnd = out + rawSize;
+
+	while (ip < end)
+	{
+		uint8_t token = *ip++;
+
+		size_t literalCount = token >> 4;
+		if (literalCount == 15 && !readLength(ip, end, literalCount))
+		{
+			return false;
+		}
+		if (literalCount > (size_t)(end - ip) || literalCount > (size_t)(outEnd - op))
+		{
+			return false;
+		}
+		memcpy(op, ip, literalCount);
+		ip += literalCount;
+		op += literalCount;
+
+		if (ip == end)
+		{
+			break;
+		}
+
+		if (end - ip < 2)
+		{
+			return false;
+		}
+		size_t offset = ip[0] | (ip[1] << 8);
+		ip += 2;
+		size_t matchLength = token & 15;
+		if (matchLength == 15 && !readLength(ip, end, matchLength))
+		{
+			return false;
+		}
+		matchLength += LZ_MIN_MATCH;
+		if (offset == 0 || offset > (size_t)(op - out) || matchLength > (size_t)(outEnd - op))
+		{
+			return false;
+		}
+
+		//matches may overlap their own output, so copy forward byte by byte
+		const uint8_t *match = op - offset;
+		for (size_t i=0; i<matchLength; i++)
+		{
+			op[i] = match[i];
+		}
+		op += matchLength;
+	}
+	return op == outEnd;
+}
@@ -0,0 +1,57 @@
+/****************************************************************************
+*	 DRAMSim2: A Cycle Accurate DRAM simulator 
+*	 
+*	 Copyright (C) 2010   	Elliott Cooper-Balis
+*									Paul Rosenfeld 
+*									Bruce Jacob
+*									University of Maryland
+*
+*	 This program is free software: you can redistribute it and/or modify
+*	 it under the terms of the GNU General Public License as published by
+*	 the Free Software Foundation, either version 3 of the License, or
+*	 (at your option) any later version.
+*
+*	 This program is distributed in the hope that it will be useful,
+*	 but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	 MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	 GNU General Public License for more details.
+*
+*	 You should have received a copy of the GNU General Public License
+*	 along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*****************************************************************************/
+#ifndef LZCODEC_H
+#define LZCODEC_H
+
+//LZCodec.h
+//
+//Small LZ77 block codec bundled for compressed traces. A block is a run of
+//sequences; each sequence is a token byte (literal count in the high
+//nibble, match length - 4 in the low nibble, 15 meaning more length bytes
+//follow), the literals, and a 2-byte little-endian match offset followed
+//by any extra match length bytes. The last sequence holds literals only.
+//
+//A compressed stream is LZ_STREAM_MAGIC followed by blocks of at most
+//LZ_BLOCK_SIZE bytes, each prefixed by its uncompressed and compressed
+//sizes (uint32_t, host byte order).
+//
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define LZ_STREAM_MAGIC "DSIMLZ01"
+#define LZ_BLOCK_SIZE (1<<20)
+
+namespace DRAMSim
+{
+//worst case size of a compressed block of n bytes
+size_t lzCompressBound(size_t n);
+//compresses n bytes into out, which must hold lzCompressBound(n) bytes;
+//returns the compressed size
+size_t lzCompress(const uint8_t *in, size_t n, uint8_t *out);
+//decompresses a block into exactly rawSize bytes; returns false if the
+//block is corrupt
+bool lzDecompress(const uint8_t *in, size_t n, uint8_t *out, size_t rawSize);
+}
+
+#endif
@@ -0,0 +1,185 @@
+/****************************************************************************
+*	 DRAMSim2: A Cycle Accurate DRAM simulator 
+*	 
+*	 Copyright (C) 2010   	Elliott Cooper-Balis
+*									Paul Rosenfeld 
+*									Bruce Jacob
+*									University of Maryland
+*
+*	 This program is free software: you can redistribute it and/or modify
+*	 it under the terms of the GNU General Public License as published by
+*	 the Free Software Foundation, either version 3 of the License, or
+*	 (at your option) any later version.
+*
+*	 This program is distributed in the hope that it will be useful,
+*	 but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	 MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	 GNU General Public License for more details.
+*
+*	 You should have received a copy of the GNU General Public License
+*	 along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*****************************************************************************/
+
+
+
+//LatencyBreakdown.cpp
+//
+//Class file for the per-stage latency histograms and the sampled latency log
+//
+
+#include "LatencyBreakdown.h"
+#include "Transaction.h"
+#include <cstring>
+
+using namespace DRAMSim;
+using namespace std;
+
+const char *DRAMSim::latencyStageNames[LATENCY_STAGES] =
+{
+	"admission", "transaction_queue", "command_queue", "activate", "column", "data"
+};
+
+void LatencyBreakdown::stages(uint64_t issued, uint64_t added, const LatencyStamps &stamps, uint64_t completed,
+                              uint64_t stageCycles[LATENCY_STAGES])
+{
+	stageCycles[STAGE_ADMISSION] = (issued == TRANSACTION_NOT_ISSUED || issued > added) ? 0 : added - issued;
+	stageCycles[STAGE_TRANSACTION_QUEUE] = stamps.enqueued - added;
+	//an ACT from before the split opened the row for somebody else: a row hit
+	if (stamps.activated > stamps.enqueued)
+	{
+		stageCycles[STAGE_COMMAND_QUEUE] = stamps.activated - stamps.enqueued;
+		stageCycles[STAGE_ACTIVATE] = stamps.column - stamps.activated;
+	}
+	else
+	{
+		stageCycles[STAGE_COMMAND_QUEUE] = stamps.column - stamps.enqueued;
+		stageCycles[STAGE_ACTIVATE] = 0;
+	}
+	stageCycles[STAGE_COLUMN] = stamps.data - stamps.column;
+	stageCycles[STAGE_DATA] = completed - stamps.data;
+}
+
+void LatencyBreakdown::record(bool isWrite, const uint64_t stageCycles[LATENCY_STAGES])
+{
+	LatencyHistogram *histograms = isWrite ? writes : reads;
+	for (size_t s=0; s<LATENCY_STAGES; s++)
+	{
+		histograms[s].record(stageCycles[s]);
+	}
+}
+
+LatencyLogWriter::LatencyLogWriter(const string &filename, unsigned systemID) :
+		out(NULL),
+		completions(0)
+{
+	out = fopen(filename.c_str(), "wb");
+	if (out == NULL)
+	{
+		ERROR("== Error - Could not open latency log '"<<filename<<"'");
+		exit(0);
+	}
+	buffer.reserve(LATENCY_LOG_BUFFER_BYTES / sizeof(LatencyLogRecord));
+
+	LatencyLogHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, LATENCY_LOG_MAGIC, sizeof(header.magic));
+	header.version = LATENCY_LOG_VERSION;
+	header.systemID = systemID;
+	header.samplePeriod = LATENCY_LOG_SAMPLE_PERIOD;
+	header.tCK = tCK;
+	if (fwrite(&header, sizeof(header), 1, out) != 1)
+	{
+		ERROR("== Error - Could not write latency log '"<<filename<<"'");
+		exit(0);
+	}
+}
+
+LatencyLogWriter::~LatencyLogWriter()
+{
+	close();
+}
+
+void LatencyLogWriter::write(const LatencyLogRecord &record)
+{
+	if (out == NULL)
+	{
+		return;
+	}
+	buffer.push_back(record);
+	if (buffer.size() == buffer.capacity())
+	{
+		flush();
+	}
+}
+
+void LatencyLogWriter::flush()
+{
+	if (out == NULL)
+	{
+		return;
+	}
+	if (!buffer.empty() && fwrite(&buffer[0], sizeof(LatencyLogRecord), buffer.size(), out) != buffer.size())
+	{
+		ERROR("== Error - Could not write the latency log");
+		exit(0);
+	}
+	buffer.clear();
+	fflush(out);
+}
+
+void LatencyLogWriter::close()
+{
+	if (out == NULL)
+	{
+		return;
+	}
+	flush();
+	fclose(out);
+	out = NULL;
+}
+
+bool LatencyLogReader::isLatencyLog(const string &filename)
+{
+	char magic[8];
+	FILE *f = fopen(filename.c_str(), "rb");
+	if (f == NULL)
+	{
+		return false;
+	}
+	bool isLog = fread(magic, 1, sizeof(magic), f) == sizeof(magic) &&
+	             memcmp(magic, LATENCY_LOG_MAGIC, sizeof(magic)) == 0;
+	fclose(f);
+	return isLog;
+}
+
+LatencyLogReader::LatencyLogReader(const string &filename) :
+		in(NULL)
+{
+	in = fopen(filename.c_str(), "rb");
+	if (in == NULL)
+	{
+		ERROR("== Error - Could not open latency log '"<<filename<<"'");
+		exit(0);
+	}
+	if (fread(&header, sizeof(header), 1, in) != 1 || memcmp(header.magic, LATENCY_LOG_MAGIC, sizeof(header.magic)) != 0)
+	{
+		ERROR("== Error - '"<<filename<<"' is not a latency log");
+		exit(0);
+	}
+	if (header.version != LATENCY_LOG_VERSION)
+	{
+		ERROR("== Error - Latency log '"<<filename<<"' has version "<<header.version<<", expected "<<LATENCY_LOG_VERSION);
+		exit(0);
+	}
+}
+
+LatencyLogReader::~LatencyLogReader()
+{
+	fclose(in);
+}
+
+bool LatencyLogReader::next(LatencyLogRecord &record)
+{
+	return fread(&record, sizeof(record), 1, in) == 1;
+}
@@ -0,0 +1,159 @@
+/****************************************************************************
+*	 DRAMSim2: A Cycle Accurate DRAM simulator 
+*	 
+*	 Copyright (C) 2010   	Elliott Cooper-Balis
+*									Paul Rosenfeld 
+*									Bruce Jacob
+*									University of Maryland
+*
+*	 This program is free software: you can redistribute it and/or modify
+*	 it under the terms of the GNU General Public License as published by
+*	 the Free Software Foundation, either version 3 of the License, or
+*	 (at your option) any later version.
+*
+*	 This program is distributed in the hope that it will be useful,
+*	 but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	 MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	 GNU General Public License for more details.
+*
+*	 You should have received a copy of the GNU General Public License
+*	 along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*****************************************************************************/
+
+#ifndef LATENCYBREAKDOWN_H
+#define LATENCYBREAKDOWN_H
+
+//LatencyBreakdown.h
+//
+//Where the latency of a transaction goes. The memory controller stamps a
+//transaction when it is split into the command queue, when its column
+//command issues (along with the ACT that opened the row, if that happened
+//after the split), and when its data starts on the bus; the stamps travel
+//with its bus packets. Together with the cycles it was issued, admitted to
+//the transaction queue and completed, they split its latency into the
+//stages below. Each stage has a histogram for reads and one for writes,
+//printed with the final statistics.
+//
+//With LATENCY_LOG_OUTPUT set, every LATENCY_LOG_SAMPLE_PERIOD-th completed
+//transaction is also written to a binary .lat file next to the vis file: a
+//LatencyLogHeader and then one LatencyLogRecord per transaction, in host
+//byte order. dramsim-statsconv turns it into CSV.
+//
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "LatencyHistogram.h"
+
+#define LATENCY_LOG_MAGIC "DSIMLAT1"
+#define LATENCY_LOG_VERSION 1
+#define LATENCY_LOG_SAMPLE_PERIOD 16
+
+// records are collected in memory and written out in blocks of about this size
+#define LATENCY_LOG_BUFFER_BYTES (1<<20)
+
+namespace DRAMSim
+{
+
+enum LatencyStage
+{
+	STAGE_ADMISSION,	// offered to the memory system until admitted to the transaction queue
+	STAGE_TRANSACTION_QUEUE,	// until split into the command queue
+	STAGE_COMMAND_QUEUE,	// until its ACT issues, or its column command on a row hit
+	STAGE_ACTIVATE,	// ACT to column command
+	STAGE_COLUMN,	// column command to the first cycle on the data bus
+	STAGE_DATA,	// data burst, and for reads the wait to be returned
+	LATENCY_STAGES
+};
+
+extern const char *latencyStageNames[LATENCY_STAGES];
+
+//carried by Transaction and BusPacket; 0 until the stage is reached
+struct LatencyStamps
+{
+	LatencyStamps() : enqueued(0), activated(0), column(0), data(0) {}
+
+	uint64_t enqueued;
+	uint64_t activated;	// last ACT to the bank before the column command
+	uint64_t column;
+	uint64_t data;
+};
+
+class LatencyBreakdown
+{
+public:
+	//the cycles spent in each stage
+	static void stages(uint64_t issued, uint64_t added, const LatencyStamps &stamps, uint64_t completed,
+	                   uint64_t stageCycles[LATENCY_STAGES]);
+
+	void record(bool isWrite, const uint64_t stageCycles[LATENCY_STAGES]);
+	const LatencyHistogram &Stage(bool isWrite, unsigned stage) const { return isWrite ? writes[stage] : reads[stage]; }
+
+private:
+	LatencyHistogram reads[LATENCY_STAGES];
+	LatencyHistogram writes[LATENCY_STAGES];
+};
+
+struct LatencyLogHeader
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t systemID;
+	uint32_t samplePeriod;
+	float tCK;
+};
+
+struct LatencyLogRecord
+{
+	uint64_t id;
+	uint64_t address;
+	uint64_t issued;
+	uint64_t added;
+	uint64_t completed;
+	uint64_t stageCycles[LATENCY_STAGES];
+	uint32_t isWrite;
+	uint32_t sourceID;
+	uint32_t rank;
+	uint32_t bank;
+};
+
+class LatencyLogWriter
+{
+public:
+	LatencyLogWriter(const std::string &filename, unsigned systemID);
+	virtual ~LatencyLogWriter();
+
+	//true for the completions that go into the log
+	bool sampleNext() { return (completions++ % LATENCY_LOG_SAMPLE_PERIOD) == 0; }
+	void write(const LatencyLogRecord &record);
+	void flush();
+	void close();
+
+private:
+	FILE *out;
+	std::vector<LatencyLogRecord> buffer;
+	uint64_t completions;
+};
+
+class LatencyLogReader
+{
+public:
+	LatencyLogReader(const std::string &filename);
+	virtual ~LatencyLogReader();
+	bool next(LatencyLogRecord &record);
+
+	const LatencyLogHeader &Header() const { return header; }
+
+	static bool isLatencyLog(const std::string &filename);
+
+private:
+	FILE *in;
+	LatencyLogHeader header;
+};
+
+}
+
+#endif
+
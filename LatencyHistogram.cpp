@@ -0,0 +1,125 @@
+/****************************************************************************
+*	 DRAMSim2: A Cycle Accurate DRAM simulator 
+*	 
+*	 Copyright (C) 2010   	Elliott Cooper-Balis
+*									Paul Rosenfeld 
+*									Bruce Jacob
+*									University of Maryland
+*
+*	 This program is free software: you can redistribute it and/or modify
+*	 it under the terms of the GNU General Public License as published by
+*	 the Free Software Foundation, either version 3 of the License, or
+*	 (at your option) any later version.
+*
+*	 This program is distributed in the hope that it will be useful,
+*	 but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	 MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	 GNU General Public License for more details.
+*
+*	 You should have received a copy of the GNU General Public License
+*	 along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*****************************************************************************/
+
+
+
+//LatencyHistogram.cpp
+//
+//Class file for the log-linear latency histogram
+//
+
+#include "LatencyHistogram.h"
+#include <cmath>
+
+using namespace DRAMSim;
+
+LatencyHistogram::LatencyHistogram() :
+		counts(bucketIndex(HISTOGRAM_MAX_VALUE)+1, 0),
+		total(0),
+		sum(0),
+		maxValue(0)
+{
+}
+
+void LatencyHistogram::recordBucket(size_t bucket, uint64_t n)
+{
+	if (n == 0)
+	{
+		return;
+	}
+	counts[bucket] += n;
+	total += n;
+	sum += bucketLow(bucket) * n;
+	if (bucketLow(bucket) > maxValue)
+	{
+		maxValue = bucketLow(bucket);
+	}
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other)
+{
+	for (size_t i=0; i<counts.size(); i++)
+	{
+		counts[i] += other.counts[i];
+	}
+	total += other.total;
+	sum += other.sum;
+	if (other.maxValue > maxValue)
+	{
+		maxValue = other.maxValue;
+	}
+}
+
+void LatencyHistogram::reset()
+{
+	counts.assign(counts.size(), 0);
+	total = 0;
+	sum = 0;
+	maxValue = 0;
+}
+
+uint64_t LatencyHistogram::percentile(double fraction) const
+{
+	if (total == 0)
+	{
+		return 0;
+	}
+	//nearest rank: the value below which ceil(fraction*N) samples fall
+	uint64_t rank = (uint64_t)ceil(fraction * total);
+	if (rank == 0)
+	{
+		rank = 1;
+	}
+	uint64_t seen = 0;
+	for (size_t i=0; i<counts.size(); i++)
+	{
+		seen += counts[i];
+		if (seen >= rank)
+		{
+			uint64_t high = bucketHigh(i);
+			return high < maxValue ? high : maxValue;
+		}
+	}
+	return maxValue;
+}
+
+uint64_t LatencyHistogram::bucketLow(size_t i)
+{
+	if (i < (2U << HISTOGRAM_SUB_BUCKET_BITS))
+	{
+		return i;
+	}
+	unsigned shift = (i >> HISTOGRAM_SUB_BUCKET_BITS) - 1;
+	uint64_t subBucket = i - ((uint64_t)shift << HISTOGRAM_SUB_BUCKET_BITS);
+	return subBucket << shift;
+}
+
+uint64_t LatencyHistogram::bucketHigh(size_t i)
+{
+	if (i < (2U << HISTOGRAM_SUB_BUCKET_BITS))
+	{
+		return i;
+	}
+	unsigned shift = (i >> HISTOGRAM_SUB_BUCKET_BITS) - 1;
+	return bucketLow(i) + (1ULL << shift) - 1;
+}
@@ -0,0 +1,98 @@
+/****************************************************************************
+*	 DRAMSim2: A Cycle Accurate DRAM simulator 
+*	 
+*	 Copyright (C) 2010   	Elliott Cooper-Balis
+*									Paul Rosenfeld 
+*									Bruce Jacob
+*									University of Maryland
+*
+*	 This program is free software: you can redistribute it and/or modify
+*	 it under the terms of the GNU General Public License as published by
+*	 the Free Software Foundation, either version 3 of the License, or
+*	 (at your option) any later version.
+*
+*	 This program is distributed in the hope that it will be useful,
+*	 but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	 MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	 GNU General Public License for more details.
+*
+*	 You should have received a copy of the GNU General Public License
+*	 along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*****************************************************************************/
+
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+//LatencyHistogram.h
+//
+//Log-linear latency histogram in a flat array. Values below
+//2^(HISTOGRAM_SUB_BUCKET_BITS+1) get a bucket each; above that, every power
+//of two is split into 2^HISTOGRAM_SUB_BUCKET_BITS equal buckets, so a value
+//is never off by more than 1/2^HISTOGRAM_SUB_BUCKET_BITS of itself.
+//Histograms of different banks, ranks or channels can be merged.
+//
+
+#include <vector>
+#include <stdint.h>
+#include "SystemConfiguration.h"
+
+namespace DRAMSim
+{
+class LatencyHistogram
+{
+public:
+	LatencyHistogram();
+
+	void record(uint64_t value)
+	{
+		if (value > HISTOGRAM_MAX_VALUE)
+		{
+			value = HISTOGRAM_MAX_VALUE;
+		}
+		counts[bucketIndex(value)]++;
+		total++;
+		sum += value;
+		if (value > maxValue)
+		{
+			maxValue = value;
+		}
+	}
+	//adds n values to one bucket, for histograms read back from their
+	//bucket counts; they count as the bucket's lower bound in Mean() and Max()
+	void recordBucket(size_t bucket, uint64_t n);
+	void merge(const LatencyHistogram &other);
+	void reset();
+
+	uint64_t Count() const { return total; }
+	uint64_t Max() const { return maxValue; }
+	double Mean() const { return total ? (double)sum / total : 0.0; }
+	//smallest value that covers the given fraction (0..1) of the recorded
+	//values, rounded up to the top of its bucket
+	uint64_t percentile(double fraction) const;
+
+	//for walking the non-empty buckets
+	size_t NumBuckets() const { return counts.size(); }
+	uint64_t BucketCount(size_t i) const { return counts[i]; }
+	static uint64_t bucketLow(size_t i);
+	static uint64_t bucketHigh(size_t i);
+
+private:
+	static size_t bucketIndex(uint64_t value)
+	{
+		if (value < (2ULL << HISTOGRAM_SUB_BUCKET_BITS))
+		{
+			return value;
+		}
+		unsigned shift = 63 - __builtin_clzll(value) - HISTOGRAM_SUB_BUCKET_BITS;
+		return ((size_t)shift << HISTOGRAM_SUB_BUCKET_BITS) + (value >> shift);
+	}
+
+	std::vector<uint64_t> counts;
+	uint64_t total;
+	uint64_t sum;
+	uint64_t maxValue;
+};
+}
+
+#endif
@@ -0,0 +1,344 @@
+/****************************************************************************
+*	 DRAMSim2: A Cycle Accurate DRAM simulator 
+*	 
+*	 Copyright (C) 2010   	Elliott Cooper-Balis
+*									Paul Rosenfeld 
+*									Bruce Jacob
+*									University of Maryland
+*
+*	 This program is free software: you can redistribute it and/or modify
+*	 it under the terms of the GNU General Public License as published by
+*	 the Free Software Foundation, either version 3 of the License, or
+*	 (at your option) any later version.
+*
+*	 This program is distributed in the hope that it will be useful,
+*	 but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	 MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	 GNU General Public License for more details.
+*
+*	 You should have received a copy of the GNU General Public License
+*	 along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*****************************************************************************/
+
+//LoadLatency.cpp
+//
+//Sweeps the injection rate of a traffic generator (see TrafficGenerator.h)
+//in the style of Intel MLC's loaded latency test and writes a bandwidth
+//versus read latency curve as CSV, one row per rate point. Every point runs
+//a warmup phase and is then measured over a fixed number of cycles; the
+//sweep stops once bandwidth no longer grows with the offered rate.
+//
+//The device and system parameters are process-wide globals, so each rate
+//point is simulated in a child process of its own, several at a time.
+//
+
+#include <iostream>
+#include <fstream>
+#include <getopt.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <cstring>
+
+#include "SystemConfiguration.h"
+#include "MemorySystem.h"
+#include "TrafficGenerator.h"
+
+using namespace DRAMSim;
+using namespace std;
+
+struct LoadLatencyPoint
+{
+	double offeredRate;		// requests/cycle
+	double acceptedRate;
+	double bandwidth;		// GB/s
+	double meanLatency;		// ns
+	double p50Latency;
+	double p99Latency;
+	uint64_t reads;
+	bool valid;
+};
+
+void usage()
+{
+	cout << "dramsim-loadlat Usage: " << endl;
+	cout << "dramsim-loadlat -d ini/device.ini [-d ini/other.ini ...] [-s system.ini] [options]" <<endl;
+	cout << "\t-d, --deviceini=FILENAME \tdevice to sweep; may be given several times"<<endl;
+	cout << "\t-s, --systemini=FILENAME \tmemory system parameters [default=system.ini]"<<endl;
+	cout << "\t-p, --pwd=DIRECTORY\t\tdirectory the ini files are relative to"<<endl;
+	cout << "\t-g, --generator=SPEC \t\ttraffic pattern, as for DRAMSim -g; its rate is swept [default=uniform,reads=0.67,outstanding=256]"<<endl;
+	cout << "\t-r, --minrate=# \t\tfirst rate point in requests/cycle [default=0.02]"<<endl;
+	cout << "\t-R, --maxrate=# \t\tlast rate point [default=1]"<<endl;
+	cout << "\t-i, --increment=# \t\tstep between rate points [default=0.02]"<<endl;
+	cout << "\t-w, --warmup=# \t\t\tcycles simulated before measuring [default=20000]"<<endl;
+	cout << "\t-c, --numcycles=# \t\tcycles measured per point [default=100000]"<<endl;
+	cout << "\t-t, --threshold=# \t\tsaturated once bandwidth grows less than #% per step [default=1]"<<endl;
+	cout << "\t-j, --jobs=# \t\t\trate points simulated in parallel [default=number of cpus]"<<endl;
+	cout << "\t-m, --size=# \t\t\tsize of the memory system in megabytes [default=2048]"<<endl;
+	cout << "\t-o, --output=FILENAME \t\tCSV output [default=stdout]"<<endl;
+}
+
+//simulates one rate point; runs in a child process
+LoadLatencyPoint runPoint(const string &deviceIni, const string &systemIni, const string &pwd, unsigned megsOfMemory,
+                          TrafficGeneratorConfig config, uint64_t warmupCycles, uint64_t measureCycles)
+{
+	LoadLatencyPoint point;
+	memset(&point, 0, sizeof(point));
+	point.offeredRate = config.rate;
+
+	MemorySystem *memorySystem = new MemorySystem(0, deviceIni, systemIni, pwd, "loadlat", megsOfMemory);
+	TrafficGenerator *generator = new TrafficGenerator(memorySystem, config);
+
+	for (uint64_t i=0; i<warmupCycles; i++)
+	{
+		generator->update();
+		memorySystem->update();
+	}
+	generator->startMeasurement();
+	for (uint64_t i=0; i<measureCycles; i++)
+	{
+		generator->update();
+		memorySystem->update();
+	}
+
+	double bytesPerTransaction = (JEDEC_DATA_BUS_BITS/8)*BL;
+	double seconds = generator->MeasuredCycles() * tCK * 1E-9;
+	point.acceptedRate = (double)generator->MeasuredIssued() / generator->MeasuredCycles();
+	point.bandwidth = generator->MeasuredCompleted() * bytesPerTransaction / (1024.0*1024.0*1024.0) / seconds;
+	point.meanLatency = generator->MeanReadLatency() * tCK;
+	point.p50Latency = generator->ReadLatencyPercentile(0.50) * tCK;
+	point.p99Latency = generator->ReadLatencyPercentile(0.99) * tCK;
+	point.reads = generator->MeasuredReads();
+	point.valid = true;
+
+	delete generator;
+	delete memorySystem;
+	return point;
+}
+
+//runs rates[first..last) in parallel child processes
+void runBatch(const vector<double> &rates, size_t first, size_t last, vector<LoadLatencyPoint> &points,
+              const string &deviceIni, const string &systemIni, const string &pwd, unsigned megsOfMemory,
+              const TrafficGeneratorConfig &baseConfig, uint64_t warmupCycles, uint64_t measureCycles)
+{
+	vector<pid_t> children;
+	vector<int> pipes;
+	for (size_t i=first; i<last; i++)
+	{
+		int fds[2];
+		if (pipe(fds) != 0)
+		{
+			ERROR("== Error - could not create a pipe");
+			exit(-1);
+		}
+		cout.flush();
+		pid_t pid = fork();
+		if (pid < 0)
+		{
+			ERROR("== Error - could not fork a worker");
+			exit(-1);
+		}
+		if (pid == 0)
+		{
+			close(fds[0]);
+			//the CSV may be going to stdout, keep the model's banners out of it
+			int devNull = open("/dev/null", O_WRONLY);
+			if (devNull >= 0)
+			{
+				dup2(devNull, STDOUT_FILENO);
+				close(devNull);
+			}
+			TrafficGeneratorConfig config = baseConfig;
+			config.rate = rates[i];
+			LoadLatencyPoint point = runPoint(deviceIni, systemIni, pwd, megsOfMemory, config, warmupCycles, measureCycles);
+			ssize_t written = write(fds[1], &point, sizeof(point));
+			_exit(written == sizeof(point) ? 0 : 1);
+		}
+		close(fds[1]);
+		children.push_back(pid);
+		pipes.push_back(fds[0]);
+	}
+
+	for (size_t i=first; i<last; i++)
+	{
+		LoadLatencyPoint &point = points[i];
+		if (read(pipes[i-first], &point, sizeof(point)) != sizeof(point))
+		{
+			memset(&point, 0, sizeof(point));
+			point.offeredRate = rates[i];
+		}
+		close(pipes[i-first]);
+		int status;
+		waitpid(children[i-first], &status, 0);
+		if (!point.valid)
+		{
+			ERROR("== Rate point "<<rates[i]<<" for '"<<deviceIni<<"' failed");
+		}
+	}
+}
+
+int main(int argc, char **argv)
+{
+	vector<string> deviceInis;
+	string systemIni = "system.ini";
+	string pwd = "";
+	string generatorSpec = "uniform,reads=0.67,outstanding=256";
+	string outputFilename = "";
+	double minRate = 0.02, maxRate = 1.0, increment = 0.02;
+	double threshold = 1.0;
+	uint64_t warmupCycles = 20000, measureCycles = 100000;
+	long jobs = sysconf(_SC_NPROCESSORS_ONLN);
+	unsigned megsOfMemory = 2048;
+
+	while (1)
+	{
+		static struct option long_options[] =
+		{
+			{"deviceini", required_argument, 0, 'd'},
+			{"systemini", required_argument, 0, 's'},
+			{"pwd", required_argument, 0, 'p'},
+			{"generator", required_argument, 0, 'g'},
+			{"minrate", required_argument, 0, 'r'},
+			{"maxrate", required_argument, 0, 'R'},
+			{"increment", required_argument, 0, 'i'},
+			{"warmup", required_argument, 0, 'w'},
+			{"numcycles", required_argument, 0, 'c'},
+			{"threshold", required_argument, 0, 't'},
+			{"jobs", required_argument, 0, 'j'},
+			{"size", required_argument, 0, 'm'},
+			{"output", required_argument, 0, 'o'},
+			{"help", no_argument, 0, 'h'},
+			{0, 0, 0, 0}
+		};
+		int option_index=0;
+		int c = getopt_long(argc, argv, "d:s:p:g:r:R:i:w:c:t:j:m:o:h", long_options, &option_index);
+		if (c == -1)
+		{
+			break;
+		}
+		switch (c)
+		{
+		case 'd':
+			deviceInis.push_back(optarg);
+			break;
+		case 's':
+			systemIni = optarg;
+			break;
+		case 'p':
+			pwd = optarg;
+			break;
+		case 'g':
+			generatorSpec = optarg;
+			break;
+		case 'r':
+			minRate = atof(optarg);
+			break;
+		case 'R':
+			maxRate = atof(optarg);
+			break;
+		case 'i':
+			increment = atof(optarg);
+			break;
+		case 'w':
+			warmupCycles = strtoull(optarg, NULL, 10);
+			break;
+		case 'c':
+			measureCycles = strtoull(optarg, NULL, 10);
+			break;
+		case 't':
+			threshold = atof(optarg);
+			break;
+		case 'j':
+			jobs = atoi(optarg);
+			break;
+		case 'm':
+			megsOfMemory = atoi(optarg);
+			break;
+		case 'o':
+			outputFilename = optarg;
+			break;
+		case 'h':
+			usage();
+			exit(0);
+		default:
+			usage();
+			exit(-1);
+		}
+	}
+
+	if (deviceInis.size() == 0)
+	{
+		ERROR("Please provide at least one device ini file");
+		usage();
+		exit(-1);
+	}
+	if (minRate <= 0 || increment <= 0 || maxRate < minRate || measureCycles == 0)
+	{
+		ERROR("== Rates must be positive, with minrate <= maxrate, and numcycles > 0");
+		exit(-1);
+	}
+	if (jobs < 1)
+	{
+		jobs = 1;
+	}
+
+	SHOW_SIM_OUTPUT = 0;
+	MemorySystem::disableSideOutputs();
+	TrafficGeneratorConfig baseConfig = TrafficGenerator::parseSpec(generatorSpec);
+
+	vector<double> rates;
+	for (unsigned i=0; minRate + i*increment <= maxRate + increment*1E-6; i++)
+	{
+		rates.push_back(minRate + i*increment);
+	}
+
+	ofstream outputFile;
+	if (outputFilename.length() > 0)
+	{
+		outputFile.open(outputFilename.c_str());
+		if (!outputFile)
+		{
+			ERROR("== Error - could not open output file '"<<outputFilename<<"'");
+			exit(-1);
+		}
+	}
+	ostream &csv = outputFilename.length() > 0 ? outputFile : cout;
+	csv << "device,offered_rate,accepted_rate,bandwidth_GBps,mean_latency_ns,p50_latency_ns,p99_latency_ns,reads,saturated" << endl;
+
+	for (size_t d=0; d<deviceInis.size(); d++)
+	{
+		vector<LoadLatencyPoint> points(rates.size());
+		bool saturated = false;
+		double lastBandwidth = 0;
+		size_t done = 0;
+
+		while (!saturated && done < rates.size())
+		{
+			size_t last = done + jobs < rates.size() ? done + jobs : rates.size();
+			runBatch(rates, done, last, points, deviceInis[d], systemIni, pwd, megsOfMemory,
+			         baseConfig, warmupCycles, measureCycles);
+
+			//points are judged in order, so the curve doesn't depend on -j
+			for (; done < last && !saturated; done++)
+			{
+				LoadLatencyPoint &point = points[done];
+				if (!point.valid)
+				{
+					continue;
+				}
+				saturated = done > 0 && point.bandwidth < lastBandwidth * (1.0 + threshold / 100.0);
+				lastBandwidth = point.bandwidth > lastBandwidth ? point.bandwidth : lastBandwidth;
+
+				csv << deviceInis[d] << "," << point.offeredRate << "," << point.acceptedRate << "," << point.bandwidth
+				    << "," << point.meanLatency << "," << point.p50Latency << "," << point.p99Latency
+				    << "," << point.reads << "," << (saturated ? 1 : 0) << endl;
+			}
+		}
+		if (!saturated)
+		{
+			ERROR("== '"<<deviceInis[d]<<"' did not saturate by rate "<<maxRate<<", raise --maxrate");
+		}
+	}
+	return 0;
+}
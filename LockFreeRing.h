@@ -0,0 +1,256 @@
+/****************************************************************************
+*	 DRAMSim2: A Cycle Accurate DRAM simulator 
+*	 
+*	 Copyright (C) 2010   	Elliott Cooper-Balis
+*									Paul Rosenfeld 
+*									Bruce Jacob
+*									University of Maryland
+*
+*	 This program is free software: you can redistribute it and/or modify
+*	 it under the terms of the GNU General Public License as published by
+*	 the Free Software Foundation, either version 3 of the License, or
+*	 (at your option) any later version.
+*
+*	 This program is distributed in the hope that it will be useful,
+*	 but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	 MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	 GNU General Public License for more details.
+*
+*	 You should have received a copy of the GNU General Public License
+*	 along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*****************************************************************************/
+#ifndef LOCKFREERING_H
+#define LOCKFREERING_H
+
+//LockFreeRing.h
+//
+//Bounded lock-free ring buffer used to hand transactions and completions
+//between host threads and the memory system without a mutex.
+//
+//Every slot carries a sequence number (D. Vyukov's bounded queue), so any
+//number of threads may push and any number may pop concurrently; the
+//memory system uses one ring with many producers (submissions) and one
+//with many consumers (completions). push()/pop() never block, they return
+//false when the ring is full/empty.
+//
+//SPSCRing is the cheaper variant for exactly one producer thread and one
+//consumer thread: no compare-and-swap, and each side caches the other's
+//index so it only touches the shared line when the ring looks full/empty.
+//
+
+#include <stdint.h>
+#include <cstdlib>
+
+namespace DRAMSim
+{
+
+#define RING_CACHE_LINE 64
+
+template <typename T>
+class LockFreeRing
+{
+public:
+	//capacity is rounded up to a power of two
+	LockFreeRing(unsigned capacity) :
+		head(0),
+		tail(0)
+	{
+		size = 2;
+		while (size < capacity)
+		{
+			size <<= 1;
+		}
+		mask = size - 1;
+		slots = new Slot[size];
+		for (uint64_t i=0;i<size;i++)
+		{
+			slots[i].sequence = i;
+		}
+	}
+
+	~LockFreeRing()
+	{
+		delete [] slots;
+	}
+
+	bool push(const T &item)
+	{
+		uint64_t pos = __atomic_load_n(&tail, __ATOMIC_RELAXED);
+		for (;;)
+		{
+			Slot &s = slots[pos & mask];
+			uint64_t seq = __atomic_load_n(&s.sequence, __ATOMIC_ACQUIRE);
+			int64_t diff = (int64_t)seq - (int64_t)pos;
+			if (diff == 0)
+			{
+				if (__atomic_compare_exchange_n(&tail, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+				{
+					s.item = item;
+					__atomic_store_n(&s.sequence, pos + 1, __ATOMIC_RELEASE);
+					return true;
+				}
+				//pos was reloaded by the failed exchange
+			}
+			else if (diff < 0)
+			{
+				return false; //full
+			}
+			else
+			{
+				pos = __atomic_load_n(&tail, __ATOMIC_RELAXED);
+			}
+		}
+	}
+
+	bool pop(T &item)
+	{
+		uint64_t pos = __atomic_load_n(&head, __ATOMIC_RELAXED);
+		for (;;)
+		{
+			Slot &s = slots[pos & mask];
+			uint64_t seq = __atomic_load_n(&s.sequence, __ATOMIC_ACQUIRE);
+			int64_t diff = (int64_t)seq - (int64_t)(pos + 1);
+			if (diff == 0)
+			{
+				if (__atomic_compare_exchange_n(&head, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+				{
+					item = s.item;
+					__atomic_store_n(&s.sequence, pos + mask + 1, __ATOMIC_RELEASE);
+					return true;
+				}
+			}
+			else if (diff < 0)
+			{
+				return false; //empty
+			}
+			else
+			{
+				pos = __atomic_load_n(&head, __ATOMIC_RELAXED);
+			}
+		}
+	}
+
+	//only a snapshot when other threads are active
+	bool empty() const
+	{
+		return __atomic_load_n(&head, __ATOMIC_ACQUIRE) == __atomic_load_n(&tail, __ATOMIC_ACQUIRE);
+	}
+
+	uint64_t capacity() const
+	{
+		return size;
+	}
+
+private:
+	struct Slot
+	{
+		uint64_t sequence;
+		T item;
+	};
+
+	//keep the two indices on separate cache lines so producers and
+	//consumers don't bounce the same line back and forth
+	uint64_t head __attribute__((aligned(RING_CACHE_LINE)));
+	char pad0[RING_CACHE_LINE - sizeof(uint64_t)];
+	uint64_t tail __attribute__((aligned(RING_CACHE_LINE)));
+	char pad1[RING_CACHE_LINE - sizeof(uint64_t)];
+
+	Slot *slots;
+	uint64_t size;
+	uint64_t mask;
+
+	//not copyable
+	LockFreeRing(const LockFreeRing &);
+	LockFreeRing &operator=(const LockFreeRing &);
+};
+
+template <typename T>
+class SPSCRing
+{
+public:
+	//capacity is rounded up to a power of two
+	SPSCRing(unsigned capacity) :
+		head(0),
+		cachedTail(0),
+		tail(0),
+		cachedHead(0)
+	{
+		size = 2;
+		while (size < capacity)
+		{
+			size <<= 1;
+		}
+		mask = size - 1;
+		items = new T[size];
+	}
+
+	~SPSCRing()
+	{
+		delete [] items;
+	}
+
+	//producer thread only
+	bool push(const T &item)
+	{
+		if (tail - cachedHead == size)
+		{
+			cachedHead = __atomic_load_n(&head, __ATOMIC_ACQUIRE);
+			if (tail - cachedHead == size)
+			{
+				return false; //full
+			}
+		}
+		items[tail & mask] = item;
+		__atomic_store_n(&tail, tail + 1, __ATOMIC_RELEASE);
+		return true;
+	}
+
+	//consumer thread only
+	bool pop(T &item)
+	{
+		if (head == cachedTail)
+		{
+			cachedTail = __atomic_load_n(&tail, __ATOMIC_ACQUIRE);
+			if (head == cachedTail)
+			{
+				return false; //empty
+			}
+		}
+		item = items[head & mask];
+		__atomic_store_n(&head, head + 1, __ATOMIC_RELEASE);
+		return true;
+	}
+
+	//only a snapshot when the other thread is active
+	uint64_t count() const
+	{
+		return __atomic_load_n(&tail, __ATOMIC_ACQUIRE) - __atomic_load_n(&head, __ATOMIC_ACQUIRE);
+	}
+
+	uint64_t capacity() const
+	{
+		return size;
+	}
+
+private:
+	//each index shares a line with the copy of the other index its owner caches
+	uint64_t head __attribute__((aligned(RING_CACHE_LINE)));	// written by the consumer
+	uint64_t cachedTail;
+	char pad0[RING_CACHE_LINE - 2*sizeof(uint64_t)];
+	uint64_t tail __attribute__((aligned(RING_CACHE_LINE)));	// written by the producer
+	uint64_t cachedHead;
+	char pad1[RING_CACHE_LINE - 2*sizeof(uint64_t)];
+
+	T *items;
+	uint64_t size;
+	uint64_t mask;
+
+	//not copyable
+	SPSCRing(const SPSCRing &);
+	SPSCRing &operator=(const SPSCRing &);
+};
+
+}
+
+#endif
@@ -37,6 +37,8 @@ MemoryController::MemoryController(MemorySystem *parent, std::ofstream *outfile)
 		commandQueue (CommandQueue(bankStates)),
 		poppedBusPacket(NULL),
 		totalTransactions(0),
+		totalAdmissionWait(0),
+		totalAdmitted(0),
 		channelBitWidth (dramsim_log2(NUM_CHANS)),
 		rankBitWidth (dramsim_log2(NUM_RANKS)),
 		bankBitWidth (dramsim_log2(NUM_BANKS)),
@@ -70,6 +72,33 @@ MemoryController::MemoryController(MemorySystem *parent, std::ofstream *outfile)
 	totalWritesPerBank = vector<uint64_t>(NUM_RANKS*NUM_BANKS,0);
 	totalReadsPerRank = vector<uint64_t>(NUM_RANKS,0);
 	totalWritesPerRank = vector<uint64_t>(NUM_RANKS,0);
+	lastActivate = vector<uint64_t>(NUM_RANKS*NUM_BANKS,0);
+	previousEpochs.reads = vector<uint64_t>(NUM_RANKS*NUM_BANKS,0);
+	previousEpochs.writes = vector<uint64_t>(NUM_RANKS*NUM_BANKS,0);
+	previousEpochs.readLatency = vector<uint64_t>(NUM_RANKS*NUM_BANKS,0);
+	for (size_t e=0;e<STATS_ENERGY_TYPES;e++)
+	{
+		previousEpochs.energy[e] = vector<uint64_t>(NUM_RANKS,0);
+	}
+
+	for (size_t c=0;c<STATS_ROW_BUFFER_COUNTERS;c++)
+	{
+		rowBufferCounters[c] = vector<uint64_t>(NUM_RANKS*NUM_BANKS,0);
+		previousEpochs.rowBuffer[c] = vector<uint64_t>(NUM_RANKS*NUM_BANKS,0);
+	}
+	for (size_t b=0;b<STATS_BUS_COUNTERS;b++)
+	{
+		busCounters[b] = 0;
+	}
+	for (size_t r=0;r<STATS_RANK_STATES;r++)
+	{
+		rankStateCycles[r] = vector<uint64_t>(NUM_RANKS,0);
+		previousEpochs.rankState[r] = vector<uint64_t>(NUM_RANKS,0);
+	}
+	lastConflictPrecharge = vector<uint64_t>(NUM_RANKS*NUM_BANKS,0);
+	rowUntouched = vector<bool>(NUM_RANKS*NUM_BANKS,false);
+	lastColumnRank = NUM_RANKS;
+	lastColumnWrite = false;
 
 	writeDataCountdown.reserve(NUM_RANKS);
 	writeDataToSend.reserve(NUM_RANKS);
@@ -83,6 +112,20 @@ MemoryController::MemoryController(MemorySystem *parent, std::ofstream *outfile)
 
 	totalEpochLatency = vector<uint64_t> (NUM_RANKS*NUM_BANKS,0);
 
+	readLatencyHistograms = vector<LatencyHistogram>(NUM_RANKS*NUM_BANKS);
+	writeLatencyHistograms = vector<LatencyHistogram>(NUM_RANKS*NUM_BANKS);
+	totalReadLatencyHistograms = vector<LatencyHistogram>(NUM_RANKS*NUM_BANKS);
+	totalWriteLatencyHistograms = vector<LatencyHistogram>(NUM_RANKS*NUM_BANKS);
+	for (size_t r=0;r<STALL_REASONS;r++)
+	{
+		totalStallCycles[r] = vector<uint64_t>(NUM_RANKS*NUM_BANKS,0);
+	}
+	if (ROW_HEAT_OUTPUT)
+	{
+		rowHeat.enable();
+		totalRowHeat.enable();
+	}
+
 	//staggers when each rank is due for a refresh
 	for (size_t i=0;i<NUM_RANKS;i++)
 	{
@@ -100,7 +143,7 @@ void MemoryController::receiveFromBus(BusPacket *bpacket)
 		exit(0);
 	}
 
-	if (DEBUG_BUS)
+	if (TRACE_ON(TRACE_COMMANDS, DEBUG_BUS))
 	{
 		PRINTN(" -- MC Receiving From Data Bus : ");
 		bpacket->print();
@@ -108,6 +151,7 @@ void MemoryController::receiveFromBus(BusPacket *bpacket)
 
 	//add to return read data queue
 	returnTransaction.push_back(Transaction(RETURN_DATA, bpacket->physicalAddress, bpacket->data, bpacket->transID));
+	returnTransaction.back().stamps = bpacket->stamps;
 	totalReadsPerBank[SEQUENTIAL(bpacket->rank,bpacket->bank)]++;
 
 	// this delete statement saves a mindboggling amount of memory
@@ -117,14 +161,7 @@ void MemoryController::receiveFromBus(BusPacket *bpacket)
 //sends read data back to the CPU
 void MemoryController::returnReadData(const Transaction &trans)
 {
-	if (parentMemorySystem->ReturnReadData!=NULL)
-	{
-#if (USE_SCIC_MEMSYS_QUERY == 1)
-		(*parentMemorySystem->ReturnReadData)(parentMemorySystem->systemID, trans.address, currentClockCycle - trans.timeAdded, trans.id);
-#else
-		(*parentMemorySystem->ReturnReadData)(parentMemorySystem->systemID, trans.address, currentClockCycle, trans.id);
-#endif
-	}
+	parentMemorySystem->reportCompletion(false, trans.id, trans.address, trans.timeIssued, currentClockCycle);
 }
 
 //gives the memory controller a handle on the rank objects
@@ -192,17 +229,14 @@ void MemoryController::update()
 		dataCyclesLeft--;
 		if (dataCyclesLeft == 0)
 		{
+			writeLatencyHistograms[SEQUENTIAL(outgoingDataPacket->rank,outgoingDataPacket->bank)].record(
+			    currentClockCycle - outgoingDataPacket->timeAdded);
+			recordLatencyBreakdown(true, outgoingDataPacket->transID, outgoingDataPacket->physicalAddress, outgoingDataPacket->sourceID,
+			                       outgoingDataPacket->timeIssued, outgoingDataPacket->timeAdded, outgoingDataPacket->stamps);
+
 			//inform upper levels that a write is done
-			if (parentMemorySystem->WriteDataDone!=NULL)
-			{
-#if (USE_SCIC_MEMSYS_QUERY ==1 )
-				(*parentMemorySystem->WriteDataDone)(parentMemorySystem->systemID,outgoingDataPacket->physicalAddress, 
-					(outgoingDataPacket->_timeTracker == NULL_SIG64)? NULL_SIG64 : currentClockCycle - outgoingDataPacket->_timeTracker, 
-					outgoingDataPacket->transID);
-#else
-				(*parentMemorySystem->WriteDataDone)(parentMemorySystem->systemID,outgoingDataPacket->physicalAddress, currentClockCycle, outgoingDataPacket->transID);
-#endif
-			}
+			parentMemorySystem->reportCompletion(true, outgoingDataPacket->transID, outgoingDataPacket->physicalAddress,
+			                                     outgoingDataPacket->timeIssued, currentClockCycle);
 
 			(*ranks)[outgoingDataPacket->rank].receiveFromBus(outgoingDataPacket);
 			outgoingDataPacket=NULL;
@@ -225,7 +259,7 @@ void MemoryController::update()
 		if (writeDataCountdown[0]==0)
 		{
 			//send to bus and print debug stuff
-			if (DEBUG_BUS)
+			if (TRACE_ON(TRACE_COMMANDS, DEBUG_BUS))
 			{
 				PRINTN(" -- MC Issuing On Data Bus    : ");
 				writeDataToSend[0]->print();
@@ -239,10 +273,12 @@ void MemoryController::update()
 			}
 
 			outgoingDataPacket = writeDataToSend[0];
+			outgoingDataPacket->stamps.data = currentClockCycle;
 			dataCyclesLeft = BL/2;
 
 			totalTransactions++;
 			totalWritesPerBank[SEQUENTIAL(writeDataToSend[0]->rank,writeDataToSend[0]->bank)]++;
+			totalWritesPerSource[sourceSlot(writeDataToSend[0]->sourceID)]++;
 
 			writeDataCountdown.erase(writeDataCountdown.begin());
 			writeDataToSend.erase(writeDataToSend.begin());
@@ -273,19 +309,61 @@ void MemoryController::update()
 	//function returns true if there is something valid in poppedBusPacket
 	if (commandQueue.pop(&poppedBusPacket))
 	{
+		size_t poppedBank = SEQUENTIAL(poppedBusPacket->rank,poppedBusPacket->bank);
+		busCounters[STATS_COMMAND_BUS_CYCLES]++;
+		if (poppedBusPacket->busPacketType == ACTIVATE)
+		{
+			lastActivate[poppedBank] = currentClockCycle;
+
+			//a conflict if, after this access was queued, a PRE closed the bank's row for a waiting access to another row
+			bool conflict = lastConflictPrecharge[poppedBank] != 0 && lastConflictPrecharge[poppedBank] >= poppedBusPacket->stamps.enqueued;
+			rowBufferCounters[conflict ? STATS_ROW_CONFLICTS : STATS_ROW_MISSES][poppedBank]++;
+			rowBufferCounters[STATS_ACTIVATES][poppedBank]++;
+			rowUntouched[poppedBank] = true;
+		}
+		else if (poppedBusPacket->busPacketType == PRECHARGE)
+		{
+			lastConflictPrecharge[poppedBank] = commandQueue.prechargeForConflict ? currentClockCycle : 0;
+		}
+		else if (poppedBusPacket->busPacketType != REFRESH)
+		{
+			poppedBusPacket->stamps.activated = lastActivate[poppedBank];
+			poppedBusPacket->stamps.column = currentClockCycle;
+
+			//the first access after an ACT was counted with the ACT, the others found their row open
+			if (!rowUntouched[poppedBank])
+			{
+				rowBufferCounters[STATS_ROW_HITS][poppedBank]++;
+			}
+			rowUntouched[poppedBank] = false;
+			rowBufferCounters[STATS_COLUMN_ACCESSES][poppedBank]++;
+
+			bool isWrite = poppedBusPacket->busPacketType == WRITE || poppedBusPacket->busPacketType == WRITE_P;
+			if (lastColumnRank != NUM_RANKS)
+			{
+				if (isWrite != lastColumnWrite)
+				{
+					busCounters[isWrite ? STATS_READ_TO_WRITE : STATS_WRITE_TO_READ]++;
+				}
+				if (poppedBusPacket->rank != lastColumnRank)
+				{
+					busCounters[STATS_RANK_SWITCHES]++;
+				}
+			}
+			lastColumnRank = poppedBusPacket->rank;
+			lastColumnWrite = isWrite;
+			busCounters[STATS_DATA_BUS_CYCLES] += BL/2;
+		}
+
 		if (poppedBusPacket->busPacketType == WRITE || poppedBusPacket->busPacketType == WRITE_P)
 		{
-#if (USE_SCIC_MEMSYS_QUERY == 1)
 			writeDataToSend.push_back(new BusPacket(DATA, poppedBusPacket->physicalAddress, poppedBusPacket->column,
 			                                    poppedBusPacket->row, poppedBusPacket->rank, poppedBusPacket->bank,
-			                                    poppedBusPacket->data, poppedBusPacket->_timeTracker));
-
-#else
-			writeDataToSend.push_back(new BusPacket(DATA, poppedBusPacket->physicalAddress, poppedBusPacket->column,
-				poppedBusPacket->row, poppedBusPacket->rank, poppedBusPacket->bank,
-				poppedBusPacket->data));
-
-#endif
+			                                    poppedBusPacket->data, poppedBusPacket->transID));
+			writeDataToSend.back()->timeIssued = poppedBusPacket->timeIssued;
+			writeDataToSend.back()->timeAdded = poppedBusPacket->timeAdded;
+			writeDataToSend.back()->sourceID = poppedBusPacket->sourceID;
+			writeDataToSend.back()->stamps = poppedBusPacket->stamps;
 			writeDataCountdown.push_back(WL);
 		}
 
@@ -300,24 +378,22 @@ void MemoryController::update()
 			case READ_P:
 			case READ:
 				//add energy to account for total
-				if (DEBUG_POWER)
+				if (TRACE_ON(TRACE_CYCLES, DEBUG_POWER))
 				{
-					PRINT(" ++ Adding Read energy to total energy");
+					PRINT_DEFERRED(line(" ++ Adding Read energy to total energy"), " ++ Adding Read energy to total energy");
 				}
 				burstEnergy[rank] += (IDD4R - IDD3N) * BL/2 * NUM_DEVICES;
 				if (poppedBusPacket->busPacketType == READ_P) 
 				{
 					//Don't bother setting next read or write times because the bank is no longer active
 					//bankStates[rank][bank].currentBankState = Idle;
-					bankStates[rank][bank].nextActivate = max(currentClockCycle + READ_AUTOPRE_DELAY,
-							bankStates[rank][bank].nextActivate);
+					bankStates[rank][bank].delayActivate(currentClockCycle + READ_AUTOPRE_DELAY, STALL_TRP);
 					bankStates[rank][bank].lastCommand = READ_P;
 					bankStates[rank][bank].stateChangeCountdown = READ_TO_PRE_DELAY;
 				}
 				else if (poppedBusPacket->busPacketType == READ)
 				{
-					bankStates[rank][bank].nextPrecharge = max(currentClockCycle + READ_TO_PRE_DELAY,
-							bankStates[rank][bank].nextPrecharge);
+					bankStates[rank][bank].delayPrecharge(currentClockCycle + READ_TO_PRE_DELAY, STALL_COLUMN_TO_PRECHARGE);
 					bankStates[rank][bank].lastCommand = READ;
 
 				}
@@ -331,16 +407,14 @@ void MemoryController::update()
 							//check to make sure it is active before trying to set (save's time?)
 							if (bankStates[i][j].currentBankState == RowActive)
 							{
-								bankStates[i][j].nextRead = max(currentClockCycle + BL/2 + tRTRS, bankStates[i][j].nextRead);
-								bankStates[i][j].nextWrite = max(currentClockCycle + READ_TO_WRITE_DELAY,
-										bankStates[i][j].nextWrite);
+								bankStates[i][j].delayRead(currentClockCycle + BL/2 + tRTRS, STALL_RANK_SWITCH);
+								bankStates[i][j].delayWrite(currentClockCycle + READ_TO_WRITE_DELAY, STALL_READ_TO_WRITE);
 							}
 						}
 						else
 						{
-							bankStates[i][j].nextRead = max(currentClockCycle + max(tCCD, BL/2), bankStates[i][j].nextRead);
-							bankStates[i][j].nextWrite = max(currentClockCycle + READ_TO_WRITE_DELAY,
-									bankStates[i][j].nextWrite);
+							bankStates[i][j].delayRead(currentClockCycle + max(tCCD, BL/2), STALL_TCCD);
+							bankStates[i][j].delayWrite(currentClockCycle + READ_TO_WRITE_DELAY, STALL_READ_TO_WRITE);
 						}
 					}
 				}
@@ -352,6 +426,8 @@ void MemoryController::update()
 					//  auto-precharge associated with this command
 					bankStates[rank][bank].nextRead = bankStates[rank][bank].nextActivate;
 					bankStates[rank][bank].nextWrite = bankStates[rank][bank].nextActivate;
+					bankStates[rank][bank].nextReadReason = STALL_TRP;
+					bankStates[rank][bank].nextWriteReason = STALL_TRP;
 				}
 
 				break;
@@ -359,23 +435,21 @@ void MemoryController::update()
 			case WRITE:
 				if (poppedBusPacket->busPacketType == WRITE_P) 
 				{
-					bankStates[rank][bank].nextActivate = max(currentClockCycle + WRITE_AUTOPRE_DELAY,
-							bankStates[rank][bank].nextActivate);
+					bankStates[rank][bank].delayActivate(currentClockCycle + WRITE_AUTOPRE_DELAY, STALL_TRP);
 					bankStates[rank][bank].lastCommand = WRITE_P;
 					bankStates[rank][bank].stateChangeCountdown = WRITE_TO_PRE_DELAY;
 				}
 				else if (poppedBusPacket->busPacketType == WRITE)
 				{
-					bankStates[rank][bank].nextPrecharge = max(currentClockCycle + WRITE_TO_PRE_DELAY,
-							bankStates[rank][bank].nextPrecharge);
+					bankStates[rank][bank].delayPrecharge(currentClockCycle + WRITE_TO_PRE_DELAY, STALL_COLUMN_TO_PRECHARGE);
 					bankStates[rank][bank].lastCommand = WRITE;
 				}
 
 
 				//add energy to account for total
-				if (DEBUG_POWER)
+				if (TRACE_ON(TRACE_CYCLES, DEBUG_POWER))
 				{
-					PRINT(" ++ Adding Write energy to total energy");
+					PRINT_DEFERRED(line(" ++ Adding Write energy to total energy"), " ++ Adding Write energy to total energy");
 				}
 				burstEnergy[rank] += (IDD4W - IDD3N) * BL/2 * NUM_DEVICES;
 
@@ -387,16 +461,14 @@ void MemoryController::update()
 						{
 							if (bankStates[i][j].currentBankState == RowActive)
 							{
-								bankStates[i][j].nextWrite = max(currentClockCycle + BL/2 + tRTRS, bankStates[i][j].nextWrite);
-								bankStates[i][j].nextRead = max(currentClockCycle + WRITE_TO_READ_DELAY_R,
-										bankStates[i][j].nextRead);
+								bankStates[i][j].delayWrite(currentClockCycle + BL/2 + tRTRS, STALL_RANK_SWITCH);
+								bankStates[i][j].delayRead(currentClockCycle + WRITE_TO_READ_DELAY_R, STALL_WRITE_TO_READ);
 							}
 						}
 						else
 						{
-							bankStates[i][j].nextWrite = max(currentClockCycle + max(BL/2, tCCD), bankStates[i][j].nextWrite);
-							bankStates[i][j].nextRead = max(currentClockCycle + WRITE_TO_READ_DELAY_B,
-									bankStates[i][j].nextRead);
+							bankStates[i][j].delayWrite(currentClockCycle + max(BL/2, tCCD), STALL_TCCD);
+							bankStates[i][j].delayRead(currentClockCycle + WRITE_TO_READ_DELAY_B, STALL_WRITE_TO_READ);
 						}
 					}
 				}
@@ -408,33 +480,40 @@ void MemoryController::update()
 				{
 					bankStates[rank][bank].nextRead = bankStates[rank][bank].nextActivate;
 					bankStates[rank][bank].nextWrite = bankStates[rank][bank].nextActivate;
+					bankStates[rank][bank].nextReadReason = STALL_TRP;
+					bankStates[rank][bank].nextWriteReason = STALL_TRP;
 				}
 
 				break;
 			case ACTIVATE:
 				//add energy to account for total
-				if (DEBUG_POWER)
+				if (TRACE_ON(TRACE_CYCLES, DEBUG_POWER))
 				{
-					PRINT(" ++ Adding Activate and Precharge energy to total energy");
+					PRINT_DEFERRED(line(" ++ Adding Activate and Precharge energy to total energy"), " ++ Adding Activate and Precharge energy to total energy");
 				}
 				actpreEnergy[rank] += ((IDD0 * tRC) - ((IDD3N * tRAS) + (IDD2N * (tRC - tRAS)))) * NUM_DEVICES;
 
 				bankStates[rank][bank].currentBankState = RowActive;
 				bankStates[rank][bank].lastCommand = ACTIVATE;
 				bankStates[rank][bank].openRowAddress = poppedBusPacket->row;
-				bankStates[rank][bank].nextActivate = max(currentClockCycle + tRC, bankStates[rank][bank].nextActivate);
-				bankStates[rank][bank].nextPrecharge = max(currentClockCycle + tRAS, bankStates[rank][bank].nextPrecharge);
+				if (ROW_HEAT_OUTPUT)
+				{
+					rowHeat.activate(rank, bank, poppedBusPacket->row);
+					totalRowHeat.activate(rank, bank, poppedBusPacket->row);
+				}
+				bankStates[rank][bank].delayActivate(currentClockCycle + tRC, STALL_TRC);
+				bankStates[rank][bank].delayPrecharge(currentClockCycle + tRAS, STALL_TRAS);
 
 				//if we are using posted-CAS, the next column access can be sooner than normal operation
 
-				bankStates[rank][bank].nextRead = max(currentClockCycle + (tRCD-AL), bankStates[rank][bank].nextRead);
-				bankStates[rank][bank].nextWrite = max(currentClockCycle + (tRCD-AL), bankStates[rank][bank].nextWrite);
+				bankStates[rank][bank].delayRead(currentClockCycle + (tRCD-AL), STALL_TRCD);
+				bankStates[rank][bank].delayWrite(currentClockCycle + (tRCD-AL), STALL_TRCD);
 
 				for (size_t i=0;i<NUM_BANKS;i++)
 				{
 					if (i!=poppedBusPacket->bank)
 					{
-						bankStates[rank][i].nextActivate = max(currentClockCycle + tRRD, bankStates[rank][i].nextActivate);
+						bankStates[rank][i].delayActivate(currentClockCycle + tRRD, STALL_TRRD);
 					}
 				}
 
@@ -443,20 +522,21 @@ void MemoryController::update()
 				bankStates[rank][bank].currentBankState = Precharging;
 				bankStates[rank][bank].lastCommand = PRECHARGE;
 				bankStates[rank][bank].stateChangeCountdown = tRP;
-				bankStates[rank][bank].nextActivate = max(currentClockCycle + tRP, bankStates[rank][bank].nextActivate);
+				bankStates[rank][bank].delayActivate(currentClockCycle + tRP, STALL_TRP);
 
 				break;
 			case REFRESH:
 				//add energy to account for total
-				if (DEBUG_POWER)
+				if (TRACE_ON(TRACE_CYCLES, DEBUG_POWER))
 				{
-					PRINT(" ++ Adding Refresh energy to total energy");
+					PRINT_DEFERRED(line(" ++ Adding Refresh energy to total energy"), " ++ Adding Refresh energy to total energy");
 				}
 				refreshEnergy[rank] += (IDD5 - IDD3N) * tRFC * NUM_DEVICES;
 
 				for (size_t i=0;i<NUM_BANKS;i++)
 				{
 					bankStates[rank][i].nextActivate = currentClockCycle + tRFC;
+					bankStates[rank][i].nextActivateReason = STALL_REFRESH;
 					bankStates[rank][i].currentBankState = Refreshing;
 					bankStates[rank][i].lastCommand = REFRESH;
 					bankStates[rank][i].stateChangeCountdown = tRFC;
@@ -469,7 +549,7 @@ void MemoryController::update()
 		}
 
 		//issue on bus and print debug
-		if (DEBUG_BUS)
+		if (TRACE_ON(TRACE_COMMANDS, DEBUG_BUS))
 		{
 			PRINTN(" -- MC Issuing On Command Bus : ");
 			poppedBusPacket->print();
@@ -484,6 +564,15 @@ void MemoryController::update()
 		outgoingCmdPacket = poppedBusPacket;
 		cmdCyclesLeft = tCMD;
 
+		if (parentMemorySystem->CommandIssued != NULL)
+		{
+			(*parentMemorySystem->CommandIssued)(parentMemorySystem->systemID, poppedBusPacket, currentClockCycle);
+		}
+		if (parentMemorySystem->timelineOut != NULL)
+		{
+			parentMemorySystem->timelineOut->command(*poppedBusPacket, currentClockCycle);
+		}
+
 	}
 
 	for (size_t i=0;i<transactionQueue.size();i++)
@@ -505,7 +594,7 @@ void MemoryController::update()
 		if (commandQueue.hasRoomFor(2, newTransactionRank, newTransactionBank))
 		{
 
-			if (DEBUG_ADDR_MAP) 
+			if (TRACE_ON(TRACE_COMMANDS, DEBUG_ADDR_MAP)) 
 			{
 				PRINTN("== New Transaction - Mapping Address [0x" << hex << transaction.address << dec << "]");
 				if (transaction.transactionType == DATA_READ) 
@@ -530,13 +619,9 @@ void MemoryController::update()
 			transactionQueue.erase(transactionQueue.begin()+i);
 
 			//create activate command to the row we just translated
-#if (USE_SCIC_MEMSYS_QUERY == 1)
-			BusPacket *ACTcommand = new BusPacket(ACTIVATE, transaction.address, newTransactionColumn, newTransactionRow,
-				newTransactionRank, newTransactionBank, 0, transaction.timeAdded, transaction.id);
-#else
 			BusPacket *ACTcommand = new BusPacket(ACTIVATE, transaction.address, newTransactionColumn, newTransactionRow,
 			                                 newTransactionRank, newTransactionBank, 0, transaction.id);
-#endif
+			ACTcommand->stamps.enqueued = currentClockCycle;
 			commandQueue.enqueue(ACTcommand);
 
 			//create read or write command and enqueue it
@@ -546,24 +631,16 @@ void MemoryController::update()
 				if (rowBufferPolicy == OpenPage)
 				{
 
-#if (USE_SCIC_MEMSYS_QUERY == 1)
-					READcommand = new BusPacket(READ, transaction.address, newTransactionColumn, newTransactionRow,
-						newTransactionRank, newTransactionBank,0, transaction.timeAdded, transaction.id);
-#else
 					READcommand = new BusPacket(READ, transaction.address, newTransactionColumn, newTransactionRow,
 					                        newTransactionRank, newTransactionBank,0, transaction.id);
-#endif
+					READcommand->stamps.enqueued = currentClockCycle;
 					commandQueue.enqueue(READcommand);
 				}
 				else if (rowBufferPolicy == ClosePage)
 				{
-#if (USE_SCIC_MEMSYS_QUERY == 1)
-					READcommand = new BusPacket(READ_P, transaction.address, newTransactionColumn, newTransactionRow,
-						newTransactionRank, newTransactionBank,0, transaction.timeAdded, transaction.id);
-#else
 					READcommand = new BusPacket(READ_P, transaction.address, newTransactionColumn, newTransactionRow,
 					                        newTransactionRank, newTransactionBank,0, transaction.id);
-#endif
+					READcommand->stamps.enqueued = currentClockCycle;
 					commandQueue.enqueue(READcommand);
 				}
 			}
@@ -573,24 +650,22 @@ void MemoryController::update()
 				if (rowBufferPolicy == OpenPage)
 				{
 
-#if (USE_SCIC_MEMSYS_QUERY == 1)
-					WRITEcommand = new BusPacket(WRITE, transaction.address, newTransactionColumn, newTransactionRow,
-						newTransactionRank, newTransactionBank, transaction.data, transaction.timeAdded, transaction.id);
-#else
 					WRITEcommand = new BusPacket(WRITE, transaction.address, newTransactionColumn, newTransactionRow,
 					                         newTransactionRank, newTransactionBank, transaction.data, transaction.id);
-#endif
+					WRITEcommand->timeIssued = transaction.timeIssued;
+					WRITEcommand->timeAdded = transaction.timeAdded;
+					WRITEcommand->sourceID = transaction.sourceID;
+					WRITEcommand->stamps.enqueued = currentClockCycle;
 					commandQueue.enqueue(WRITEcommand);
 				}
 				else if (rowBufferPolicy == ClosePage)
 				{
-#if (USE_SCIC_MEMSYS_QUERY == 1)
-					WRITEcommand = new BusPacket(WRITE_P, transaction.address, newTransactionColumn, newTransactionRow,
-						newTransactionRank, newTransactionBank, transaction.data, transaction.timeAdded, transaction.id);
-#else
 					WRITEcommand = new BusPacket(WRITE_P, transaction.address, newTransactionColumn, newTransactionRow,
 					                         newTransactionRank, newTransactionBank, transaction.data, transaction.id);
-#endif
+					WRITEcommand->timeIssued = transaction.timeIssued;
+					WRITEcommand->timeAdded = transaction.timeAdded;
+					WRITEcommand->sourceID = transaction.sourceID;
+					WRITEcommand->stamps.enqueued = currentClockCycle;
 					commandQueue.enqueue(WRITEcommand);
 				}
 			}
@@ -647,10 +722,20 @@ void MemoryController::update()
 				{
 					bankStates[i][j].currentBankState = Idle;
 					bankStates[i][j].nextActivate = currentClockCycle + tXP;
+					bankStates[i][j].nextActivateReason = STALL_POWER_DOWN;
 				}
 			}
 		}
 
+		if (powerDown[i])
+		{
+			rankStateCycles[STATS_POWER_DOWN_CYCLES][i]++;
+		}
+		else if (bankStates[i][0].currentBankState == Refreshing)
+		{
+			rankStateCycles[STATS_REFRESH_CYCLES][i]++;
+		}
+
 		//check for open bank
 		bool bankOpen = false;
 		for (size_t j=0;j<NUM_BANKS;j++)
@@ -666,9 +751,9 @@ void MemoryController::update()
 		//background power is dependent on whether or not a bank is open or not
 		if (bankOpen)
 		{
-			if (DEBUG_POWER)
+			if (TRACE_ON(TRACE_CYCLES, DEBUG_POWER))
 			{
-				PRINT(" ++ Adding IDD3N to total energy [from rank "<< i <<"]");
+				PRINT_DEFERRED(value(" ++ Adding IDD3N to total energy [from rank ", i, "]"), " ++ Adding IDD3N to total energy [from rank "<< i <<"]");
 			}
 			backgroundEnergy[i] += IDD3N * NUM_DEVICES;
 		}
@@ -677,17 +762,17 @@ void MemoryController::update()
 			//if we're in power-down mode, use the correct current
 			if (powerDown[i])
 			{
-				if (DEBUG_POWER)
+				if (TRACE_ON(TRACE_CYCLES, DEBUG_POWER))
 				{
-					PRINT(" ++ Adding IDD2P to total energy [from rank " << i << "]");
+					PRINT_DEFERRED(value(" ++ Adding IDD2P to total energy [from rank ", i, "]"), " ++ Adding IDD2P to total energy [from rank " << i << "]");
 				}
 				backgroundEnergy[i] += IDD2P * NUM_DEVICES;
 			}
 			else
 			{
-				if (DEBUG_POWER)
+				if (TRACE_ON(TRACE_CYCLES, DEBUG_POWER))
 				{
-					PRINT(" ++ Adding IDD2N to total energy [from rank " << i << "]");
+					PRINT_DEFERRED(value(" ++ Adding IDD2N to total energy [from rank ", i, "]"), " ++ Adding IDD2N to total energy [from rank " << i << "]");
 				}
 				backgroundEnergy[i] += IDD2N * NUM_DEVICES;
 			}
@@ -697,7 +782,7 @@ void MemoryController::update()
 	//check for outstanding data to return to the CPU
 	if (returnTransaction.size()>0)
 	{
-		if (DEBUG_BUS)
+		if (TRACE_ON(TRACE_COMMANDS, DEBUG_BUS))
 		{
 			PRINTN(" -- MC Issuing to CPU bus : ");
 			returnTransaction[0].print();
@@ -717,11 +802,17 @@ void MemoryController::update()
 				uint rank,bank,row,col;
 				addressMapping(returnTransaction[0].address,rank,bank,row,col);
 
-#if (USE_SCIC_MEMSYS_QUERY == 1)
-				(*parentMemorySystem->_callbackforHistogram)(currentClockCycle-pendingReadTransactions[i].timeAdded,rank,bank);			
-#endif
+				if (parentMemorySystem->_callbackforHistogram != NULL)
+				{
+					(*parentMemorySystem->_callbackforHistogram)(currentClockCycle-pendingReadTransactions[i].timeAdded,rank,bank);
+				}
 
 				insertHistogram(currentClockCycle-pendingReadTransactions[i].timeAdded,rank,bank);
+				size_t source = sourceSlot(pendingReadTransactions[i].sourceID);
+				totalReadsPerSource[source]++;
+				totalLatencyPerSource[source] += currentClockCycle-pendingReadTransactions[i].timeAdded;
+				recordLatencyBreakdown(false, pendingReadTransactions[i].id, pendingReadTransactions[i].address, pendingReadTransactions[i].sourceID,
+				                       pendingReadTransactions[i].timeIssued, pendingReadTransactions[i].timeAdded, returnTransaction[0].stamps);
 				//return latency
 				returnReadData(pendingReadTransactions[i]);
 
@@ -741,7 +832,7 @@ void MemoryController::update()
 	//
 	//print debug
 	//
-	if (DEBUG_TRANS_Q)
+	if (TRACE_ON(TRACE_CYCLES, DEBUG_TRANS_Q))
 	{
 		PRINT("== Printing transaction queue");
 		for (size_t i=0;i<transactionQueue.size();i++)
@@ -751,7 +842,7 @@ void MemoryController::update()
 		}
 	}
 
-	if (DEBUG_BANKSTATE)
+	if (TRACE_ON(TRACE_CYCLES, DEBUG_BANKSTATE))
 	{
 		//TODO: move this to BankState.cpp
 		PRINT("== Printing bank states (According to MC)");
@@ -784,19 +875,40 @@ void MemoryController::update()
 		}
 	}
 
-	if (DEBUG_CMD_Q)
+	if (TRACE_ON(TRACE_CYCLES, DEBUG_CMD_Q))
 	{
 		commandQueue.print();
 	}
 
 	commandQueue.step();
 
+	if (parentMemorySystem->timelineOut != NULL)
+	{
+		parentMemorySystem->timelineOut->update(bankStates, currentClockCycle);
+	}
+
+	if (parentMemorySystem->sharedStatsOut != NULL && currentClockCycle % SHARED_STATS_INTERVAL == 0)
+	{
+		this->publishSharedStats();
+	}
+
 	//print stats if we're at the end of an epoch
 	if (currentClockCycle % EPOCH_LENGTH == 0)
 	{
-		this->printStats();
+		if (parentMemorySystem->epochStatsOut != NULL)
+		{
+			this->writeEpochStats();
+		}
+		else
+		{
+			this->printStats();
+		}
+
+		Snapshot(previousEpochs);
 
 		totalTransactions = 0;
+		totalAdmissionWait = 0;
+		totalAdmitted = 0;
 		for (size_t i=0;i<NUM_RANKS;i++)
 		{
 			for (size_t j=0; j<NUM_BANKS; j++)
@@ -804,6 +916,20 @@ void MemoryController::update()
 				totalReadsPerBank[SEQUENTIAL(i,j)] = 0;
 				totalWritesPerBank[SEQUENTIAL(i,j)] = 0;
 				totalEpochLatency[SEQUENTIAL(i,j)] = 0;
+				for (size_t r=0; r<STALL_REASONS; r++)
+				{
+					totalStallCycles[r][SEQUENTIAL(i,j)] += commandQueue.stallCycles[r][SEQUENTIAL(i,j)];
+					commandQueue.stallCycles[r][SEQUENTIAL(i,j)] = 0;
+				}
+				for (size_t c=0; c<STATS_ROW_BUFFER_COUNTERS; c++)
+				{
+					rowBufferCounters[c][SEQUENTIAL(i,j)] = 0;
+				}
+
+				totalReadLatencyHistograms[SEQUENTIAL(i,j)].merge(readLatencyHistograms[SEQUENTIAL(i,j)]);
+				totalWriteLatencyHistograms[SEQUENTIAL(i,j)].merge(writeLatencyHistograms[SEQUENTIAL(i,j)]);
+				readLatencyHistograms[SEQUENTIAL(i,j)].reset();
+				writeLatencyHistograms[SEQUENTIAL(i,j)].reset();
 			}
 
 			burstEnergy[i] = 0;
@@ -812,6 +938,21 @@ void MemoryController::update()
 			backgroundEnergy[i] = 0;
 			totalReadsPerRank[i] = 0;
 			totalWritesPerRank[i] = 0;
+			for (size_t r=0; r<STATS_RANK_STATES; r++)
+			{
+				rankStateCycles[r][i] = 0;
+			}
+		}
+		for (size_t b=0; b<STATS_BUS_COUNTERS; b++)
+		{
+			busCounters[b] = 0;
+		}
+		rowHeat.reset();
+		for (size_t s=0; s<totalReadsPerSource.size(); s++)
+		{
+			totalReadsPerSource[s] = 0;
+			totalWritesPerSource[s] = 0;
+			totalLatencyPerSource[s] = 0;
 		}
 	}
 }
@@ -827,6 +968,11 @@ bool MemoryController::addTransaction(Transaction &trans)
 	if (WillAcceptTransaction())
 	{
 		trans.timeAdded = currentClockCycle;
+		if (trans.timeIssued != TRANSACTION_NOT_ISSUED && trans.timeIssued < trans.timeAdded)
+		{
+			totalAdmissionWait += trans.timeAdded - trans.timeIssued;
+		}
+		totalAdmitted++;
 		transactionQueue.push_back(trans);
 		return true;
 	}
@@ -1024,6 +1170,23 @@ void MemoryController::printStats(bool finalStats)
 	if (currentClockCycle == 0)
 		return;
 
+	if (finalStats && parentMemorySystem->epochStatsOut != NULL)
+	{
+		writeEpochStats(true);
+	}
+	if (finalStats && parentMemorySystem->sharedStatsOut != NULL)
+	{
+		publishSharedStats(true);
+	}
+	if (finalStats && parentMemorySystem->latencyLogOut != NULL)
+	{
+		parentMemorySystem->latencyLogOut->flush();
+	}
+	if (finalStats && parentMemorySystem->timelineOut != NULL)
+	{
+		parentMemorySystem->timelineOut->close(currentClockCycle);
+	}
+
 	//if we are not at the end of the epoch, make sure to adjust for the actual number of cycles elapsed
 
 	uint64_t cyclesElapsed = (currentClockCycle % EPOCH_LENGTH == 0) ? EPOCH_LENGTH : currentClockCycle % EPOCH_LENGTH;
@@ -1054,6 +1217,43 @@ void MemoryController::printStats(bool finalStats)
 			totalWritesPerRank[i] += totalWritesPerBank[SEQUENTIAL(i,j)];
 		}
 	}
+
+	// so do the row buffer, bus and rank state counters
+	MemoryStats efficiency;
+	Snapshot(efficiency);
+	if (!finalStats)
+	{
+		efficiency.subtract(previousEpochs);
+	}
+
+	// latency percentiles cover the epoch, or the whole run in the final stats;
+	// only the latter needs per-bank histograms of its own
+	vector<LatencyHistogram> runReadLatency, runWriteLatency;
+	if (finalStats)
+	{
+		runReadLatency = totalReadLatencyHistograms;
+		runWriteLatency = totalWriteLatencyHistograms;
+		for (size_t i=0; i<NUM_RANKS*NUM_BANKS; i++)
+		{
+			runReadLatency[i].merge(readLatencyHistograms[i]);
+			runWriteLatency[i].merge(writeLatencyHistograms[i]);
+		}
+	}
+	const vector<LatencyHistogram> &readLatency = finalStats ? runReadLatency : readLatencyHistograms;
+	const vector<LatencyHistogram> &writeLatency = finalStats ? runWriteLatency : writeLatencyHistograms;
+	vector<LatencyHistogram> rankReadLatency = vector<LatencyHistogram>(NUM_RANKS);
+	vector<LatencyHistogram> rankWriteLatency = vector<LatencyHistogram>(NUM_RANKS);
+	LatencyHistogram allReadLatency, allWriteLatency;
+	for (size_t i=0;i<NUM_RANKS;i++)
+	{
+		for (size_t j=0; j<NUM_BANKS; j++)
+		{
+			rankReadLatency[i].merge(readLatency[SEQUENTIAL(i,j)]);
+			rankWriteLatency[i].merge(writeLatency[SEQUENTIAL(i,j)]);
+		}
+		allReadLatency.merge(rankReadLatency[i]);
+		allWriteLatency.merge(rankWriteLatency[i]);
+	}
 #ifdef LOG_OUTPUT
 	dramsim_log.precision(3);
 	dramsim_log.setf(ios::fixed,ios::floatfield);
@@ -1066,6 +1266,32 @@ void MemoryController::printStats(bool finalStats)
 	PRINT( " ============== Printing Statistics [id:"<<parentMemorySystem->systemID<<"]==============" );
 	PRINTN( "   Total Return Transactions : " << totalTransactions );
 	PRINT( " ("<<totalBytesTransferred <<" bytes) aggregate average bandwidth "<<totalBandwidth<<"GB/s");
+	PRINT( "   Admitted Transactions     : " << totalAdmitted << " (average admission wait "
+	       << (totalAdmitted == 0 ? 0.0 : (double)totalAdmissionWait / (double)totalAdmitted) << " cycles)");
+	PRINT( "   Read Latency              : " << latencyPercentiles(allReadLatency));
+	PRINT( "   Write Latency             : " << latencyPercentiles(allWriteLatency));
+	PRINT( "   Bus Utilization           : command " << 100.0 * efficiency.BusUtilization(STATS_COMMAND_BUS_CYCLES)
+	       << "%, data " << 100.0 * efficiency.BusUtilization(STATS_DATA_BUS_CYCLES) << "%");
+	PRINT( "   Turnarounds               : " << efficiency.bus[STATS_READ_TO_WRITE] << " read to write, "
+	       << efficiency.bus[STATS_WRITE_TO_READ] << " write to read, " << efficiency.bus[STATS_RANK_SWITCHES] << " rank switches");
+
+	//only shown once requests from more than one source have been seen
+	if (totalReadsPerSource.size() > 1)
+	{
+		for (size_t s=0; s<totalReadsPerSource.size(); s++)
+		{
+			//ids in between the ones in use get no line
+			if (totalReadsPerSource[s] == 0 && totalWritesPerSource[s] == 0)
+			{
+				continue;
+			}
+			double sourceBandwidth = (((double)(totalReadsPerSource[s]+totalWritesPerSource[s]) * (double)bytesPerTransaction)/(1024.0*1024.0*1024.0)) / secondsThisEpoch;
+			//a source may have only written, or been idle, this epoch
+			double sourceLatency = totalReadsPerSource[s] == 0 ? 0.0 : ((double)totalLatencyPerSource[s] / (double)totalReadsPerSource[s]) * tCK;
+			PRINT( "      -Source "<<s<<(s == MAX_SOURCES-1 ? "+" : "")<<" : "<<totalReadsPerSource[s]<<" reads, "<<totalWritesPerSource[s]<<" writes, "
+			       <<sourceBandwidth<<" GB/s, average read latency "<<sourceLatency<<" ns");
+		}
+	}
 
 	if (VIS_FILE_OUTPUT)
 	{
@@ -1080,9 +1306,23 @@ void MemoryController::printStats(bool finalStats)
 		PRINT( " ("<<totalReadsPerRank[i] * bytesPerTransaction<<" bytes)");
 		PRINTN( "        -Writes : " << totalWritesPerRank[i]);
 		PRINT( " ("<<totalWritesPerRank[i] * bytesPerTransaction<<" bytes)");
+		PRINT( "        -Read Latency  : " << latencyPercentiles(rankReadLatency[i]));
+		PRINT( "        -Write Latency : " << latencyPercentiles(rankWriteLatency[i]));
+		PRINT( "        -Refresh / Power Down : " << 100.0 * efficiency.RankStateFraction(i, STATS_REFRESH_CYCLES) << "% / "
+		       << 100.0 * efficiency.RankStateFraction(i, STATS_POWER_DOWN_CYCLES) << "% of cycles");
 		for (size_t j=0;j<NUM_BANKS;j++)
 		{
 			PRINT( "        -Bandwidth / Latency  (Bank " <<j<<"): " <<bandwidth[SEQUENTIAL(i,j)] << " GB/s\t\t" <<averageLatency[SEQUENTIAL(i,j)] << " ns");
+			PRINT( "           reads  " << latencyPercentiles(readLatency[SEQUENTIAL(i,j)]));
+			PRINT( "           writes " << latencyPercentiles(writeLatency[SEQUENTIAL(i,j)]));
+			PRINT( "           rows   " << efficiency.rowBuffer[STATS_ROW_HITS][SEQUENTIAL(i,j)] << " hits, "
+			       << efficiency.rowBuffer[STATS_ROW_MISSES][SEQUENTIAL(i,j)] << " misses, "
+			       << efficiency.rowBuffer[STATS_ROW_CONFLICTS][SEQUENTIAL(i,j)] << " conflicts, "
+			       << efficiency.ActivatesPerColumn(SEQUENTIAL(i,j)) << " ACT per column");
+			if (STALL_STATS_OUTPUT)
+			{
+				PRINT( "           stalls " << stallSummary(SEQUENTIAL(i,j), finalStats));
+			}
 		}
 
 		// factor of 1000 at the end is to account for the fact that totalEnergy is accumulated in mJ since IDD values are given in mA
@@ -1122,23 +1362,46 @@ void MemoryController::printStats(bool finalStats)
 		(*visDataOut) <<endl;
 	}
 
+	if (ROW_HEAT_OUTPUT)
+	{
+		printRowHeat(finalStats ? totalRowHeat : rowHeat);
+	}
+
 	// only print the latency histogram at the end of the simulation since it clogs the output too much to print every epoch
 	if (finalStats)
 	{
-		PRINT( " ---  Latency list ("<<latencies.size()<<")");
+		PRINT( " ---  Latency breakdown (mean, then percentiles)");
+		for (size_t s=0; s<LATENCY_STAGES; s++)
+		{
+			const LatencyHistogram &readStage = latencyBreakdown.Stage(false, s);
+			const LatencyHistogram &writeStage = latencyBreakdown.Stage(true, s);
+			PRINT( "   " << latencyStageNames[s]);
+			PRINT( "        reads  " << readStage.Mean() * tCK << " ns, " << latencyPercentiles(readStage));
+			PRINT( "        writes " << writeStage.Mean() * tCK << " ns, " << latencyPercentiles(writeStage));
+		}
+
+		size_t usedBuckets = 0;
+		for (size_t b=0; b<allReadLatency.NumBuckets(); b++)
+		{
+			usedBuckets += allReadLatency.BucketCount(b) > 0;
+		}
+		PRINT( " ---  Latency list ("<<usedBuckets<<")");
 		PRINT( "       [lat] : #");
 		if (VIS_FILE_OUTPUT)
 		{
 			(*visDataOut) << "!!HISTOGRAM_DATA"<<endl;
 		}
 
-		map<uint,uint>::iterator it; //
-		for (it=latencies.begin(); it!=latencies.end(); it++)
+		for (size_t b=0; b<allReadLatency.NumBuckets(); b++)
 		{
-			PRINT( "       ["<< it->first <<"-"<<it->first+(HISTOGRAM_BIN_SIZE-1)<<"] : "<< it->second );
+			if (allReadLatency.BucketCount(b) == 0)
+			{
+				continue;
+			}
+			PRINT( "       ["<< LatencyHistogram::bucketLow(b) <<"-"<<LatencyHistogram::bucketHigh(b)<<"] : "<< allReadLatency.BucketCount(b) );
 			if (VIS_FILE_OUTPUT)
 			{
-				(*visDataOut) << it->first <<"="<< it->second << endl;
+				(*visDataOut) << LatencyHistogram::bucketLow(b) <<"="<< allReadLatency.BucketCount(b) << endl;
 			}
 		}
 
@@ -1147,7 +1410,7 @@ void MemoryController::printStats(bool finalStats)
 		{
 			for (size_t j=0;j<NUM_BANKS;j++)
 			{
-				PRINT( "["<<i<<","<<j<<"] : "<<totalReadsPerBank[i+j]+totalWritesPerBank[i+j]);
+				PRINT( "["<<i<<","<<j<<"] : "<<totalReadsPerBank[SEQUENTIAL(i,j)]+totalWritesPerBank[SEQUENTIAL(i,j)]);
 			}
 		}
 	}
@@ -1163,15 +1426,272 @@ void MemoryController::printStats(bool finalStats)
 	dramsim_log.flush();
 #endif
 }
+//appends this epoch's counters to the binary stats file in place of the text
+//stats; the final (partial) epoch is written along with the text stats
+void MemoryController::writeEpochStats(bool finalStats)
+{
+	if (currentClockCycle == 0)
+		return;
+
+	EpochStatsRecord record = EpochStatsRecord();
+	record.cycle = currentClockCycle;
+	record.cyclesElapsed = (currentClockCycle % EPOCH_LENGTH == 0) ? EPOCH_LENGTH : currentClockCycle % EPOCH_LENGTH;
+	record.transactions = totalTransactions;
+	record.admitted = totalAdmitted;
+	record.admissionWait = totalAdmissionWait;
+	record.commandBusCycles = busCounters[STATS_COMMAND_BUS_CYCLES];
+	record.dataBusCycles = busCounters[STATS_DATA_BUS_CYCLES];
+	record.readToWrite = busCounters[STATS_READ_TO_WRITE];
+	record.writeToRead = busCounters[STATS_WRITE_TO_READ];
+	record.rankSwitches = busCounters[STATS_RANK_SWITCHES];
+	record.flags = finalStats ? EPOCH_STATS_FINAL : 0;
+
+	// in the order of EpochStatsRankColumn and EpochStatsBankColumn
+	const vector<uint64_t> *rankColumns[EPOCH_STATS_RANK_COLUMNS] = {&backgroundEnergy, &burstEnergy, &actpreEnergy, &refreshEnergy,
+	                                                                 &rankStateCycles[STATS_REFRESH_CYCLES], &rankStateCycles[STATS_POWER_DOWN_CYCLES]};
+	const vector<uint64_t> *bankColumns[EPOCH_STATS_BANK_COLUMNS] = {&totalReadsPerBank, &totalWritesPerBank, &totalEpochLatency,
+	                                                                 &rowBufferCounters[STATS_ROW_HITS], &rowBufferCounters[STATS_ROW_MISSES],
+	                                                                 &rowBufferCounters[STATS_ROW_CONFLICTS], &rowBufferCounters[STATS_ACTIVATES],
+	                                                                 &rowBufferCounters[STATS_COLUMN_ACCESSES]};
+	for (size_t r=0; r<STALL_REASONS; r++)
+	{
+		bankColumns[EPOCH_STALL_CYCLES+r] = &commandQueue.stallCycles[r];
+	}
+	parentMemorySystem->epochStatsOut->write(record, rankColumns, bankColumns, readLatencyHistograms, writeLatencyHistograms);
+
+	if (finalStats)
+	{
+		parentMemorySystem->epochStatsOut->flush();
+	}
+	else if ((*parentMemorySystem->ReportPower)!=NULL)
+	{
+		// the text stats would have reported the power of each rank
+		for (size_t i=0;i<NUM_RANKS;i++)
+		{
+			(*parentMemorySystem->ReportPower)(((double)backgroundEnergy[i] / (double)record.cyclesElapsed) * Vdd / 1000.0,
+			                                   ((double)burstEnergy[i] / (double)record.cyclesElapsed) * Vdd / 1000.0,
+			                                   ((double)refreshEnergy[i] / (double)record.cyclesElapsed) * Vdd / 1000.0,
+			                                   ((double)actpreEnergy[i] / (double)record.cyclesElapsed) * Vdd / 1000.0);
+		}
+	}
+}
+
+void MemoryController::Snapshot(MemoryStats &stats) const
+{
+	size_t banks = NUM_RANKS*NUM_BANKS;
+	stats.cycle = currentClockCycle;
+	stats.transactions = previousEpochs.transactions + totalTransactions;
+	stats.reads.resize(banks);
+	stats.writes.resize(banks);
+	stats.readLatency.resize(banks);
+	for (size_t i=0;i<banks;i++)
+	{
+		stats.reads[i] = previousEpochs.reads[i] + totalReadsPerBank[i];
+		stats.writes[i] = previousEpochs.writes[i] + totalWritesPerBank[i];
+		stats.readLatency[i] = previousEpochs.readLatency[i] + totalEpochLatency[i];
+	}
+
+	// in the order of MemoryStatsEnergy
+	const vector<uint64_t> *energy[STATS_ENERGY_TYPES] = {&backgroundEnergy, &burstEnergy, &actpreEnergy, &refreshEnergy};
+	for (size_t e=0;e<STATS_ENERGY_TYPES;e++)
+	{
+		stats.energy[e].resize(NUM_RANKS);
+		for (size_t i=0;i<NUM_RANKS;i++)
+		{
+			stats.energy[e][i] = previousEpochs.energy[e][i] + (*energy[e])[i];
+		}
+	}
+
+	for (size_t c=0;c<STATS_ROW_BUFFER_COUNTERS;c++)
+	{
+		stats.rowBuffer[c].resize(banks);
+		for (size_t i=0;i<banks;i++)
+		{
+			stats.rowBuffer[c][i] = previousEpochs.rowBuffer[c][i] + rowBufferCounters[c][i];
+		}
+	}
+	for (size_t b=0;b<STATS_BUS_COUNTERS;b++)
+	{
+		stats.bus[b] = previousEpochs.bus[b] + busCounters[b];
+	}
+	for (size_t r=0;r<STATS_RANK_STATES;r++)
+	{
+		stats.rankState[r].resize(NUM_RANKS);
+		for (size_t i=0;i<NUM_RANKS;i++)
+		{
+			stats.rankState[r][i] = previousEpochs.rankState[r][i] + rankStateCycles[r][i];
+		}
+	}
+}
+
+//rewrites the live stats page; only stores, so a watcher costs nothing here
+void MemoryController::publishSharedStats(bool finalStats)
+{
+	SharedStatsWriter *shared = parentMemorySystem->sharedStatsOut;
+
+	MemoryStats stats;
+	Snapshot(stats);
+
+	LatencyHistogram readLatency, writeLatency;
+	for (size_t i=0;i<NUM_RANKS*NUM_BANKS;i++)
+	{
+		readLatency.merge(readLatencyHistograms[i]);
+		writeLatency.merge(writeLatencyHistograms[i]);
+	}
+
+	SharedStatsHeader *page = shared->beginUpdate();
+	page->cycle = currentClockCycle;
+	page->transactionQueue = transactionQueue.size();
+	page->pendingReads = pendingReadTransactions.size();
+	page->readP50 = readLatency.percentile(0.50);
+	page->readP90 = readLatency.percentile(0.90);
+	page->readP99 = readLatency.percentile(0.99);
+	page->readP999 = readLatency.percentile(0.999);
+	page->writeP50 = writeLatency.percentile(0.50);
+	page->writeP90 = writeLatency.percentile(0.90);
+	page->writeP99 = writeLatency.percentile(0.99);
+	page->writeP999 = writeLatency.percentile(0.999);
+	page->finished = finalStats;
+
+	shared->setRankCounter(SHARED_BACKGROUND_ENERGY, stats.energy[STATS_BACKGROUND_ENERGY]);
+	shared->setRankCounter(SHARED_BURST_ENERGY, stats.energy[STATS_BURST_ENERGY]);
+	shared->setRankCounter(SHARED_ACTPRE_ENERGY, stats.energy[STATS_ACTPRE_ENERGY]);
+	shared->setRankCounter(SHARED_REFRESH_ENERGY, stats.energy[STATS_REFRESH_ENERGY]);
+	uint64_t *commandQueueSize = sharedStatsRankColumn(page, SHARED_COMMAND_QUEUE);
+	for (size_t i=0;i<NUM_RANKS;i++)
+	{
+		commandQueueSize[i] = 0;
+		for (size_t j=0;j<commandQueue.queues[i].size();j++)
+		{
+			commandQueueSize[i] += commandQueue.queues[i][j].size();
+		}
+	}
+	shared->setBankCounter(SHARED_READS, stats.reads);
+	shared->setBankCounter(SHARED_WRITES, stats.writes);
+	shared->endUpdate();
+}
+
 MemoryController::~MemoryController()
 {
 	//ERROR("MEMORY CONTROLLER DESTRUCTOR");
 	//abort();
 }
+//index of a source's counters, making room for them if it is new
+size_t MemoryController::sourceSlot(unsigned sourceID)
+{
+	size_t slot = sourceID < MAX_SOURCES ? sourceID : MAX_SOURCES-1;
+	if (slot >= totalReadsPerSource.size())
+	{
+		totalReadsPerSource.resize(slot+1, 0);
+		totalWritesPerSource.resize(slot+1, 0);
+		totalLatencyPerSource.resize(slot+1, 0);
+	}
+	return slot;
+}
+
+//splits the latency of a completed transaction into its stages, see LatencyBreakdown.h
+void MemoryController::recordLatencyBreakdown(bool isWrite, uint64_t id, uint64_t address, unsigned sourceID,
+                                              uint64_t issued, uint64_t added, const LatencyStamps &stamps)
+{
+	uint64_t stageCycles[LATENCY_STAGES];
+	LatencyBreakdown::stages(issued, added, stamps, currentClockCycle, stageCycles);
+	latencyBreakdown.record(isWrite, stageCycles);
+
+	LatencyLogWriter *log = parentMemorySystem->latencyLogOut;
+	if (log != NULL && log->sampleNext())
+	{
+		LatencyLogRecord record;
+		record.id = id;
+		record.address = address;
+		record.issued = issued;
+		record.added = added;
+		record.completed = currentClockCycle;
+		copy(stageCycles, stageCycles + LATENCY_STAGES, record.stageCycles);
+		record.isWrite = isWrite;
+		record.sourceID = sourceID;
+		uint row, col;
+		addressMapping(address, record.rank, record.bank, row, col);
+		log->write(record);
+	}
+
+	TimelineWriter *timeline = parentMemorySystem->timelineOut;
+	if (timeline != NULL && timeline->recording(currentClockCycle))
+	{
+		uint rank, bank, row, col;
+		addressMapping(address, rank, bank, row, col);
+		timeline->transaction(isWrite, id, address, rank, bank, added, currentClockCycle, stageCycles);
+	}
+}
+
 //inserts a latency into the latency histogram
 void MemoryController::insertHistogram(uint latencyValue, uint rank, uint bank)
 {
 	totalEpochLatency[SEQUENTIAL(rank,bank)] += latencyValue;
-	//poor man's way to bin things.
-	latencies[(latencyValue/HISTOGRAM_BIN_SIZE)*HISTOGRAM_BIN_SIZE]++;
+	readLatencyHistograms[SEQUENTIAL(rank,bank)].record(latencyValue);
+}
+
+//p50/p90/p99/p99.9 of a latency histogram, in ns
+string MemoryController::latencyPercentiles(const LatencyHistogram &histogram)
+{
+	if (histogram.Count() == 0)
+	{
+		return "none";
+	}
+	ostringstream out;
+	out.precision(1);
+	out.setf(ios::fixed,ios::floatfield);
+	out << "p50 " << histogram.percentile(0.50) * tCK << ", p90 " << histogram.percentile(0.90) * tCK
+	    << ", p99 " << histogram.percentile(0.99) * tCK << ", p99.9 " << histogram.percentile(0.999) * tCK
+	    << " ns (" << histogram.Count() << ")";
+	return out.str();
+}
+
+//cycles the bank's queue head spent waiting this epoch, or the whole run in
+//the final stats, by reason
+string MemoryController::stallSummary(size_t bank, bool finalStats)
+{
+	ostringstream out;
+	for (size_t r=0; r<STALL_REASONS; r++)
+	{
+		uint64_t cycles = commandQueue.stallCycles[r][bank] + (finalStats ? totalStallCycles[r][bank] : 0);
+		if (cycles > 0)
+		{
+			out << (out.tellp() > 0 ? ", " : "") << stallReasonNames[r] << " " << cycles;
+		}
+	}
+	return out.tellp() > 0 ? out.str() + " cycles" : "none";
+}
+
+//the hottest rows and about how many rows were activated how often; the ACT
+//counts are upper bounds and the row counts are estimates, see RowHeat.h
+void MemoryController::printRowHeat(const RowHeatSketch &heat)
+{
+	PRINT( " ---  Hot rows ("<<heat.Activates()<<" ACTs to ~"<<heat.Rows()<<" rows)");
+	PRINT( "       [rank,bank,row] : ACTs");
+	vector<RowHeatEntry> topRows = heat.TopRows();
+	for (size_t i=0; i<topRows.size(); i++)
+	{
+		PRINT( "       ["<<topRows[i].rank<<","<<topRows[i].bank<<","<<topRows[i].row<<"] : "<<topRows[i].activates);
+	}
+	PRINT( "       [ACTs] : rows (estimated)");
+	for (size_t c=0; c<ROW_HEAT_CLASSES; c++)
+	{
+		uint64_t rows = heat.RowsInClass(c);
+		if (rows == 0)
+		{
+			continue;
+		}
+		if (c == 0)
+		{
+			PRINT( "       [1] : "<<rows);
+		}
+		else if (c == ROW_HEAT_CLASSES-1)
+		{
+			PRINT( "       ["<<RowHeatSketch::classLow(c)<<"-] : "<<rows);
+		}
+		else
+		{
+			PRINT( "       ["<<RowHeatSketch::classLow(c)<<"-"<<RowHeatSketch::classHigh(c)<<"] : "<<rows);
+		}
+	}
 }
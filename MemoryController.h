@@ -40,7 +40,14 @@
 #include "BusPacket.h"
 #include "BankState.h"
 #include "Rank.h"
-#include <map>
+#include "LatencyHistogram.h"
+#include "EpochStats.h"
+#include "SharedStats.h"
+#include "MemoryStats.h"
+#include "LatencyBreakdown.h"
+#include "Timeline.h"
+#include "RowHeat.h"
+#include <sstream>
 
 using namespace std;
 using namespace DRAMSim;
@@ -62,14 +69,18 @@ public:
 
 	bool addTransaction(Transaction &trans);
 	bool WillAcceptTransaction();
+	uint AvailableSlots() const { return TRANS_QUEUE_DEPTH - transactionQueue.size(); }
 	void returnReadData(const Transaction &trans);
 	void receiveFromBus(BusPacket *bpacket);
 	void attachRanks(vector<Rank> *ranks);
 	void update();
 	void printStats(bool finalStats = false);
+	void writeEpochStats(bool finalStats = false);
+	void publishSharedStats(bool finalStats = false);
+	//splits a physical address into its rank, bank, row and column
+	void addressMapping(uint64_t physicalAddress, uint &rank, uint &bank, uint &row, uint &col);
 
 
-#if (USE_SCIC_MEMSYS_QUERY == 1)
 	vector< uint64_t >	*RefreshEnergy()  { return &refreshEnergy; }
 	vector< uint64_t >	*ActpreEnergy() { return &actpreEnergy; }
 	vector< uint64_t >	*BurstEnergy() { return &burstEnergy; }
@@ -79,7 +90,10 @@ public:
 	vector< uint64_t >	&TotalEpochLatency() { return totalEpochLatency; }
 
 	uint64_t			TotalTransactions() const { return totalTransactions; }
-#endif
+	uint64_t			TotalAdmissionWait() const { return totalAdmissionWait; }
+	uint64_t			TotalAdmitted() const { return totalAdmitted; }
+	//counters since the start of the simulation, unaffected by epoch resets
+	void				Snapshot(MemoryStats &stats) const;
 
 
 	//fields
@@ -87,8 +101,13 @@ public:
 	vector< vector <BankState> > bankStates;
 private:
 	//functions
-	void addressMapping(uint64_t physicalAddress, uint &rank, uint &bank, uint &row, uint &col);
 	void insertHistogram(uint latencyValue, uint rank, uint bank);
+	size_t sourceSlot(unsigned sourceID);
+	void recordLatencyBreakdown(bool isWrite, uint64_t id, uint64_t address, unsigned sourceID,
+	                            uint64_t issued, uint64_t added, const LatencyStamps &stamps);
+	string latencyPercentiles(const LatencyHistogram &histogram);
+	string stallSummary(size_t bank, bool finalStats);
+	void printRowHeat(const RowHeatSketch &heat);
 
 	//fields
 	MemorySystem *parentMemorySystem;
@@ -100,7 +119,6 @@ private:
 	vector<uint> writeDataCountdown;
 	vector<Transaction> returnTransaction;
 	vector<Transaction> pendingReadTransactions;
-	map<uint,uint> latencies; // latencyValue -> latencyCount
 	vector<bool> powerDown;
 
 	vector<Rank> *ranks;
@@ -128,6 +146,51 @@ private:
 
 	vector< uint64_t > totalEpochLatency;
 
+	//the epoch counters, added up over all the epochs before this one
+	MemoryStats previousEpochs;
+
+	//per-stage latencies for the whole run, and the last ACT to each bank
+	LatencyBreakdown latencyBreakdown;
+	vector<uint64_t> lastActivate;
+
+	//row buffer, bus and rank state counters for this epoch, see MemoryStats.h
+	vector<uint64_t> rowBufferCounters[STATS_ROW_BUFFER_COUNTERS];
+	uint64_t busCounters[STATS_BUS_COUNTERS];
+	vector<uint64_t> rankStateCycles[STATS_RANK_STATES];
+
+	//what the counters above are classified against: the last PRE to each bank
+	//	if it closed the row for an access to another row (0 otherwise), banks
+	//	whose open row has had no column access yet, and the rank (NUM_RANKS
+	//	before the first) and direction of the last column command
+	vector<uint64_t> lastConflictPrecharge;
+	vector<bool> rowUntouched;
+	uint lastColumnRank;
+	bool lastColumnWrite;
+
+	// read and write latencies (transaction queue to completion) per bank for
+	// this epoch, and for all the epochs before it
+	vector<LatencyHistogram> readLatencyHistograms;
+	vector<LatencyHistogram> writeLatencyHistograms;
+	vector<LatencyHistogram> totalReadLatencyHistograms;
+	vector<LatencyHistogram> totalWriteLatencyHistograms;
+
+	//ACTs per row for this epoch and for the whole run, only sized and fed with ROW_HEAT_OUTPUT
+	RowHeatSketch rowHeat;
+	RowHeatSketch totalRowHeat;
+
+	//stall cycles per reason and bank of all the epochs before this one, see CommandQueue::stallCycles
+	vector<uint64_t> totalStallCycles[STALL_REASONS];
+
+	//per source (core) counters, grown as sources show up, at most MAX_SOURCES
+	vector<uint64_t> totalReadsPerSource;
+	vector<uint64_t> totalWritesPerSource;
+	vector<uint64_t> totalLatencyPerSource;
+
+	// cycles between a transaction being offered to the memory system and it
+	// entering the transaction queue; kept apart from the read latency
+	uint64_t totalAdmissionWait;
+	uint64_t totalAdmitted;
+
 	uint channelBitWidth;
 	uint rankBitWidth;
 	uint bankBitWidth;
@@ -0,0 +1,141 @@
+/****************************************************************************
+*	 DRAMSim2: A Cycle Accurate DRAM simulator 
+*	 
+*	 Copyright (C) 2010   	Elliott Cooper-Balis
+*									Paul Rosenfeld 
+*									Bruce Jacob
+*									University of Maryland
+*
+*	 This program is free software: you can redistribute it and/or modify
+*	 it under the terms of the GNU General Public License as published by
+*	 the Free Software Foundation, either version 3 of the License, or
+*	 (at your option) any later version.
+*
+*	 This program is distributed in the hope that it will be useful,
+*	 but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	 MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	 GNU General Public License for more details.
+*
+*	 You should have received a copy of the GNU General Public License
+*	 along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*****************************************************************************/
+
+
+
+//MemoryStats.cpp
+//
+//Class file for the memory controller's running counters
+//
+
+#include "MemoryStats.h"
+#include "SystemConfiguration.h"
+
+using namespace DRAMSim;
+using namespace std;
+
+namespace
+{
+void subtractCounters(vector<uint64_t> &later, const vector<uint64_t> &earlier)
+{
+	for (size_t i=0; i<earlier.size() && i<later.size(); i++)
+	{
+		later[i] -= earlier[i];
+	}
+}
+}
+
+MemoryStats::MemoryStats() :
+		cycle(0),
+		transactions(0)
+{
+	for (size_t b=0; b<STATS_BUS_COUNTERS; b++)
+	{
+		bus[b] = 0;
+	}
+}
+
+void MemoryStats::subtract(const MemoryStats &earlier)
+{
+	cycle -= earlier.cycle;
+	transactions -= earlier.transactions;
+	subtractCounters(reads, earlier.reads);
+	subtractCounters(writes, earlier.writes);
+	subtractCounters(readLatency, earlier.readLatency);
+	for (size_t e=0; e<STATS_ENERGY_TYPES; e++)
+	{
+		subtractCounters(energy[e], earlier.energy[e]);
+	}
+	for (size_t c=0; c<STATS_ROW_BUFFER_COUNTERS; c++)
+	{
+		subtractCounters(rowBuffer[c], earlier.rowBuffer[c]);
+	}
+	for (size_t b=0; b<STATS_BUS_COUNTERS; b++)
+	{
+		bus[b] -= earlier.bus[b];
+	}
+	for (size_t r=0; r<STATS_RANK_STATES; r++)
+	{
+		subtractCounters(rankState[r], earlier.rankState[r]);
+	}
+}
+
+double MemoryStats::Seconds() const
+{
+	return (double)cycle * tCK * 1E-9;
+}
+
+double MemoryStats::Bandwidth(size_t bank) const
+{
+	if (cycle == 0)
+	{
+		return 0.0;
+	}
+	uint bytesPerTransaction = (64*BL)/8;
+	return (((double)(reads[bank] + writes[bank]) * (double)bytesPerTransaction)/(1024.0*1024.0*1024.0)) / Seconds();
+}
+
+double MemoryStats::AverageReadLatency(size_t bank) const
+{
+	if (reads[bank] == 0)
+	{
+		return 0.0;
+	}
+	return ((double)readLatency[bank] / (double)reads[bank]) * tCK;
+}
+
+double MemoryStats::Power(size_t rank, unsigned energyType) const
+{
+	if (cycle == 0)
+	{
+		return 0.0;
+	}
+	return ((double)energy[energyType][rank] / (double)cycle) * Vdd / 1000.0;
+}
+
+double MemoryStats::ActivatesPerColumn(size_t bank) const
+{
+	if (rowBuffer[STATS_COLUMN_ACCESSES][bank] == 0)
+	{
+		return 0.0;
+	}
+	return (double)rowBuffer[STATS_ACTIVATES][bank] / (double)rowBuffer[STATS_COLUMN_ACCESSES][bank];
+}
+
+double MemoryStats::BusUtilization(unsigned busCounter) const
+{
+	if (cycle == 0)
+	{
+		return 0.0;
+	}
+	return (double)bus[busCounter] / (double)cycle;
+}
+
+double MemoryStats::RankStateFraction(size_t rank, unsigned state) const
+{
+	if (cycle == 0)
+	{
+		return 0.0;
+	}
+	return (double)rankState[state][rank] / (double)cycle;
+}
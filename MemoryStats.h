@@ -0,0 +1,122 @@
+/****************************************************************************
+*	 DRAMSim2: A Cycle Accurate DRAM simulator 
+*	 
+*	 Copyright (C) 2010   	Elliott Cooper-Balis
+*									Paul Rosenfeld 
+*									Bruce Jacob
+*									University of Maryland
+*
+*	 This program is free software: you can redistribute it and/or modify
+*	 it under the terms of the GNU General Public License as published by
+*	 the Free Software Foundation, either version 3 of the License, or
+*	 (at your option) any later version.
+*
+*	 This program is distributed in the hope that it will be useful,
+*	 but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	 MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	 GNU General Public License for more details.
+*
+*	 You should have received a copy of the GNU General Public License
+*	 along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*****************************************************************************/
+
+#ifndef MEMORYSTATS_H
+#define MEMORYSTATS_H
+
+//MemoryStats.h
+//
+//The memory controller's counters since the start of the simulation. The
+//controller's own counters start over every epoch; these never do, so the
+//difference of two snapshots is exact for any window, whatever epoch
+//boundaries lie inside it.
+//
+
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace DRAMSim
+{
+
+enum MemoryStatsEnergy
+{
+	STATS_BACKGROUND_ENERGY,
+	STATS_BURST_ENERGY,
+	STATS_ACTPRE_ENERGY,
+	STATS_REFRESH_ENERGY,
+	STATS_ENERGY_TYPES
+};
+
+//per bank; an access is a hit when its row was already open, a miss when
+//it had to activate a closed bank, and a conflict when another row was
+//closed after it arrived so that its own could be activated
+enum MemoryStatsRowBuffer
+{
+	STATS_ROW_HITS,
+	STATS_ROW_MISSES,
+	STATS_ROW_CONFLICTS,
+	STATS_ACTIVATES,
+	STATS_COLUMN_ACCESSES,
+	STATS_ROW_BUFFER_COUNTERS
+};
+
+//per channel
+enum MemoryStatsBus
+{
+	STATS_COMMAND_BUS_CYCLES,	// cycles a command was sent
+	STATS_DATA_BUS_CYCLES,	// cycles of read and write bursts
+	STATS_READ_TO_WRITE,	// column commands whose direction differs from the one before
+	STATS_WRITE_TO_READ,
+	STATS_RANK_SWITCHES,	// column commands to a different rank than the one before
+	STATS_BUS_COUNTERS
+};
+
+//per rank, in cycles
+enum MemoryStatsRankState
+{
+	STATS_REFRESH_CYCLES,
+	STATS_POWER_DOWN_CYCLES,
+	STATS_RANK_STATES
+};
+
+class MemoryStats
+{
+public:
+	MemoryStats();
+
+	//turns this snapshot into the window since an earlier one; an empty
+	//snapshot stands for the start of the simulation
+	void subtract(const MemoryStats &earlier);
+
+	double Seconds() const;
+	//GB/s and mean read latency in ns of one bank, SEQUENTIAL(rank,bank)
+	double Bandwidth(size_t bank) const;
+	double AverageReadLatency(size_t bank) const;
+	//watts drawn by one rank, for one of MemoryStatsEnergy
+	double Power(size_t rank, unsigned energyType) const;
+	//activates per column access of one bank
+	double ActivatesPerColumn(size_t bank) const;
+	//fraction of the cycles used, for STATS_COMMAND_BUS_CYCLES or STATS_DATA_BUS_CYCLES
+	double BusUtilization(unsigned busCounter) const;
+	//fraction of the cycles a rank spent in one of MemoryStatsRankState
+	double RankStateFraction(size_t rank, unsigned state) const;
+
+	//fields
+	uint64_t cycle;
+	uint64_t transactions;
+	//per bank, indexed by SEQUENTIAL(rank,bank)
+	std::vector<uint64_t> reads;
+	std::vector<uint64_t> writes;
+	std::vector<uint64_t> readLatency;	// sum of read latencies in cycles
+	//per rank, in mA*cycles
+	std::vector<uint64_t> energy[STATS_ENERGY_TYPES];
+	std::vector<uint64_t> rowBuffer[STATS_ROW_BUFFER_COUNTERS];	// per bank
+	uint64_t bus[STATS_BUS_COUNTERS];
+	std::vector<uint64_t> rankState[STATS_RANK_STATES];	// per rank
+};
+
+}
+
+#endif
+
@@ -35,11 +35,13 @@
 #include <errno.h> 
 #include <sstream> //stringstream
 #include <stdlib.h> // getenv()
+#include <algorithm> // stable_sort()
 
 using namespace std;
 
 
 ofstream cmd_verify_out; //used in Rank.cpp and MemoryController.cpp if VERIFICATION_OUTPUT is set
+int SHOW_SIM_OUTPUT = 1; //enable or disable PRINT() statements -- front ends may clear it (ex: TraceBasedSim -q)
 
 unsigned NUM_DEVICES;
 unsigned NUM_RANKS;
@@ -50,12 +52,25 @@ ofstream dramsim_log;
 #endif
 
 powerCallBack_t MemorySystem::ReportPower = NULL;
+bool MemorySystem::sideOutputsDisabled = false;
 
 MemorySystem::MemorySystem(uint id, string deviceIniFilename, string systemIniFilename, string pwd,
                            string traceFilename, unsigned int megsOfMemory) :
+		epochStatsOut(NULL),
+		sharedStatsOut(NULL),
+		latencyLogOut(NULL),
+		timelineOut(NULL),
 		ReturnReadData(NULL),
 		WriteDataDone(NULL),
+		_callbackforHistogram(NULL),
+		CommandIssued(NULL),
+		completionBuffer(NULL),
+		completionCount(0),
+		completionsReported(0),
+		submissionsAdmitted(0),
 		systemID(0),
+		submissionRing(NULL),
+		completionRing(NULL),
 		deviceIniFilename(deviceIniFilename),
 		systemIniFilename(systemIniFilename),
 		traceFilename(traceFilename),
@@ -89,6 +104,18 @@ MemorySystem::MemorySystem(uint id, string deviceIniFilename, string systemIniFi
 	DEBUG("== Loading system model file '"<<systemIniFilename<<"' == ");
 	IniReader::ReadIniFile(systemIniFilename, true);
 
+	//every output the memory system sets up from the ini has to be turned off here
+	if (sideOutputsDisabled)
+	{
+		VIS_FILE_OUTPUT = false;
+		BINARY_STATS_OUTPUT = false;
+		SHARED_STATS_OUTPUT = false;
+		LATENCY_LOG_OUTPUT = false;
+		ROW_HEAT_OUTPUT = false;
+		STALL_STATS_OUTPUT = false;
+		TIMELINE_WINDOW = "";
+	}
+
 	//calculate the total storage based on the devices the user selected and the number of
 
 	//calculate number of devices
@@ -158,6 +185,17 @@ MemorySystem::MemorySystem(uint id, string deviceIniFilename, string systemIniFi
 		exit(-1);
 	}
 
+	if (ASYNC_LOG_OUTPUT)
+	{
+		AsyncLog::start();
+	}
+
+	if (SHARED_STATS_OUTPUT)
+	{
+		sharedStatsOut = new SharedStatsWriter(systemID);
+		cerr << "publishing live stats in shared memory segment " << sharedStatsName(getpid(), systemID) << endl;
+	}
+
 	memoryController = new MemoryController(this, &visDataOut);
 
 	// TODO: change to other vector constructor?
@@ -183,6 +221,11 @@ void MemorySystem::overrideSystemParam(string key, string value)
 	IniReader::SetKey(key, value, true);
 }
 
+void MemorySystem::disableSideOutputs()
+{
+	sideOutputsDisabled = true;
+}
+
 void MemorySystem::overrideSystemParam(string keyValuePair)
 {
 	size_t equalsign=-1;
@@ -204,6 +247,12 @@ MemorySystem::~MemorySystem()
 	delete(memoryController);
 	ranks->clear();
 	delete(ranks);
+	delete(submissionRing);
+	delete(completionRing);
+	delete(epochStatsOut);
+	delete(sharedStatsOut);
+	delete(latencyLogOut);
+	delete(timelineOut);
 	if (VIS_FILE_OUTPUT) 
 	{	
 		visDataOut.flush();
@@ -278,7 +327,7 @@ string MemorySystem::SetOutputFileName(string traceFilename)
 		}
 	}
 	// TODO: move this to its own function or something? 
-	if (VIS_FILE_OUTPUT)
+	if (VIS_FILE_OUTPUT || BINARY_STATS_OUTPUT || LATENCY_LOG_OUTPUT || TIMELINE_WINDOW.length() > 0)
 	{
 		// chop off the .ini if it's there
 		if (deviceIniFilename.substr(deviceIniFilenameLength-4) == ".ini")
@@ -345,7 +394,8 @@ string MemorySystem::SetOutputFileName(string traceFilename)
 		filename = out.str();
 		for (int i=0; i<100; i++)
 		{
-			if (fileExists(path+filename+tmpNum.str()+".vis"))
+			if (fileExists(path+filename+tmpNum.str()+".vis") || fileExists(path+filename+tmpNum.str()+".stats") ||
+			    fileExists(path+filename+tmpNum.str()+".lat") || fileExists(path+filename+tmpNum.str()+".json"))
 			{
 				tmpNum.seekp(0);
 				tmpNum << "." << i;
@@ -396,33 +446,202 @@ void MemorySystem::mkdirIfNotExist(string path)
 	}
 }
 
+//a request is only accepted if the transaction queue has a free slot;
+//callers that are refused should hold on to the request and retry
 bool MemorySystem::WillAcceptTransaction()
 {
-	return true;
-//	return memoryController->WillAcceptTransaction();
+	return memoryController->WillAcceptTransaction();
 }
 
+//number of requests that will be accepted right now (credits)
+uint MemorySystem::AvailableSlots()
+{
+	return memoryController->AvailableSlots();
+}
+
+//refused requests are not kept; see MemorySystem.h
 bool MemorySystem::addTransaction(bool isWrite, uint64_t addr, uint64_t txID)
 {
 	TransactionType type = isWrite ? DATA_WRITE : DATA_READ;
 	Transaction trans(type,addr,NULL, txID);
+	trans.timeIssued = currentClockCycle;
 	// push_back in memoryController will make a copy of this during
 	// addTransaction so it's kosher for the reference to be local 
+	return memoryController->addTransaction(trans);
+}
 
-	if (memoryController->WillAcceptTransaction()) 
+//the first attempt stamps the transaction, so a caller that retries the
+//same object after a refusal gets its admission wait accounted for
+bool MemorySystem::addTransaction(Transaction &trans)
+{
+	if (trans.timeIssued == TRANSACTION_NOT_ISSUED)
 	{
-		return memoryController->addTransaction(trans); // will be true
+		trans.timeIssued = currentClockCycle;
 	}
-	else
+	return memoryController->addTransaction(trans);
+}
+
+//adds requests from the front of the batch until the transaction queue is
+//full; returns how many were accepted, the rest should be offered again later
+uint MemorySystem::addTransactions(const TransactionRequest *requests, uint count)
+{
+	uint i;
+	for (i=0;i<count;i++)
 	{
-		pendingTransactions.push_back(trans);
-		return true;
+		if (!addTransaction(requests[i].isWrite, requests[i].address, requests[i].id))
+		{
+			break;
+		}
 	}
+	return i;
 }
 
-bool MemorySystem::addTransaction(Transaction &trans)
+//runs the memory system for up to nCycles cycles. Completions that occur
+//along the way are written to completions[] rather than being reported
+//through the callbacks; the call returns early once fewer than
+//MAX_COMPLETIONS_PER_CYCLE free slots are left, so passing a capacity of
+//MAX_COMPLETIONS_PER_CYCLE runs until the next completion.
+//Returns the number of records written
+uint MemorySystem::advance(uint64_t nCycles, CompletionRecord *completions, uint capacity, uint64_t *cyclesElapsed)
 {
-	return memoryController->addTransaction(trans);
+	if (completions == NULL || capacity < MAX_COMPLETIONS_PER_CYCLE)
+	{
+		ERROR("== Error - advance() needs room for at least "<<MAX_COMPLETIONS_PER_CYCLE<<" completions");
+		exit(-1);
+	}
+
+	completionBuffer = completions;
+	completionCount = 0;
+
+	uint64_t i=0;
+	while (i < nCycles)
+	{
+		update();
+		i++;
+		if (capacity - completionCount < MAX_COMPLETIONS_PER_CYCLE)
+		{
+			break;
+		}
+	}
+
+	completionBuffer = NULL;
+	if (cyclesElapsed != NULL)
+	{
+		*cyclesElapsed = i;
+	}
+	return completionCount;
+}
+
+//sets up the submission and completion rings used by submitTransaction()
+//and pollCompletion(); must be called before any host thread uses them
+void MemorySystem::enableSubmissionRings(unsigned capacity)
+{
+	if (submissionRing != NULL)
+	{
+		return;
+	}
+	submissionRing = new LockFreeRing<SubmittedTransaction>(capacity);
+	completionRing = new LockFreeRing<CompletionRecord>(capacity);
+}
+
+//may be called from any thread; returns false if the ring is full, in
+//which case the caller should retry later
+bool MemorySystem::submitTransaction(unsigned producerID, uint64_t timestamp, bool isWrite, uint64_t addr, uint64_t txID)
+{
+	SubmittedTransaction s;
+	s.timestamp = timestamp;
+	s.id = txID;
+	s.address = addr;
+	s.producerID = producerID;
+	s.isWrite = isWrite;
+	return submissionRing->push(s);
+}
+
+//may be called from any thread; returns false if nothing has completed
+bool MemorySystem::pollCompletion(CompletionRecord &completion)
+{
+	return completionRing->pop(completion);
+}
+
+static bool submissionOrder(const SubmittedTransaction &a, const SubmittedTransaction &b)
+{
+	if (a.timestamp != b.timestamp)
+	{
+		return a.timestamp < b.timestamp;
+	}
+	return a.producerID < b.producerID;
+}
+
+//moves requests out of the submission ring and admits, in (timestamp,
+//producer) order, the requests whose timestamp has been reached, as many as
+//the transaction queue has room for. Requests stamped for a later cycle stay
+//staged so that the admission order doesn't depend on how the producer
+//threads happened to interleave. At most one ring's worth is staged, so a
+//full transaction queue backs up into the ring and submitTransaction() fails
+void MemorySystem::drainSubmissions()
+{
+	SubmittedTransaction s;
+	bool added = false;
+	while (stagedSubmissions.size() < submissionRing->capacity() && submissionRing->pop(s))
+	{
+		stagedSubmissions.push_back(s);
+		added = true;
+	}
+	if (added)
+	{
+		//stable so that one producer's requests with the same timestamp stay in order
+		stable_sort(stagedSubmissions.begin(), stagedSubmissions.end(), submissionOrder);
+	}
+
+	size_t i=0;
+	while (i < stagedSubmissions.size() && stagedSubmissions[i].timestamp <= currentClockCycle &&
+	        memoryController->WillAcceptTransaction())
+	{
+		const SubmittedTransaction &sub = stagedSubmissions[i];
+		Transaction trans(sub.isWrite ? DATA_WRITE : DATA_READ, sub.address, NULL, sub.id);
+		trans.sourceID = sub.producerID;
+		trans.timeIssued = sub.timestamp;
+		memoryController->addTransaction(trans);
+		i++;
+	}
+	if (i > 0)
+	{
+		stagedSubmissions.erase(stagedSubmissions.begin(), stagedSubmissions.begin()+i);
+		submissionsAdmitted += i;
+	}
+}
+
+//completions go to the advance() array if one is active, otherwise to the
+//completion ring if enabled, otherwise through the registered callbacks
+void MemorySystem::reportCompletion(bool isWrite, uint64_t txID, uint64_t addr, uint64_t issueCycle, uint64_t doneCycle)
+{
+	completionsReported++;
+	if (completionBuffer == NULL && completionRing == NULL)
+	{
+		Callback_t *cb = isWrite ? WriteDataDone : ReturnReadData;
+		if (cb != NULL)
+		{
+			(*cb)(systemID, addr, doneCycle, txID);
+		}
+		return;
+	}
+
+	CompletionRecord c;
+	c.id = txID;
+	c.address = addr;
+	c.issueCycle = issueCycle;
+	c.doneCycle = doneCycle;
+	c.isWrite = isWrite;
+
+	if (completionBuffer != NULL)
+	{
+		completionBuffer[completionCount++] = c;
+	}
+	else if (!completionOverflow.empty() || !completionRing->push(c))
+	{
+		//consumers are behind; hold on to it rather than stall the model
+		completionOverflow.push_back(c);
+	}
 }
 
 //prints statistics
@@ -456,9 +675,42 @@ void MemorySystem::update()
 			//write out the ini config values for the visualizer tool
 			IniReader::WriteValuesOut(visDataOut);
 		}	
+		if (BINARY_STATS_OUTPUT)
+		{
+			// same name as the vis file, but .stats
+			string statsOutputFilename = visOutputFilename;
+			statsOutputFilename.replace(statsOutputFilename.rfind(".vis"), 4, ".stats");
+			cerr << "writing binary stats to " <<statsOutputFilename<<endl;
+			epochStatsOut = new EpochStatsWriter(statsOutputFilename, systemID);
+		}
+		if (LATENCY_LOG_OUTPUT)
+		{
+			string latencyOutputFilename = visOutputFilename;
+			latencyOutputFilename.replace(latencyOutputFilename.rfind(".vis"), 4, ".lat");
+			cerr << "writing sampled transaction latencies to " <<latencyOutputFilename<<endl;
+			latencyLogOut = new LatencyLogWriter(latencyOutputFilename, systemID);
+		}
+		if (TIMELINE_WINDOW.length() > 0)
+		{
+			string timelineOutputFilename = visOutputFilename;
+			timelineOutputFilename.replace(timelineOutputFilename.rfind(".vis"), 4, ".json");
+			cerr << "writing a timeline ("<<TIMELINE_WINDOW<<") to " <<timelineOutputFilename<<endl;
+			timelineOut = new TimelineWriter(timelineOutputFilename, TIMELINE_WINDOW, systemID);
+		}
 	}
 	//PRINT(" ----------------- Memory System Update ------------------");
 
+	//requests from host threads are admitted before anything else happens
+	//this cycle, and completions that didn't fit last time get another try
+	if (submissionRing != NULL)
+	{
+		drainSubmissions();
+		while (!completionOverflow.empty() && completionRing->push(completionOverflow.front()))
+		{
+			completionOverflow.pop_front();
+		}
+	}
+
 	//updates the state of each of the objects
 	// NOTE - do not change order
 	for (size_t i=0;i<NUM_RANKS;i++)
@@ -466,12 +718,6 @@ void MemorySystem::update()
 		(*ranks)[i].update();
 	}
 
-	//pendingTransactions will only have stuff in it if MARSS is adding stuff
-	if (pendingTransactions.size() > 0 && memoryController->WillAcceptTransaction())
-	{
-		memoryController->addTransaction(pendingTransactions.front());
-		pendingTransactions.pop_front();
-	}
 	memoryController->update();
 
 	//simply increments the currentClockCycle field for each object
@@ -486,7 +732,6 @@ void MemorySystem::update()
 }
 
 
-#if (USE_SCIC_MEMSYS_QUERY == 1)
 void MemorySystem::RegisterCallbacks( Callback_t* readCB, Callback_t* writeCB, CB_HIST* histgramCB,
 									 void (*reportPower)(double bgpower, double burstpower,
 									 double refreshpower, double actprepower))
@@ -496,7 +741,6 @@ void MemorySystem::RegisterCallbacks( Callback_t* readCB, Callback_t* writeCB, C
 	ReportPower = reportPower;
 	_callbackforHistogram = histgramCB;
 }
-#endif
 
 void MemorySystem::RegisterCallbacks( Callback_t* readCB, Callback_t* writeCB,
                                       void (*reportPower)(double bgpower, double burstpower,
@@ -507,6 +751,11 @@ void MemorySystem::RegisterCallbacks( Callback_t* readCB, Callback_t* writeCB,
 	ReportPower = reportPower;
 }
 
+void MemorySystem::RegisterCommandCallback(CommandCallback_t *commandCB)
+{
+	CommandIssued = commandCB;
+}
+
 // static allocator for the library interface 
 MemorySystem *getMemorySystemInstance(uint id, string dev, string sys, string pwd, string trc, unsigned megsOfMemory)
 {
@@ -35,14 +35,16 @@
 #include "Rank.h"
 #include "Transaction.h"
 #include "Callback.h"
+#include "BatchTypes.h"
+#include "LockFreeRing.h"
 #include <deque>
 
 namespace DRAMSim
 {
 typedef CallbackBase_4Param<void,uint,uint64_t,uint64_t, uint64_t> Callback_t;
-#if (USE_SCIC_MEMSYS_QUERY == 1)
 typedef CallbackBase_3Param<void, uint,uint,uint> CB_HIST;
-#endif
+// (systemID, command, cycle it was put on the command bus)
+typedef CallbackBase_3Param<void, uint, const BusPacket *, uint64_t> CommandCallback_t;
 class MemorySystem : public SimulatorObject
 {
 public:
@@ -51,46 +53,87 @@ public:
 	MemorySystem(uint id, string dev, string sys, string pwd, string trc, unsigned megsOfMemory);
 	virtual ~MemorySystem();
 	void update();										
+	// both return false, and keep nothing, when the transaction queue is
+	// full: the caller must hold on to the request and offer it again in a
+	// later cycle. A refused Transaction should be offered again as the same
+	// object, since its admission wait is timed from its first offer; the
+	// (isWrite, addr, txID) form starts afresh on every call
 	bool addTransaction(Transaction &trans);			
 	bool addTransaction(bool isWrite, uint64_t addr, uint64_t txID);	
 
+	// batch interface: hand over a whole array of requests, then run the
+	// model for up to nCycles, collecting completions into the caller's array
+	// instead of going through the read/write callbacks
+	uint addTransactions(const TransactionRequest *requests, uint count);
+	uint advance(uint64_t nCycles, CompletionRecord *completions, uint capacity, uint64_t *cyclesElapsed = NULL);
+
+	// thread-safe interface: any number of host threads may submit into a
+	// bounded lock-free ring and poll completions from a second one. The
+	// submission ring is drained at the start of every update()
+	void enableSubmissionRings(unsigned capacity);
+	bool submitTransaction(unsigned producerID, uint64_t timestamp, bool isWrite, uint64_t addr, uint64_t txID);
+	bool pollCompletion(CompletionRecord &completion);
+
+	// called by the memory controller for every finished read or write
+	void reportCompletion(bool isWrite, uint64_t txID, uint64_t addr, uint64_t issueCycle, uint64_t doneCycle);
+
 	void printStats();
 	void printStats(bool unused);
 	bool WillAcceptTransaction();
+	uint AvailableSlots();
 	string SetOutputFileName(string tracefilename);
 	void RegisterCallbacks(
 	    Callback_t *readDone,
 	    Callback_t *writeDone,
 	    void (*reportPower)(double bgpower, double burstpower, double refreshpower, double actprepower));
-
-#if (USE_SCIC_MEMSYS_QUERY == 1)
 	void RegisterCallbacks( Callback_t* readCB, Callback_t* writeCB, CB_HIST* histgramCB,
 		void (*reportPower)(double bgpower, double burstpower,
 		double refreshpower, double actprepower));
-#endif
+	// observes every command the controller issues, NULL to stop
+	void RegisterCommandCallback(CommandCallback_t *commandCB);
 
 
 	// mostly for other simulators
 	void overrideSystemParam(string key, string value);
 	void overrideSystemParam(string kvpair);
 
+	// for tools that build many memory systems: the ones built after this
+	// write no vis, stats, latency log or timeline files, publish no shared
+	// stats and print no row heat or stalls, whatever their system ini says
+	static void disableSideOutputs();
+
 
 
 	//fields
 	// unfortunately, this is the easiest to keep C++ from initializing my members by default
 	MemoryController *memoryController;
 	vector<Rank> *ranks;
-	deque<Transaction> pendingTransactions; 
 
 	//output file
 	std::ofstream visDataOut;
+	//binary per-epoch stats, NULL unless BINARY_STATS_OUTPUT is set
+	EpochStatsWriter *epochStatsOut;
+	//live stats page, NULL unless SHARED_STATS_OUTPUT is set
+	SharedStatsWriter *sharedStatsOut;
+	//sampled per-transaction latencies, NULL unless LATENCY_LOG_OUTPUT is set
+	LatencyLogWriter *latencyLogOut;
+	//Chrome trace-event timeline, NULL unless TIMELINE_WINDOW is set
+	TimelineWriter *timelineOut;
 
 	//function pointers
 	Callback_t* ReturnReadData;
 	Callback_t* WriteDataDone;
-#if (USE_SCIC_MEMSYS_QUERY == 1)
 	CB_HIST * _callbackforHistogram;
-#endif
+	CommandCallback_t *CommandIssued;
+
+	//non-NULL only while advance() is running; completions are written here
+	CompletionRecord *completionBuffer;
+	uint completionCount;
+
+	//running count of reportCompletion() calls
+	uint64_t completionsReported;
+	//running count of requests taken from the submission ring into the transaction queue
+	uint64_t submissionsAdmitted;
 
 	//TODO: make this a functor as well?
 	static powerCallBack_t ReportPower;
@@ -99,6 +142,14 @@ public:
 
 private:
 	static void mkdirIfNotExist(string path);
+	static bool sideOutputsDisabled;
+	void drainSubmissions();
+
+	LockFreeRing<SubmittedTransaction> *submissionRing;
+	LockFreeRing<CompletionRecord> *completionRing;
+	vector<SubmittedTransaction> stagedSubmissions;
+	deque<CompletionRecord> completionOverflow;
+
 	string deviceIniFilename;
 	string systemIniFilename;
 	string traceFilename;
@@ -0,0 +1,249 @@
+/****************************************************************************
+*	 DRAMSim2: A Cycle Accurate DRAM simulator 
+*	 
+*	 Copyright (C) 2010   	Elliott Cooper-Balis
+*									Paul Rosenfeld 
+*									Bruce Jacob
+*									University of Maryland
+*
+*	 This program is free software: you can redistribute it and/or modify
+*	 it under the terms of the GNU General Public License as published by
+*	 the Free Software Foundation, either version 3 of the License, or
+*	 (at your option) any later version.
+*
+*	 This program is distributed in the hope that it will be useful,
+*	 but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	 MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	 GNU General Public License for more details.
+*
+*	 You should have received a copy of the GNU General Public License
+*	 along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*****************************************************************************/
+
+
+
+//MemorySystemThread.cpp
+//
+//Class file for the memory system model thread
+//
+
+#include "MemorySystemThread.h"
+#include <sched.h>
+
+using namespace DRAMSim;
+
+MemorySystemThread::MemorySystemThread(MemorySystem *ms, unsigned ringCapacity) :
+		memorySystem(ms),
+		running(false),
+		stopRequested(false),
+		released(0),
+		done(0),
+		submitted(0),
+		modelIdle(false),
+		waitingFor(0),
+		completionNotifier(NULL),
+		notifierArg(NULL)
+{
+	memorySystem->enableSubmissionRings(ringCapacity);
+	progress = (uint64_t)memorySystem->AvailableSlots() << 32;
+	pthread_mutex_init(&wakeLock, NULL);
+	pthread_cond_init(&modelWake, NULL);
+	pthread_cond_init(&waiterWake, NULL);
+}
+
+MemorySystemThread::~MemorySystemThread()
+{
+	stop();
+	pthread_cond_destroy(&waiterWake);
+	pthread_cond_destroy(&modelWake);
+	pthread_mutex_destroy(&wakeLock);
+}
+
+void MemorySystemThread::start()
+{
+	if (running)
+	{
+		return;
+	}
+	stopRequested = false;
+	if (pthread_create(&thread, NULL, threadMain, this) != 0)
+	{
+		ERROR("== Error - could not start the memory system thread");
+		exit(-1);
+	}
+	running = true;
+}
+
+//finishes every released cycle, then joins the model thread
+void MemorySystemThread::stop()
+{
+	if (!running)
+	{
+		return;
+	}
+	pthread_mutex_lock(&wakeLock);
+	__atomic_store_n(&stopRequested, true, __ATOMIC_RELEASE);
+	pthread_cond_signal(&modelWake);
+	pthread_mutex_unlock(&wakeLock);
+	pthread_join(thread, NULL);
+	running = false;
+}
+
+//free slots less the requests not admitted yet; only admissions fill the
+//	transaction queue, so this never overstates the room in later cycles
+bool MemorySystemThread::roomFor(uint64_t progressWord) const
+{
+	uint32_t freeSlots = progressWord >> 32;
+	uint32_t pending = (uint32_t)submitted - (uint32_t)progressWord;
+	return freeSlots > pending;
+}
+
+//whether addTransaction() would take a request right before the next
+//cycle's update(); only waits for the model thread when the last cycle it
+//published leaves no room
+bool MemorySystemThread::WillAcceptTransaction()
+{
+	if (roomFor(__atomic_load_n(&progress, __ATOMIC_ACQUIRE)))
+	{
+		return true;
+	}
+	waitForCycle(released);
+	return roomFor(__atomic_load_n(&progress, __ATOMIC_ACQUIRE));
+}
+
+//the request is admitted in the next cycle released, exactly as if
+//addTransaction() had been called right before that cycle's update()
+bool MemorySystemThread::submitTransaction(bool isWrite, uint64_t addr, uint64_t txID)
+{
+	if (!WillAcceptTransaction() || !memorySystem->submitTransaction(0, released, isWrite, addr, txID))
+	{
+		return false;
+	}
+	submitted++;
+	return true;
+}
+
+void MemorySystemThread::releaseCycles(uint64_t nCycles)
+{
+	__atomic_store_n(&released, released + nCycles, __ATOMIC_RELEASE);
+	//pairs with the fence in waitForRelease()
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&modelIdle, __ATOMIC_RELAXED))
+	{
+		pthread_mutex_lock(&wakeLock);
+		pthread_cond_signal(&modelWake);
+		pthread_mutex_unlock(&wakeLock);
+	}
+}
+
+//blocks the caller until the model thread has finished the given number of cycles
+void MemorySystemThread::waitForCycle(uint64_t cycle)
+{
+	for (unsigned i=0; cyclesDone() < cycle; i++)
+	{
+		if (i < MODEL_THREAD_SPIN)
+		{
+			sched_yield();
+			continue;
+		}
+		pthread_mutex_lock(&wakeLock);
+		__atomic_store_n(&waitingFor, cycle, __ATOMIC_RELAXED);
+		__atomic_thread_fence(__ATOMIC_SEQ_CST);
+		while (cyclesDone() < cycle)
+		{
+			pthread_cond_wait(&waiterWake, &wakeLock);
+		}
+		__atomic_store_n(&waitingFor, 0, __ATOMIC_RELAXED);
+		pthread_mutex_unlock(&wakeLock);
+	}
+}
+
+bool MemorySystemThread::pollCompletion(CompletionRecord &completion)
+{
+	return memorySystem->pollCompletion(completion);
+}
+
+void MemorySystemThread::setCompletionNotifier(void (*notifier)(void *), void *arg)
+{
+	completionNotifier = notifier;
+	notifierArg = arg;
+}
+
+void *MemorySystemThread::threadMain(void *arg)
+{
+	((MemorySystemThread *)arg)->run();
+	return NULL;
+}
+
+void MemorySystemThread::run()
+{
+	uint64_t cycle = 0;
+	unsigned idlePasses = 0;
+	while (true)
+	{
+		uint64_t target = __atomic_load_n(&released, __ATOMIC_ACQUIRE);
+		if (cycle == target)
+		{
+			//check for stop only once there's nothing left to do
+			if (__atomic_load_n(&stopRequested, __ATOMIC_ACQUIRE) &&
+			        cycle == __atomic_load_n(&released, __ATOMIC_ACQUIRE))
+			{
+				break;
+			}
+			if (++idlePasses < MODEL_THREAD_SPIN)
+			{
+				sched_yield();
+			}
+			else
+			{
+				waitForRelease(cycle);
+				idlePasses = 0;
+			}
+			continue;
+		}
+		idlePasses = 0;
+
+		while (cycle < target)
+		{
+			uint64_t completionsBefore = memorySystem->completionsReported;
+			memorySystem->update();
+			cycle++;
+			__atomic_store_n(&progress, ((uint64_t)memorySystem->AvailableSlots() << 32) |
+			                 (uint32_t)memorySystem->submissionsAdmitted, __ATOMIC_RELEASE);
+			__atomic_store_n(&done, cycle, __ATOMIC_RELEASE);
+			wakeWaiter(cycle);
+			if (completionNotifier != NULL && memorySystem->completionsReported != completionsBefore)
+			{
+				(*completionNotifier)(notifierArg);
+			}
+		}
+	}
+}
+
+//sleeps until more cycles are released or the thread is asked to stop
+void MemorySystemThread::waitForRelease(uint64_t cycle)
+{
+	pthread_mutex_lock(&wakeLock);
+	__atomic_store_n(&modelIdle, true, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	while (__atomic_load_n(&released, __ATOMIC_ACQUIRE) == cycle && !__atomic_load_n(&stopRequested, __ATOMIC_ACQUIRE))
+	{
+		pthread_cond_wait(&modelWake, &wakeLock);
+	}
+	__atomic_store_n(&modelIdle, false, __ATOMIC_RELAXED);
+	pthread_mutex_unlock(&wakeLock);
+}
+
+//pairs with the fence in waitForCycle()
+void MemorySystemThread::wakeWaiter(uint64_t cycle)
+{
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	uint64_t waited = __atomic_load_n(&waitingFor, __ATOMIC_RELAXED);
+	if (waited != 0 && cycle >= waited)
+	{
+		pthread_mutex_lock(&wakeLock);
+		pthread_cond_signal(&waiterWake);
+		pthread_mutex_unlock(&wakeLock);
+	}
+}
@@ -0,0 +1,102 @@
+/****************************************************************************
+*	 DRAMSim2: A Cycle Accurate DRAM simulator 
+*	 
+*	 Copyright (C) 2010   	Elliott Cooper-Balis
+*									Paul Rosenfeld 
+*									Bruce Jacob
+*									University of Maryland
+*
+*	 This program is free software: you can redistribute it and/or modify
+*	 it under the terms of the GNU General Public License as published by
+*	 the Free Software Foundation, either version 3 of the License, or
+*	 (at your option) any later version.
+*
+*	 This program is distributed in the hope that it will be useful,
+*	 but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	 MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	 GNU General Public License for more details.
+*
+*	 You should have received a copy of the GNU General Public License
+*	 along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*****************************************************************************/
+#ifndef MEMORYSYSTEMTHREAD_H
+#define MEMORYSYSTEMTHREAD_H
+
+//MemorySystemThread.h
+//
+//Runs a MemorySystem on its own OS thread. The front end hands requests
+//over through the memory system's submission ring, stamped with the cycle
+//they belong to, and then releases cycles with releaseCycles(); the model
+//thread calls update() for every released cycle and publishes its progress.
+//Completions come back through the completion ring. Since requests carry
+//their cycle, the command stream is identical to calling update() inline;
+//the front end only sees completions a fixed number of cycles later.
+//A request is refused exactly when addTransaction() would refuse it.
+//
+//Both sides spin for MODEL_THREAD_SPIN passes when they run out of work,
+//then sleep until the other one wakes them.
+//
+
+#include "MemorySystem.h"
+#include <pthread.h>
+
+#define MODEL_THREAD_SPIN 256
+
+namespace DRAMSim
+{
+class MemorySystemThread
+{
+public:
+	MemorySystemThread(MemorySystem *ms, unsigned ringCapacity);
+	virtual ~MemorySystemThread();
+
+	void start();
+	void stop();
+
+	//front end side, from a single thread
+	bool WillAcceptTransaction();
+	bool submitTransaction(bool isWrite, uint64_t addr, uint64_t txID);
+	void releaseCycles(uint64_t nCycles);
+	uint64_t cyclesReleased() const { return released; }
+	uint64_t cyclesDone() const { return __atomic_load_n(&done, __ATOMIC_ACQUIRE); }
+	void waitForCycle(uint64_t cycle);
+	bool pollCompletion(CompletionRecord &completion);
+
+	//called on the model thread whenever a cycle produced completions
+	void setCompletionNotifier(void (*notifier)(void *), void *arg);
+
+private:
+	static void *threadMain(void *arg);
+	void run();
+	void waitForRelease(uint64_t cycle);
+	void wakeWaiter(uint64_t cycle);
+	bool roomFor(uint64_t progressWord) const;
+
+	MemorySystem *memorySystem;
+	pthread_t thread;
+	bool running;
+	bool stopRequested;
+
+	uint64_t released;	// written by the front end
+	uint64_t done;		// written by the model thread
+
+	//requests the front end got accepted, and the model's free transaction
+	//	queue slots (high half) and requests admitted (low half, mod 2^32)
+	//	as of its last finished cycle
+	uint64_t submitted;
+	uint64_t progress;
+
+	//a side sets its flag before sleeping; the other side signals if it sees it
+	pthread_mutex_t wakeLock;
+	pthread_cond_t modelWake;
+	pthread_cond_t waiterWake;
+	bool modelIdle;
+	uint64_t waitingFor;	// the cycle waitForCycle() sleeps on, 0 if none
+
+	void (*completionNotifier)(void *);
+	void *notifierArg;
+};
+}
+
+#endif
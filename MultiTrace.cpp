@@ -0,0 +1,162 @@
+/****************************************************************************
+*	 DRAMSim2: A Cycle Accurate DRAM simulator 
+*	 
+*	 Copyright (C) 2010   	Elliott Cooper-Balis
+*									Paul Rosenfeld 
+*									Bruce Jacob
+*									University of Maryland
+*
+*	 This program is free software: you can redistribute it and/or modify
+*	 it under the terms of the GNU General Public License as published by
+*	 the Free Software Foundation, either version 3 of the License, or
+*	 (at your option) any later version.
+*
+*	 This program is distributed in the hope that it will be useful,
+*	 but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	 MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	 GNU General Public License for more details.
+*
+*	 You should have received a copy of the GNU General Public License
+*	 along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*****************************************************************************/
+
+
+
+//MultiTrace.cpp
+//
+//Class file for the multi-trace source and merge readers
+//
+
+#include "MultiTrace.h"
+#include <cstdlib>
+
+using namespace DRAMSim;
+using namespace std;
+
+SourceTraceReader::SourceTraceReader(TraceReader *source, unsigned sourceID, double timeScale, uint64_t addressOffset) :
+		source(source),
+		sourceID(sourceID),
+		timeScale(timeScale),
+		addressOffset(addressOffset),
+		untimed(source->sourceFormat() == misc),
+		recordIndex(0)
+{
+}
+
+SourceTraceReader::~SourceTraceReader()
+{
+	delete source;
+}
+
+bool SourceTraceReader::next(TraceRecord &record)
+{
+	if (!source->next(record))
+	{
+		return false;
+	}
+	uint64_t cycle = untimed ? recordIndex : record.cycle;
+	recordIndex++;
+	record.cycle = (uint64_t)(cycle * timeScale);
+	record.address += addressOffset;
+	record.sourceID = sourceID;
+	return true;
+}
+
+SourceTraceReader *SourceTraceReader::open(const string &spec, unsigned sourceID, const string &pwd, string *filename)
+{
+	size_t comma = spec.find(',');
+	string traceFileName = spec.substr(0, comma);
+	double timeScale = 1.0;
+	uint64_t addressOffset = 0;
+
+	while (comma != string::npos)
+	{
+		size_t start = comma + 1;
+		comma = spec.find(',', start);
+		string field = spec.substr(start, comma == string::npos ? string::npos : comma - start);
+		size_t equalsign = field.find('=');
+		string key = field.substr(0, equalsign);
+		const char *value = equalsign == string::npos ? "" : field.c_str() + equalsign + 1;
+
+		if (key == "scale")
+		{
+			timeScale = atof(value);
+		}
+		else if (key == "rate")
+		{
+			double rate = atof(value);
+			timeScale = rate > 0 ? 1.0 / rate : 0;
+		}
+		else if (key == "offset")
+		{
+			addressOffset = strtoull(value, NULL, 0);
+		}
+		else
+		{
+			ERROR("== Unknown trace option '"<<field<<"' (scale=#, rate=# or offset=#)");
+			exit(-1);
+		}
+		if (timeScale <= 0)
+		{
+			ERROR("== Trace scale and rate must be positive in '"<<spec<<"'");
+			exit(-1);
+		}
+	}
+
+	//ignore the pwd argument if the argument is an absolute path
+	if (pwd.length() > 0 && traceFileName[0] != '/')
+	{
+		traceFileName = pwd + "/" + traceFileName;
+	}
+	if (filename != NULL)
+	{
+		*filename = traceFileName;
+	}
+
+	DEBUG("== Loading trace file '"<<traceFileName<<"' as source "<<sourceID<<" == ");
+	return new SourceTraceReader(TraceReader::open(traceFileName), sourceID, timeScale, addressOffset);
+}
+
+MergedTraceReader::MergedTraceReader(const vector<TraceReader *> &sources) :
+		sources(sources),
+		heads(sources.size())
+{
+	for (unsigned i=0; i<sources.size(); i++)
+	{
+		if (sources[i]->next(heads[i]))
+		{
+			heap.push(HeapEntry(heads[i].cycle, i));
+		}
+	}
+}
+
+MergedTraceReader::~MergedTraceReader()
+{
+	//free the data of records nobody consumed
+	while (!heap.empty())
+	{
+		free(heads[heap.top().second].data);
+		heap.pop();
+	}
+	for (size_t i=0; i<sources.size(); i++)
+	{
+		delete sources[i];
+	}
+}
+
+bool MergedTraceReader::next(TraceRecord &record)
+{
+	if (heap.empty())
+	{
+		return false;
+	}
+	unsigned i = heap.top().second;
+	heap.pop();
+	record = heads[i];
+	if (sources[i]->next(heads[i]))
+	{
+		heap.push(HeapEntry(heads[i].cycle, i));
+	}
+	return true;
+}
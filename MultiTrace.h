@@ -0,0 +1,83 @@
+/****************************************************************************
+*	 DRAMSim2: A Cycle Accurate DRAM simulator 
+*	 
+*	 Copyright (C) 2010   	Elliott Cooper-Balis
+*									Paul Rosenfeld 
+*									Bruce Jacob
+*									University of Maryland
+*
+*	 This program is free software: you can redistribute it and/or modify
+*	 it under the terms of the GNU General Public License as published by
+*	 the Free Software Foundation, either version 3 of the License, or
+*	 (at your option) any later version.
+*
+*	 This program is distributed in the hope that it will be useful,
+*	 but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	 MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	 GNU General Public License for more details.
+*
+*	 You should have received a copy of the GNU General Public License
+*	 along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*****************************************************************************/
+#ifndef MULTITRACE_H
+#define MULTITRACE_H
+
+//MultiTrace.h
+//
+//Mixes several per-core traces into one request stream. SourceTraceReader
+//tags the records of one trace with its source id, scales its timestamps
+//and moves it to its own part of the address space; MergedTraceReader
+//merges any number of sources on their timestamps (a k-way merge, ties go
+//to the lower source id). Misc traces carry no timestamps, so their
+//records are numbered 0, 1, 2... instead, i.e. one request per cycle
+//before scaling.
+//
+
+#include "TraceReader.h"
+#include <queue>
+
+namespace DRAMSim
+{
+class SourceTraceReader : public TraceReader
+{
+public:
+	//takes ownership of source; timestamps are multiplied by timeScale
+	//(2 halves the request rate) and addressOffset is added to every address
+	SourceTraceReader(TraceReader *source, unsigned sourceID, double timeScale, uint64_t addressOffset);
+	virtual ~SourceTraceReader();
+	virtual bool next(TraceRecord &record);
+	virtual TraceType sourceFormat() const { return source->sourceFormat(); }
+
+	//parses "FILENAME[,scale=#][,rate=#][,offset=#]" (rate=# is scale=1/#)
+	static SourceTraceReader *open(const string &spec, unsigned sourceID, const string &pwd, string *filename = NULL);
+
+private:
+	TraceReader *source;
+	unsigned sourceID;
+	double timeScale;
+	uint64_t addressOffset;
+	bool untimed;
+	uint64_t recordIndex;
+};
+
+class MergedTraceReader : public TraceReader
+{
+public:
+	//takes ownership of the sources
+	MergedTraceReader(const vector<TraceReader *> &sources);
+	virtual ~MergedTraceReader();
+	virtual bool next(TraceRecord &record);
+	virtual TraceType sourceFormat() const { return sources[0]->sourceFormat(); }
+
+private:
+	//(timestamp, source index) of each source's next record, smallest first
+	typedef pair<uint64_t, unsigned> HeapEntry;
+
+	vector<TraceReader *> sources;
+	vector<TraceRecord> heads;
+	priority_queue<HeapEntry, vector<HeapEntry>, greater<HeapEntry> > heap;
+};
+}
+
+#endif
@@ -25,7 +25,10 @@
 
 #ifndef PRINT_MACROS_H
 #define PRINT_MACROS_H
-extern int SHOW_SIM_OUTPUT; //enable or disable PRINT() statements -- set by flag in TraceBasedSim.cpp
+
+#include "AsyncLog.h"
+
+extern int SHOW_SIM_OUTPUT; //enable or disable PRINT() statements -- defined in MemorySystem.cpp, set by flag in TraceBasedSim.cpp
 
 #define ERROR(str) std::cerr<<"[ERROR ("<<__FILE__<<":"<<__LINE__<<")]: "<<str<<std::endl;
 
@@ -45,17 +48,25 @@ extern int SHOW_SIM_OUTPUT; //enable or disable PRINT() statements -- set by fla
 	#define DEBUGN(str) ;
 	#define PRINT(str) ;
 	#define PRINTN(str) ;
+	#define PRINT_DEFERRED(event, str) ;
+	#define SIM_OUTPUT_ON 0
 #else
 	#ifdef LOG_OUTPUT
 		namespace DRAMSim {
 		extern std::ofstream dramsim_log;
 		}
-		#define PRINT(str)  { DRAMSim::dramsim_log <<str<<std::endl; }
-		#define PRINTN(str) { DRAMSim::dramsim_log <<str; }
+		#define SIM_OUTPUT_ON 1
+		#define SIM_OUTPUT_STREAM DRAMSim::dramsim_log
 	#else
-		#define PRINT(str)  if(SHOW_SIM_OUTPUT) { std::cout <<str<<std::endl; }
-		#define PRINTN(str) if(SHOW_SIM_OUTPUT) { std::cout <<str; }
+		#define SIM_OUTPUT_ON SHOW_SIM_OUTPUT
+		#define SIM_OUTPUT_STREAM std::cout
 	#endif
+	// with ASYNC_LOG_OUTPUT the line is queued for the log writer thread (AsyncLog.h)
+	#define PRINT(str)  if(SIM_OUTPUT_ON) { if (DRAMSim::AsyncLog::active) { DRAMSim::AsyncLog::beginText() <<str<<'\n'; DRAMSim::AsyncLog::endText(); } else { SIM_OUTPUT_STREAM <<str<<std::endl; } }
+	#define PRINTN(str) if(SIM_OUTPUT_ON) { if (DRAMSim::AsyncLog::active) { DRAMSim::AsyncLog::beginText() <<str; DRAMSim::AsyncLog::endText(); } else { SIM_OUTPUT_STREAM <<str; } }
+	// same as PRINT(str), but the asynchronous backend queues the raw fields
+	// with AsyncLog::event and formats them later
+	#define PRINT_DEFERRED(event, str) if(SIM_OUTPUT_ON) { if (DRAMSim::AsyncLog::active) { DRAMSim::AsyncLog::event; } else { SIM_OUTPUT_STREAM <<str<<std::endl; } }
 #endif
 
 #endif /*PRINT_MACROS_H*/
@@ -76,7 +76,7 @@ void Rank::receiveFromBus(BusPacket *packet)
 {
 	BusPacket returnPacket;
 
-	if (DEBUG_BUS)
+	if (TRACE_ON(TRACE_COMMANDS, DEBUG_BUS))
 	{
 		PRINTN(" -- R" << this->id << " Receiving On Bus    : ");
 		packet->print();
@@ -320,13 +320,14 @@ void Rank::update()
 		// ready to go out on the bus
 
 		outgoingDataPacket = readReturnPacket[0];
+		outgoingDataPacket->stamps.data = currentClockCycle;
 		dataCyclesLeft = BL/2;
 
 		// remove the packet from the ranks
 		readReturnPacket.erase(readReturnPacket.begin());
 		readReturnCountdown.erase(readReturnCountdown.begin());
 
-		if (DEBUG_BUS)
+		if (TRACE_ON(TRACE_COMMANDS, DEBUG_BUS))
 		{
 			PRINTN(" -- R" << this->id << " Issuing On Data Bus : ");
 			outgoingDataPacket->print();
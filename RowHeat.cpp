@@ -0,0 +1,149 @@
+/****************************************************************************
+*	 DRAMSim2: A Cycle Accurate DRAM simulator 
+*	 
+*	 Copyright (C) 2010   	Elliott Cooper-Balis
+*									Paul Rosenfeld 
+*									Bruce Jacob
+*									University of Maryland
+*
+*	 This program is free software: you can redistribute it and/or modify
+*	 it under the terms of the GNU General Public License as published by
+*	 the Free Software Foundation, either version 3 of the License, or
+*	 (at your option) any later version.
+*
+*	 This program is distributed in the hope that it will be useful,
+*	 but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	 MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	 GNU General Public License for more details.
+*
+*	 You should have received a copy of the GNU General Public License
+*	 along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*****************************************************************************/
+
+
+
+//RowHeat.cpp
+//
+//Class file for the row activation heat sketch
+//
+
+#include "RowHeat.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace DRAMSim;
+using namespace std;
+
+namespace
+{
+bool hotterThan(const RowHeatEntry &a, const RowHeatEntry &b)
+{
+	return a.activates > b.activates;
+}
+}
+
+RowHeatSketch::RowHeatSketch()
+{
+	reset();
+}
+
+void RowHeatSketch::enable()
+{
+	counters.assign(ROW_HEAT_DEPTH << ROW_HEAT_WIDTH_BITS, 0);
+	registers.assign(ROW_HEAT_CLASSES << ROW_HEAT_DISTINCT_BITS, 0);
+	reset();
+}
+
+void RowHeatSketch::reset()
+{
+	fill(counters.begin(), counters.end(), 0);
+	fill(registers.begin(), registers.end(), 0);
+	totalActivates = 0;
+	topRows = 0;
+}
+
+//HyperLogLog estimate, with linear counting while many registers are empty
+double RowHeatSketch::distinctRows(size_t c) const
+{
+	if (registers.empty())
+	{
+		return 0.0;
+	}
+	const double m = 1 << ROW_HEAT_DISTINCT_BITS;
+	const uint8_t *reg = &registers[c << ROW_HEAT_DISTINCT_BITS];
+	double sum = 0.0;
+	size_t zeros = 0;
+	for (size_t j=0; j < (1U << ROW_HEAT_DISTINCT_BITS); j++)
+	{
+		sum += ldexp(1.0, -reg[j]);
+		if (reg[j] == 0)
+		{
+			zeros++;
+		}
+	}
+	double estimate = 0.7213 / (1.0 + 1.079 / m) * m * m / sum;
+	if (estimate <= 2.5 * m && zeros > 0)
+	{
+		estimate = m * log(m / zeros);
+	}
+	return estimate;
+}
+
+uint64_t RowHeatSketch::Rows() const
+{
+	return llround(distinctRows(0));
+}
+
+uint64_t RowHeatSketch::RowsInClass(size_t c) const
+{
+	double rows = distinctRows(c);
+	if (c < ROW_HEAT_CLASSES-1)
+	{
+		rows -= distinctRows(c+1);
+	}
+	return rows > 0.0 ? llround(rows) : 0;
+}
+
+//keeps the key if it is already a top row, there is room, or it is hotter
+//than the coldest top row, which it then replaces
+void RowHeatSketch::offer(uint64_t key, uint64_t estimate)
+{
+	size_t coldest = 0;
+	for (size_t i=0; i<topRows; i++)
+	{
+		if (topKeys[i] == key)
+		{
+			topCounts[i] = estimate;
+			return;
+		}
+		if (topCounts[i] < topCounts[coldest])
+		{
+			coldest = i;
+		}
+	}
+	if (topRows < ROW_HEAT_TOP_ROWS)
+	{
+		coldest = topRows++;
+	}
+	else if (estimate <= topCounts[coldest])
+	{
+		return;
+	}
+	topKeys[coldest] = key;
+	topCounts[coldest] = estimate;
+}
+
+vector<RowHeatEntry> RowHeatSketch::TopRows() const
+{
+	vector<RowHeatEntry> rows(topRows);
+	for (size_t i=0; i<topRows; i++)
+	{
+		rows[i].rank = topKeys[i] >> 48;
+		rows[i].bank = (topKeys[i] >> 32) & 0xFFFF;
+		rows[i].row = topKeys[i] & 0xFFFFFFFF;
+		rows[i].activates = topCounts[i];
+	}
+	sort(rows.begin(), rows.end(), hotterThan);
+	return rows;
+}
@@ -0,0 +1,167 @@
+/****************************************************************************
+*	 DRAMSim2: A Cycle Accurate DRAM simulator 
+*	 
+*	 Copyright (C) 2010   	Elliott Cooper-Balis
+*									Paul Rosenfeld 
+*									Bruce Jacob
+*									University of Maryland
+*
+*	 This program is free software: you can redistribute it and/or modify
+*	 it under the terms of the GNU General Public License as published by
+*	 the Free Software Foundation, either version 3 of the License, or
+*	 (at your option) any later version.
+*
+*	 This program is distributed in the hope that it will be useful,
+*	 but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	 MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	 GNU General Public License for more details.
+*
+*	 You should have received a copy of the GNU General Public License
+*	 along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*****************************************************************************/
+
+
+
+#ifndef ROWHEAT_H
+#define ROWHEAT_H
+
+//RowHeat.h
+//
+//Row activation heat in a fixed amount of memory. ACTs are counted per
+//(rank, bank, row) in a count-min sketch of ROW_HEAT_DEPTH rows of
+//ROW_HEAT_WIDTH counters with conservative update (only the counters at the
+//minimum are raised), so a row's count can be overestimated when it shares
+//all of its counters with hotter rows but never underestimated. The
+//ROW_HEAT_TOP_ROWS rows with the highest counts are kept next to it.
+//
+//The rows are classed by their estimated count in powers of two (activated
+//once, 2-3 times, 4-7 times, ...). Every class has a HyperLogLog distinct
+//counter that takes each row whose estimate has reached the class, and the
+//rows in a class are the difference of two neighbouring counters, so the
+//distribution is itself an estimate (about 2% off for large classes).
+//An ACT costs ROW_HEAT_DEPTH counter updates, usually one register compare
+//and a scan of the top rows.
+//
+
+#include <cstddef>
+#include <vector>
+#include <stdint.h>
+
+#define ROW_HEAT_DEPTH 4
+#define ROW_HEAT_WIDTH_BITS 16	// 2^16 counters per hash row, 1MB in all
+#define ROW_HEAT_TOP_ROWS 16
+#define ROW_HEAT_CLASSES 24	// the last class takes all the rows above it
+#define ROW_HEAT_DISTINCT_BITS 12	// 2^12 registers per class, 96KB in all
+
+namespace DRAMSim
+{
+struct RowHeatEntry
+{
+	unsigned rank;
+	unsigned bank;
+	unsigned row;
+	uint64_t activates;
+};
+
+class RowHeatSketch
+{
+public:
+	RowHeatSketch();
+
+	void activate(unsigned rank, unsigned bank, unsigned row)
+	{
+		uint64_t hash = mix(((uint64_t)rank << 48) | ((uint64_t)bank << 32) | row);
+		size_t index[ROW_HEAT_DEPTH];
+		uint32_t estimate = hashes(hash, index);
+
+		//conservative update: the estimate goes up by exactly one
+		for (size_t d=0; d<ROW_HEAT_DEPTH; d++)
+		{
+			if (counters[index[d]] == estimate)
+			{
+				counters[index[d]]++;
+			}
+		}
+		totalActivates++;
+
+		//add the row to the distinct counter of every class up to its own;
+		//a class never holds a register above the one below it, so the scan
+		//down stops at the first class that already has the row
+		size_t reg = hash >> (64 - ROW_HEAT_DISTINCT_BITS);
+		uint8_t rho = __builtin_clzll((hash << ROW_HEAT_DISTINCT_BITS) | (1ULL << (ROW_HEAT_DISTINCT_BITS-1))) + 1;
+		for (size_t c=rowClass((uint64_t)estimate+1)+1; c-- > 0;)
+		{
+			uint8_t &r = registers[(c << ROW_HEAT_DISTINCT_BITS) + reg];
+			if (r >= rho)
+			{
+				break;
+			}
+			r = rho;
+		}
+		offer(((uint64_t)rank << 48) | ((uint64_t)bank << 32) | row, estimate+1);
+	}
+	//sizes the counters; until then the sketch takes no ACTs
+	void enable();
+	void reset();
+
+	uint64_t Activates() const { return totalActivates; }
+	//estimated rows activated at least once, and those in one count class
+	uint64_t Rows() const;
+	uint64_t RowsInClass(size_t c) const;
+	static uint64_t classLow(size_t c) { return 1ULL << c; }
+	static uint64_t classHigh(size_t c) { return c == ROW_HEAT_CLASSES-1 ? UINT64_MAX : (2ULL << c) - 1; }
+	//the hottest rows, hottest first
+	std::vector<RowHeatEntry> TopRows() const;
+
+private:
+	//splitmix64 finalizer
+	static uint64_t mix(uint64_t key)
+	{
+		key ^= key >> 30;
+		key *= 0xbf58476d1ce4e5b9ULL;
+		key ^= key >> 27;
+		key *= 0x94d049bb133111ebULL;
+		key ^= key >> 31;
+		return key;
+	}
+	//fills in the counter of every hash row and returns the key's estimate
+	uint32_t hashes(uint64_t hash, size_t index[ROW_HEAT_DEPTH]) const
+	{
+		//double hashing for the ROW_HEAT_DEPTH rows
+		size_t mask = (1 << ROW_HEAT_WIDTH_BITS) - 1;
+		size_t h1 = hash & mask;
+		size_t h2 = (hash >> 32) | 1;
+		uint32_t estimate = UINT32_MAX;
+		for (size_t d=0; d<ROW_HEAT_DEPTH; d++)
+		{
+			index[d] = (d << ROW_HEAT_WIDTH_BITS) + ((h1 + d*h2) & mask);
+			if (counters[index[d]] < estimate)
+			{
+				estimate = counters[index[d]];
+			}
+		}
+		return estimate;
+	}
+	static size_t rowClass(uint64_t count)
+	{
+		size_t c = 63 - __builtin_clzll(count);
+		return c < ROW_HEAT_CLASSES ? c : ROW_HEAT_CLASSES-1;
+	}
+	void offer(uint64_t key, uint64_t estimate);
+	//rows whose estimate has reached class c
+	double distinctRows(size_t c) const;
+
+	std::vector<uint32_t> counters;
+	uint64_t totalActivates;
+	//ROW_HEAT_CLASSES distinct counters of 2^ROW_HEAT_DISTINCT_BITS registers
+	std::vector<uint8_t> registers;
+
+	//unsorted; the key packs rank, bank and row as in activate()
+	uint64_t topKeys[ROW_HEAT_TOP_ROWS];
+	uint64_t topCounts[ROW_HEAT_TOP_ROWS];
+	size_t topRows;
+};
+}
+
+#endif
@@ -31,16 +31,10 @@
 
 
 
-#if (USE_SCIC_MEMSYS_QUERY == 1)
 extern unsigned NUM_DEVICES;
 extern unsigned NUM_RANKS;
 extern uint BL;
-#endif
 
-#ifndef _SIM_
-int SHOW_SIM_OUTPUT = 1;
-ofstream visDataOut; //mostly used in MemoryController
-#endif
 //////////////////////////////////////////////////////////////////////////////// 
 //
 // Method:    runSystem
@@ -135,7 +129,23 @@ void SCIC::runSystem()
 			//DEBUG("SC Memory System received address :" << std::hex << trans.address << std::dec);
 
 			alignTransactionAddress(trans);
-			bIssued	= _pLegacyMemorySystem->addTransaction(trans);
+			if(_pModelThread != NULL)
+			{
+				bIssued = _pModelThread->submitTransaction(type == DATA_WRITE, trans.address, trans.id);
+			}
+			else
+			{
+				if(_bRefused == true && _refusedTrans.id == trans.id && _refusedTrans.address == trans.address)
+				{
+					trans.timeIssued = _refusedTrans.timeIssued;
+				}
+				bIssued	= _pLegacyMemorySystem->addTransaction(trans);
+				_bRefused = !bIssued;
+				if(_bRefused == true)
+				{
+					_refusedTrans = trans;
+				}
+			}
 
 			if(bIssued == false)
 			{
@@ -152,17 +162,14 @@ void SCIC::runSystem()
 		//
 		// No matter what, the this system interface provides clock signal to memory system.
 		//
-		_pLegacyMemorySystem->update();
-		_nCurrentClk++;
+		stepMemorySystem();
 #else
 		if(_bInitialTime == false)
 		{
 			//
 			// No matter what, the this system interface provides clock signal to memory system.
 			//
-			_pLegacyMemorySystem->update();
-			_nCurrentClk++;
-
+			stepMemorySystem();
 		}
 		else
 		{
@@ -175,6 +182,181 @@ void SCIC::runSystem()
 
 
 
+//////////////////////////////////////////////////////////////////////////////// 
+//
+// Method:    stepMemorySystem
+// FullName:  SCIC::stepMemorySystem
+// Access:    public 
+// Returns:   void
+//
+// Descriptions - clocks the memory system once. Inline, this is just update();
+// in asynchronous mode the cycle is released to the model thread, which
+// runs it concurrently with the rest of the SystemC model.
+// 
+//////////////////////////////////////////////////////////////////////////////
+void SCIC::stepMemorySystem()
+{
+	if(_pModelThread == NULL)
+	{
+		_pLegacyMemorySystem->update();
+		_nCurrentClk++;
+	}
+	else
+	{
+		_pModelThread->releaseCycles(1);
+		_nCurrentClk++;
+		deliverAsyncCompletions();
+	}
+}
+
+
+
+//////////////////////////////////////////////////////////////////////////////// 
+//
+// Method:    deliverAsyncCompletions
+// FullName:  SCIC::deliverAsyncCompletions
+// Access:    public 
+// Returns:   void
+//
+// Descriptions - hands every completion that happened more than _nAsyncLag
+// cycles ago to readComplete()/writeComplete(). If the model thread has
+// fallen further behind than the lag, the SystemC thread waits for it here,
+// so the delivery cycle of a completion never depends on thread timing.
+// 
+//////////////////////////////////////////////////////////////////////////////
+void SCIC::deliverAsyncCompletions()
+{
+	if(_nCurrentClk <= _nAsyncLag)
+	{
+		return;
+	}
+
+	uint64_t nTarget = _nCurrentClk - _nAsyncLag;
+	_pModelThread->waitForCycle(nTarget);
+
+	while(true)
+	{
+		if(_bHeldCompletion == false)
+		{
+			if(_pModelThread->pollCompletion(_heldCompletion) == false)
+			{
+				break;
+			}
+			_bHeldCompletion = true;
+		}
+
+		if(_heldCompletion.doneCycle >= nTarget)
+		{
+			break;
+		}
+
+		_bHeldCompletion = false;
+		if(_heldCompletion.isWrite)
+		{
+			writeComplete(_pLegacyMemorySystem->systemID, _heldCompletion.address, _heldCompletion.doneCycle, _heldCompletion.id);
+		}
+		else
+		{
+			readComplete(_pLegacyMemorySystem->systemID, _heldCompletion.address, _heldCompletion.doneCycle, _heldCompletion.id);
+		}
+	}
+}
+
+
+
+//////////////////////////////////////////////////////////////////////////////// 
+//
+// Method:    syncAsyncModel
+// FullName:  SCIC::syncAsyncModel
+// Access:    public 
+// Returns:   void
+//
+// Descriptions - waits until the model thread has run every released cycle,
+// so its statistics can be read safely.
+// 
+//////////////////////////////////////////////////////////////////////////////
+void SCIC::syncAsyncModel()
+{
+	if(_pModelThread != NULL)
+	{
+		_pModelThread->waitForCycle(_pModelThread->cyclesReleased());
+	}
+}
+
+
+
+//////////////////////////////////////////////////////////////////////////////// 
+//
+// Method:    EnableAsyncMode
+// FullName:  SCIC::EnableAsyncMode
+// Access:    public 
+// Returns:   void
+// Parameter: unsigned int nLagCycles
+//
+// Descriptions - moves the memory system onto a dedicated OS thread.
+// Requests are stamped with the cycle they arrive in, so the memory system
+// sees exactly the same command stream as in the inline mode; completions
+// reach the SystemC side nLagCycles cycles after they happened (with the
+// original completion cycle). No request can complete in fewer than RL + tCMD
+// cycles, which is the default lag.
+// Call after AttachLegacyMemorySystem() and before sc_start().
+// 
+//////////////////////////////////////////////////////////////////////////////
+void SCIC::EnableAsyncMode(unsigned int nLagCycles)
+{
+	if(_pLegacyMemorySystem == NULL)
+	{
+		ERROR("Attach a memory system before enabling the asynchronous mode");
+		exit(0);
+	}
+	if(_pModelThread != NULL)
+	{
+		return;
+	}
+
+	_nAsyncLag			= (nLagCycles == 0) ? (RL + tCMD) : nLagCycles;
+	_bHeldCompletion	= false;
+	_pAsyncNotifier		= new SCICAsyncNotifier();
+	_pModelThread		= new MemorySystemThread(_pLegacyMemorySystem, 4*TRANS_QUEUE_DEPTH);
+	_pModelThread->setCompletionNotifier(SCICAsyncNotifier::Notify, _pAsyncNotifier);
+	_pModelThread->start();
+}
+
+
+
+//////////////////////////////////////////////////////////////////////////////// 
+//
+// Method:    StopAsyncMode
+// FullName:  SCIC::StopAsyncMode
+// Access:    public 
+// Returns:   void
+//
+// Descriptions - lets the model thread finish the released cycles and joins it.
+// Call before printing the memory system's statistics.
+// 
+//////////////////////////////////////////////////////////////////////////////
+void SCIC::StopAsyncMode()
+{
+	if(_pModelThread != NULL)
+	{
+		_pModelThread->stop();
+	}
+}
+
+
+
+sc_event& SCIC::AsyncCompletionEvent()
+{
+	if(_pAsyncNotifier == NULL)
+	{
+		ERROR("Asynchronous mode is not enabled");
+		exit(0);
+	}
+	return _pAsyncNotifier->_evtCompletion;
+}
+
+
+
 void power_callback(double a, double b, double c, double d)
 {
 	//	printf("power callback: %0.3f, %0.3f, %0.3f, %0.3f\n",a,b,c,d);
@@ -217,27 +399,13 @@ void SCIC::AttachLegacyMemorySystem(MemorySystem *pMemorySystem)
 		//
 		Callback_t *pReadCallback		= new Callback_4Param<SCIC, void, uint, uint64_t, uint64_t, uint64_t>(this, &SCIC::readComplete);
 		Callback_t *pWriteCallback		= new Callback_4Param<SCIC, void, uint, uint64_t, uint64_t, uint64_t>(this, &SCIC::writeComplete);
-#if (USE_SCIC_MEMSYS_QUERY == 1)
 		CB_HIST *pHistgramCallback	= new Callback_3Param<SCIC, void, uint, uint, uint>(this, &SCIC::measureIndividualLatency);
 		_pLegacyMemorySystem->RegisterCallbacks(pReadCallback, pWriteCallback, pHistgramCallback, power_callback);
-#else
-		_pLegacyMemorySystem->RegisterCallbacks(pReadCallback, pWriteCallback, power_callback);
-#endif
 		if(_pLegacyMemorySystem->memoryController == NULL)
 		{
 			ERROR("Memory System that you want to attach is not available");
 			exit(0);		
 		}
-
-#if (USE_SCIC_MEMSYS_QUERY == 1)
-		//
-		// build references
-		//
-		_vctpEnergy[SCIC_ENERGY_BACKGROUND]	= _pLegacyMemorySystem->memoryController->BackgroundEnergy();
-		_vctpEnergy[SCIC_ENERGY_BURST]		= _pLegacyMemorySystem->memoryController->BurstEnergy();
-		_vctpEnergy[SCIC_ENERGY_PRECHARGE]	= _pLegacyMemorySystem->memoryController->ActpreEnergy();
-		_vctpEnergy[SCIC_ENERGY_REFRESH]	= _pLegacyMemorySystem->memoryController->RefreshEnergy();
-#endif
 	}
 }
 
@@ -424,11 +592,14 @@ void SCIC::initializeInterface()
 	_bUserDataHandlingFault = false;
 	_bInitialTime	= true;
 
-#if (USE_SCIC_MEMSYS_QUERY == 1)
 	_nCycleTracker = NULL_SIG64;
     _vctRtLatencyReport = vector<uint64_t>(NUM_RANKS*NUM_BANKS,0);
-#endif
 
+	_pModelThread	= NULL;
+	_pAsyncNotifier	= NULL;
+	_nAsyncLag		= 0;
+	_bHeldCompletion = false;
+	_bRefused		= false;
 }
 
 
@@ -438,11 +609,11 @@ void SCIC::Reset()
     {
         throw "SCIC::Reset:: Invalid Pointer for MemorySystem instance";
     }
-#if (USE_SCIC_MEMSYS_QUERY == 1)
     if(!((NUM_RANKS > 0) && (NUM_BANKS >0)) ) { throw "SCIC::Reset:: Invalid RANK / BANK Configuration - must be > 0";};
 	_nCycleTracker = NULL_SIG64;
         _vctRtLatencyReport = vector<uint64_t>(NUM_RANKS*NUM_BANKS,0);
-#endif
+	_statsMark = MemoryStats();
+	_statsRun = MemoryStats();
     //initializeInterface();
     resetDataOut();
 }
@@ -477,9 +648,7 @@ void SCIC::readComplete(uint nSystemId, uint64_t nTargatAddr, uint64_t nClockCyc
 	wait(SC_ZERO_TIME);
 #endif
 
-#if (USE_SCIC_MEMSYS_QUERY == 1)
 	_nCycleTracker = nClockCycle;
-#endif
 
 	freeMemoryElement(nTargatAddr, false);
 }
@@ -511,9 +680,7 @@ void SCIC::writeComplete(uint nSystemId, uint64_t nTargatAddr, uint64_t nClockCy
 
 	setDataOutPort(NULL_SIG64);
 
-#if (USE_SCIC_MEMSYS_QUERY == 1)
 	_nCycleTracker = nClockCycle;
-#endif
 
 #if (USE_CALIBRATION_1CYCLE == 1)
 	wait(SC_ZERO_TIME);
@@ -540,13 +707,74 @@ void SCIC::alignTransactionAddress(Transaction &trans)
 // Function-style inquiry methods for memory status
 // These method enable to get latency and bandwidth for each memory request at real-time
 //
-// For compatibility to future version of DRAMSim, 
-// I recommend you to disable USE_SCIC_MEMSYS_QUERY preprocessor.
-// If you need to use these methods to get statistics from memory, 
-// you is asked to port code fragments surrounded by the USE_SCIC_MEMSYS_QUERY macro
-// to new version of DRAMSim.
+// They read MemoryController::Snapshot(), whose counters run from the start of
+// the simulation, so the core library carries no SystemC specific code paths
+// and no answer depends on where the last epoch boundary was.
 //////////////////////////////////////////////////////////////////////////
-#if (USE_SCIC_MEMSYS_QUERY == 1)
+
+
+//////////////////////////////////////////////////////////////////////////////// 
+//
+// Method:    runStats
+// FullName:  SCIC::runStats
+// Access:    private 
+// Returns:   const MemoryStats&
+//
+// Descriptions - counters since the start of the simulation, taken at most once a cycle
+// 
+//////////////////////////////////////////////////////////////////////////////
+const MemoryStats& SCIC::runStats()
+{
+	syncAsyncModel();
+
+	if (_statsRun.reads.empty() || _statsRun.cycle != _pLegacyMemorySystem->currentClockCycle)
+	{
+		_pLegacyMemorySystem->memoryController->Snapshot(_statsRun);
+	}
+	return _statsRun;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////// 
+//
+// Method:    GetStatsSnapshot
+// FullName:  SCIC::GetStatsSnapshot
+// Access:    public 
+// Returns:   void
+// Parameter: MemoryStats & stats
+//
+// Descriptions -
+// All the counters (transactions, reads, writes and read latency per bank, energy per rank)
+// since the start of the simulation. For the stats of any window, take a snapshot at each end of it
+// and subtract the earlier one from the later one (MemoryStats::subtract).
+// 
+//////////////////////////////////////////////////////////////////////////////
+void SCIC::GetStatsSnapshot(MemoryStats &stats)
+{
+	stats = runStats();
+}
+
+
+//////////////////////////////////////////////////////////////////////////////// 
+//
+// Method:    GetStatsWindow
+// FullName:  SCIC::GetStatsWindow
+// Access:    public 
+// Returns:   void
+// Parameter: MemoryStats & window
+//
+// Descriptions -
+// The counters for the window since the previous call (or since Reset() or the start of
+// the simulation). MemoryStats::Bandwidth(), AverageReadLatency() and Power() then give
+// the rates over that window.
+// 
+//////////////////////////////////////////////////////////////////////////////
+void SCIC::GetStatsWindow(MemoryStats &window)
+{
+	window = runStats();
+	window.subtract(_statsMark);
+	_statsMark = _statsRun;
+}
 
 
 //////////////////////////////////////////////////////////////////////////////// 
@@ -587,6 +815,8 @@ void SCIC::measureIndividualLatency(uint nLatency, uint nRank, uint nBank)
 //////////////////////////////////////////////////////////////////////////////
 uint64_t SCIC::GetLatencyandMarkTimepoint(vector<uint64_t> &perfInfo)
 {
+	syncAsyncModel();
+
 	uint64_t nLatency = 0;
 
 	for (size_t i=0;i<NUM_RANKS;i++)
@@ -594,13 +824,13 @@ uint64_t SCIC::GetLatencyandMarkTimepoint(vector<uint64_t> &perfInfo)
 		perfInfo[i] = 0;
 		for (size_t j=0; j<NUM_BANKS; j++)
 		{
-			perfInfo[i] += _vctRtLatencyReport[i + j];
-			nLatency += perfInfo[i];
+			perfInfo[i] += _vctRtLatencyReport[SEQUENTIAL(i,j)];
 			//
 			// mark a time point
 			//
-			_vctRtLatencyReport[i + j] = 0;
+			_vctRtLatencyReport[SEQUENTIAL(i,j)] = 0;
 		}
+		nLatency += perfInfo[i];
 	}
 	
 	return nLatency;
@@ -617,7 +847,7 @@ uint64_t SCIC::GetLatencyandMarkTimepoint(vector<uint64_t> &perfInfo)
 // Parameter: SCIC_STAT_QUERY queryType
 //
 // Descriptions -
-// The information regarding the nums of transaction requests is available for each bank and rank.
+// The nums of transaction requests since the start of the simulation, for each rank.
 // For identifying available performance class that you can measure using this, please check 
 // SCIC_STAT_QUERY enum values.
 // If a user want to go over specific data for each bank, the user should iterate the vector information based on the number of rank * bank.
@@ -628,7 +858,8 @@ uint64_t SCIC::GetLatencyandMarkTimepoint(vector<uint64_t> &perfInfo)
 //////////////////////////////////////////////////////////////////////////////
 uint64_t SCIC::GetNumsElapsedIo(vector<uint64_t> &perfInfo, SCIC_STAT_QUERY queryType)
 {
-	vector<uint64_t> &vctIoPerBank = (queryType == SCIC_STAT_READ) ? _pLegacyMemorySystem->memoryController->TotalReadsPerBank(): _pLegacyMemorySystem->memoryController->TotalWritesPerBank();
+	const MemoryStats &stats = runStats();
+	const vector<uint64_t> &vctIoPerBank = (queryType == SCIC_STAT_READ) ? stats.reads : stats.writes;
 	uint64_t nNumsIos = 0;
 	
 	for (size_t i=0;i<NUM_RANKS;i++)
@@ -637,8 +868,8 @@ uint64_t SCIC::GetNumsElapsedIo(vector<uint64_t> &perfInfo, SCIC_STAT_QUERY quer
 		for (size_t j=0; j<NUM_BANKS; j++)
 		{
 			perfInfo[i] += vctIoPerBank[SEQUENTIAL(i,j)];
-			nNumsIos += perfInfo[i];
 		}
+		nNumsIos += perfInfo[i];
 	}
 
 	return nNumsIos;
@@ -654,7 +885,7 @@ uint64_t SCIC::GetNumsElapsedIo(vector<uint64_t> &perfInfo, SCIC_STAT_QUERY quer
 // Parameter: SCIC_PERF_QUERY queryType
 //
 // Descriptions -
-// Perfromance information is available for each bank and rank.
+// Perfromance information since the start of the simulation is available for each bank and rank.
 // For identifying available performance class that you can measure using this, please check 
 // SCIC_PERF_QUERY enum values.
 // If a user want to go over specific data for each bank, the user should iterate the vector information based on the number of rank * bank.
@@ -665,13 +896,8 @@ uint64_t SCIC::GetNumsElapsedIo(vector<uint64_t> &perfInfo, SCIC_STAT_QUERY quer
 //////////////////////////////////////////////////////////////////////////////
 double SCIC::GetElapsedPerfromanceInfo(vector<double> &perfInfo, SCIC_PERF_QUERY queryType)
 {
-	double		secondsThisEpoch	= (double)_pLegacyMemorySystem->currentClockCycle * tCK * 1E-9;
-	uint		bytesPerTransaction = (64*BL)/8;
+	const MemoryStats &stats = runStats();
 	double		nTotalPerfInfo		= 0;
-	
-	vector<uint64_t> &vctTotalEpochLatency	= _pLegacyMemorySystem->memoryController->TotalEpochLatency();
-	vector<uint64_t> &vctTotalReadPerBank	= _pLegacyMemorySystem->memoryController->TotalReadsPerBank();
-	vector<uint64_t> &vctTotalWritePerBank	= _pLegacyMemorySystem->memoryController->TotalWritesPerBank();
 
 	if(queryType == SCIC_PERF_LATENCY)
 	{
@@ -679,7 +905,7 @@ double SCIC::GetElapsedPerfromanceInfo(vector<double> &perfInfo, SCIC_PERF_QUERY
 		{
 			for (size_t j=0; j<NUM_BANKS; j++)
 			{
-				perfInfo[SEQUENTIAL(i,j)] = ((double)vctTotalEpochLatency[SEQUENTIAL(i,j)] / (double)(vctTotalReadPerBank[SEQUENTIAL(i,j)])) * tCK;
+				perfInfo[SEQUENTIAL(i,j)] = stats.AverageReadLatency(SEQUENTIAL(i,j));
 				nTotalPerfInfo += perfInfo[SEQUENTIAL(i,j)];
 			}
 		}
@@ -690,7 +916,7 @@ double SCIC::GetElapsedPerfromanceInfo(vector<double> &perfInfo, SCIC_PERF_QUERY
 		{
 			for (size_t j=0; j<NUM_BANKS; j++)
 			{
-				perfInfo[SEQUENTIAL(i,j)] = (((double)(vctTotalReadPerBank[SEQUENTIAL(i,j)]+vctTotalWritePerBank[SEQUENTIAL(i,j)]) * (double)bytesPerTransaction)/(1024.0*1024.0*1024.0)) / secondsThisEpoch;
+				perfInfo[SEQUENTIAL(i,j)] = stats.Bandwidth(SEQUENTIAL(i,j));
 				nTotalPerfInfo += perfInfo[SEQUENTIAL(i,j)];
 			}
 		}
@@ -714,7 +940,7 @@ double SCIC::GetElapsedPerfromanceInfo(vector<double> &perfInfo, SCIC_PERF_QUERY
 // Energy information will be delivered trhough energyInfos vector;
 // users can specify enerygy type that they want using SCIC_ENERGY_QUERY enum value.
 // (for example, SCIC_ENERGY_BACKGROUND means bacgrkound energy, SCIC_ENERGY_BURST means burst energy and so on.)
-// The energy information (Watts) is accumulated for each rank; therefore
+// The energy information (Watts, averaged since the start of the simulation) is accumulated for each rank; therefore
 // users should be aware the number of rank.
 
 // If a user want to go over specific data for each rank, the user should iterate the vector information based on the number of rank.
@@ -724,8 +950,8 @@ double SCIC::GetElapsedPerfromanceInfo(vector<double> &perfInfo, SCIC_PERF_QUERY
 //////////////////////////////////////////////////////////////////////////////
 double SCIC::GetElapsedEnergyInfo(vector<double> &energyInfos, SCIC_ENERGY_QUERY queryType)
 {
+	const MemoryStats &stats = runStats();
 	double	 nTotalEnergyInfo	=	0;
-	uint64_t cyclesElapsed		= (_pLegacyMemorySystem->currentClockCycle % EPOCH_LENGTH == 0) ? EPOCH_LENGTH : _pLegacyMemorySystem->currentClockCycle % EPOCH_LENGTH;
 
 	if(queryType == SCIC_ENERGY_AVERAGE)	
 	{
@@ -738,27 +964,25 @@ double SCIC::GetElapsedEnergyInfo(vector<double> &energyInfos, SCIC_ENERGY_QUERY
 			energyInfos[i] = 0;
 			for (int nTypeIdx = 0; nTypeIdx < SCIC_NUMS_ENERGY_TYPE; ++nTypeIdx)
 			{
-				energyInfos[i] += (double)((*(_vctpEnergy[nTypeIdx]))[i]);
+				energyInfos[i] += stats.Power(i, nTypeIdx);
 			}
-			energyInfos[i] = (energyInfos[i] / (double)(cyclesElapsed)) * Vdd / 1000.0;
 			nTotalEnergyInfo += energyInfos[i];
 		}
 	}
 	else {
 		for (size_t i=0;i<NUM_RANKS;i++)
 		{
-			energyInfos[i] = ((double)((*(_vctpEnergy[queryType]))[i]) / (double)(cyclesElapsed)) * Vdd / 1000.0;
+			energyInfos[i] = stats.Power(i, queryType);
 			nTotalEnergyInfo += energyInfos[i];
 		}
 	}
 
 	return nTotalEnergyInfo;
 }
-#endif
 
 uint64_t SCIC::GetTotalNumsTransactions()
 {
-	return _pLegacyMemorySystem->memoryController->TotalTransactions();
+	return runStats().transactions;
 }
 
 uint SCIC::GetBytePerTransaction() 
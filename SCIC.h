@@ -27,6 +27,7 @@
 #define _SCIC_h__
 
 #include "MemorySystem.h"
+#include "MemorySystemThread.h"
 #include <systemc.h>
 
 #ifndef NULL_SIG64
@@ -43,7 +44,7 @@
 #define	USE_CALIBRATION_1CYCLE		(1)
 
 
-#if (USE_SCIC_MEMSYS_QUERY == 1)
+// in the order of MemoryStatsEnergy
 typedef enum {
 	SCIC_ENERGY_BACKGROUND,
 	SCIC_ENERGY_BURST,
@@ -67,7 +68,25 @@ typedef enum {
 #ifndef SEQUENTIAL
 #define SEQUENTIAL(rank,bank) (rank*NUM_BANKS)+bank
 #endif
-#endif
+
+
+
+//
+// In asynchronous mode the DRAM model runs on its own thread; this channel lets
+// that thread wake up the SystemC kernel (async_request_update is the only
+// kernel call that is safe from a foreign thread) whenever completions are published.
+//
+class SCICAsyncNotifier : public sc_prim_channel
+{
+public:
+	sc_event		_evtCompletion;
+
+	SCICAsyncNotifier() : sc_prim_channel(sc_gen_unique_name("scic_async")) {}
+	static void		Notify(void *pChannel) { ((SCICAsyncNotifier *)pChannel)->async_request_update(); }
+
+protected:
+	virtual void	update() { _evtCompletion.notify(SC_ZERO_TIME); }
+};
 
 
 
@@ -126,16 +145,19 @@ SC_MODULE(SCIC)
 	bool				_bUserDataHandlingFault;
 	bool				_bInitialTime;
 
-#if (USE_SCIC_MEMSYS_QUERY == 1)
-	vector<uint64_t>* 	_vctpEnergy[SCIC_NUMS_ENERGY_TYPE];
 	vector<uint64_t>	_vctRtLatencyReport;
 	//
+	// counters since the start of the simulation as of _statsRun.cycle, and
+	// the snapshot GetStatsWindow() measured its last window up to
+	//
+	MemoryStats			_statsRun;
+	MemoryStats			_statsMark;
+	//
 	// For measuring real-time performance
 	// this tracker check interval time between request begins and completes for each memory transaction.
 	//
 	uint64_t			_nCycleTracker;
 
-#endif
 	//
 	// For minimizing modification of DRAMSim, this member filed explicitly helps to manage memory resource. 
 	// The key of scoreboard is destination address 
@@ -143,6 +165,23 @@ SC_MODULE(SCIC)
 	typedef multimap<uint64_t, ScoreBoardElement> ScoreBoard;		
 	ScoreBoard		_scoreBoard;
 
+	//
+	// asynchronous mode: the memory system is updated by _pModelThread and
+	// completions are delivered _nAsyncLag cycles after they happened.
+	//
+	MemorySystemThread	*_pModelThread;
+	SCICAsyncNotifier	*_pAsyncNotifier;
+	unsigned int		_nAsyncLag;
+	CompletionRecord	_heldCompletion;
+	bool				_bHeldCompletion;
+
+	//
+	// the last request the memory system refused; the CPU presents it again,
+	// and it keeps its first offer so that the admission wait counts from there
+	//
+	Transaction			_refusedTrans;
+	bool				_bRefused;
+
 
     /************************************************************************/
     /* private member   
@@ -159,15 +198,23 @@ SC_MODULE(SCIC)
 	void			initializeInterface();
 	void			readComplete(uint nSystemId, uint64_t nTargatAddr, uint64_t nClockCycle, uint64_t nTransID);
 	void			writeComplete(uint nSystemId, uint64_t nTargatAddr, uint64_t nClockCycle, uint64_t nTransID);
+	void			stepMemorySystem();
+	void			deliverAsyncCompletions();
+	void			syncAsyncModel();
+	const MemoryStats&	runStats();
   
     /************************************************************************/
     /* public                                                               */
     /************************************************************************/    
     void			AttachLegacyMemorySystem(MemorySystem *pMemorySystem);    // methods for compatibility with DRAMSim and a CPU model
     void            Reset();
+	void			EnableAsyncMode(unsigned int nLagCycles = 0);
+	void			StopAsyncMode();
+	sc_event&		AsyncCompletionEvent();
 
 
-#if (USE_SCIC_MEMSYS_QUERY == 1)
+	void			GetStatsSnapshot(MemoryStats &stats);
+	void			GetStatsWindow(MemoryStats &window);
 	uint64_t		GetLatencyandMarkTimepoint(vector<uint64_t> &perfInfo);
 	uint64_t		GetNumsElapsedIo(vector<uint64_t> &perfInfo, SCIC_STAT_QUERY queryType);
 	double			GetElapsedPerfromanceInfo(vector<double> &perfInfo, SCIC_PERF_QUERY queryType);
@@ -179,7 +226,6 @@ SC_MODULE(SCIC)
 	// callback, this is not exported to public
 	//
 	void		    measureIndividualLatency(uint nLatency, uint nRank, uint nBank);
-#endif
 
 	SC_CTOR(SCIC)
 	{
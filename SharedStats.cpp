@@ -0,0 +1,165 @@
+/****************************************************************************
+*	 DRAMSim2: A Cycle Accurate DRAM simulator 
+*	 
+*	 Copyright (C) 2010   	Elliott Cooper-Balis
+*									Paul Rosenfeld 
+*									Bruce Jacob
+*									University of Maryland
+*
+*	 This program is free software: you can redistribute it and/or modify
+*	 it under the terms of the GNU General Public License as published by
+*	 the Free Software Foundation, either version 3 of the License, or
+*	 (at your option) any later version.
+*
+*	 This program is distributed in the hope that it will be useful,
+*	 but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	 MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	 GNU General Public License for more details.
+*
+*	 You should have received a copy of the GNU General Public License
+*	 along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*****************************************************************************/
+
+
+
+//SharedStats.cpp
+//
+//Class file for the shared memory stats page writer and reader
+//
+
+#include "SharedStats.h"
+#include "SystemConfiguration.h"
+#include <cstring>
+#include <algorithm>
+#include <sstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace DRAMSim;
+using namespace std;
+
+string DRAMSim::sharedStatsName(unsigned pid, unsigned systemID)
+{
+	stringstream name;
+	name << "/dramsim." << pid << "." << systemID;
+	return name.str();
+}
+
+SharedStatsWriter::SharedStatsWriter(unsigned systemID) :
+		name(sharedStatsName(getpid(), systemID)),
+		page(NULL),
+		length(sharedStatsBytes(NUM_RANKS, NUM_BANKS))
+{
+	int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+	if (fd < 0)
+	{
+		ERROR("== Error - Could not create the shared memory segment '"<<name<<"'");
+		exit(-1);
+	}
+	if (ftruncate(fd, length) != 0)
+	{
+		ERROR("== Error - Could not size the shared memory segment '"<<name<<"'");
+		exit(-1);
+	}
+	void *m = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (m == MAP_FAILED)
+	{
+		ERROR("== Error - Could not map the shared memory segment '"<<name<<"'");
+		exit(-1);
+	}
+	::close(fd);
+
+	//the segment starts out zeroed; the magic goes in last so a reader
+	//never sees a half set up header
+	page = (SharedStatsHeader *)m;
+	page->version = SHARED_STATS_VERSION;
+	page->systemID = systemID;
+	page->pid = getpid();
+	page->numRanks = NUM_RANKS;
+	page->numBanks = NUM_BANKS;
+	page->rankColumns = SHARED_STATS_RANK_COLUMNS;
+	page->bankColumns = SHARED_STATS_BANK_COLUMNS;
+	page->bytesPerTransaction = (64*BL)/8;
+	page->tCK = tCK;
+	page->Vdd = Vdd;
+	page->epochLength = EPOCH_LENGTH;
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	memcpy(page->magic, SHARED_STATS_MAGIC, sizeof(page->magic));
+}
+
+SharedStatsWriter::~SharedStatsWriter()
+{
+	munmap(page, length);
+	shm_unlink(name.c_str());
+}
+
+void SharedStatsWriter::setRankCounter(unsigned column, const vector<uint64_t> &values)
+{
+	copy(values.begin(), values.end(), sharedStatsRankColumn(page, column));
+}
+
+void SharedStatsWriter::setBankCounter(unsigned column, const vector<uint64_t> &values)
+{
+	copy(values.begin(), values.end(), sharedStatsBankColumn(page, column));
+}
+
+SharedStatsReader::SharedStatsReader(const string &name) :
+		page(NULL),
+		length(0)
+{
+	int fd = shm_open(name.c_str(), O_RDONLY, 0);
+	if (fd < 0)
+	{
+		ERROR("== Error - Could not open the shared memory segment '"<<name<<"'");
+		exit(-1);
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(SharedStatsHeader))
+	{
+		ERROR("== Error - '"<<name<<"' is not a stats segment");
+		exit(-1);
+	}
+	length = st.st_size;
+	void *m = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+	if (m == MAP_FAILED)
+	{
+		ERROR("== Error - Could not map the shared memory segment '"<<name<<"'");
+		exit(-1);
+	}
+	::close(fd);
+	page = (const SharedStatsHeader *)m;
+
+	if (memcmp(page->magic, SHARED_STATS_MAGIC, sizeof(page->magic)) != 0 || page->version != SHARED_STATS_VERSION ||
+	    page->rankColumns != SHARED_STATS_RANK_COLUMNS || page->bankColumns != SHARED_STATS_BANK_COLUMNS ||
+	    length < sharedStatsBytes(page->numRanks, page->numBanks))
+	{
+		ERROR("== Error - '"<<name<<"' is not a version "<<SHARED_STATS_VERSION<<" stats segment");
+		exit(-1);
+	}
+}
+
+SharedStatsReader::~SharedStatsReader()
+{
+	munmap((void *)page, length);
+}
+
+void SharedStatsReader::read(SharedStatsHeader *snapshot) const
+{
+	for (;;)
+	{
+		uint64_t before = __atomic_load_n(&page->sequence, __ATOMIC_ACQUIRE);
+		if ((before & 1) == 0)
+		{
+			memcpy(snapshot, page, length);
+			__atomic_thread_fence(__ATOMIC_ACQUIRE);
+			if (__atomic_load_n(&page->sequence, __ATOMIC_RELAXED) == before)
+			{
+				return;
+			}
+		}
+		usleep(100);
+	}
+}
@@ -0,0 +1,164 @@
+/****************************************************************************
+*	 DRAMSim2: A Cycle Accurate DRAM simulator 
+*	 
+*	 Copyright (C) 2010   	Elliott Cooper-Balis
+*									Paul Rosenfeld 
+*									Bruce Jacob
+*									University of Maryland
+*
+*	 This program is free software: you can redistribute it and/or modify
+*	 it under the terms of the GNU General Public License as published by
+*	 the Free Software Foundation, either version 3 of the License, or
+*	 (at your option) any later version.
+*
+*	 This program is distributed in the hope that it will be useful,
+*	 but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	 MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	 GNU General Public License for more details.
+*
+*	 You should have received a copy of the GNU General Public License
+*	 along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*****************************************************************************/
+
+#ifndef SHAREDSTATS_H
+#define SHAREDSTATS_H
+
+//SharedStats.h
+//
+//Live statistics in a POSIX shared memory segment, for watching a long run
+//with dramsim-top. Turned on with SHARED_STATS_OUTPUT in the system ini
+//file; the segment is named /dramsim.<pid>.<systemID> and removed when the
+//memory system is destroyed.
+//
+//The segment is a SharedStatsHeader followed by the rank columns
+//[SHARED_STATS_RANK_COLUMNS][numRanks] and the bank columns
+//[SHARED_STATS_BANK_COLUMNS][numRanks*numBanks], all uint64_t. The memory
+//controller rewrites it every SHARED_STATS_INTERVAL cycles with plain
+//stores under a sequence lock: the sequence number is odd while an update
+//is in progress, so a reader copies the page and retries if the sequence
+//number was odd or changed in the meantime. Counters run from the start of
+//the simulation; the latency percentiles cover the current epoch.
+//
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#define SHARED_STATS_MAGIC "DSIMSHM1"
+#define SHARED_STATS_VERSION 1
+#define SHARED_STATS_INTERVAL 10000
+
+namespace DRAMSim
+{
+
+enum SharedStatsRankColumn
+{
+	SHARED_BACKGROUND_ENERGY,	// mA*cycles, as in the memory controller
+	SHARED_BURST_ENERGY,
+	SHARED_ACTPRE_ENERGY,
+	SHARED_REFRESH_ENERGY,
+	SHARED_STATS_RANK_COUNTERS,
+	SHARED_COMMAND_QUEUE = SHARED_STATS_RANK_COUNTERS,	// commands waiting for this rank right now
+	SHARED_STATS_RANK_COLUMNS
+};
+
+enum SharedStatsBankColumn
+{
+	SHARED_READS,
+	SHARED_WRITES,
+	SHARED_STATS_BANK_COLUMNS
+};
+
+struct SharedStatsHeader
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t systemID;
+	uint32_t pid;
+	uint32_t numRanks;
+	uint32_t numBanks;
+	uint32_t rankColumns;
+	uint32_t bankColumns;
+	uint32_t bytesPerTransaction;
+	float tCK;
+	float Vdd;
+
+	uint64_t sequence;	// odd while an update is in progress
+	uint64_t cycle;
+	uint64_t epochLength;
+	uint64_t transactionQueue;	// occupancy right now
+	uint64_t pendingReads;	// reads in flight in the DRAM
+	uint64_t readP50, readP90, readP99, readP999;	// in cycles, this epoch
+	uint64_t writeP50, writeP90, writeP99, writeP999;
+	uint64_t finished;	// set once the final stats have been printed
+};
+
+inline size_t sharedStatsBytes(uint32_t numRanks, uint32_t numBanks)
+{
+	return sizeof(SharedStatsHeader) +
+	       (SHARED_STATS_RANK_COLUMNS * numRanks + SHARED_STATS_BANK_COLUMNS * numRanks * numBanks) * sizeof(uint64_t);
+}
+
+inline uint64_t *sharedStatsRankColumn(SharedStatsHeader *header, unsigned column)
+{
+	return (uint64_t *)(header + 1) + column * header->numRanks;
+}
+
+inline uint64_t *sharedStatsBankColumn(SharedStatsHeader *header, unsigned column)
+{
+	return sharedStatsRankColumn(header, SHARED_STATS_RANK_COLUMNS) + column * header->numRanks * header->numBanks;
+}
+
+std::string sharedStatsName(unsigned pid, unsigned systemID);
+
+//owned by the memory system; the controller fills in the page between
+//beginUpdate() and endUpdate()
+class SharedStatsWriter
+{
+public:
+	SharedStatsWriter(unsigned systemID);
+	virtual ~SharedStatsWriter();
+
+	SharedStatsHeader *beginUpdate()
+	{
+		__atomic_store_n(&page->sequence, page->sequence + 1, __ATOMIC_RELAXED);
+		__atomic_thread_fence(__ATOMIC_RELEASE);
+		return page;
+	}
+	void endUpdate()
+	{
+		__atomic_store_n(&page->sequence, page->sequence + 1, __ATOMIC_RELEASE);
+	}
+
+	//copies a column of run totals into the page
+	void setRankCounter(unsigned column, const std::vector<uint64_t> &values);
+	void setBankCounter(unsigned column, const std::vector<uint64_t> &values);
+
+private:
+	std::string name;
+	SharedStatsHeader *page;
+	size_t length;
+};
+
+//a process watching the segment
+class SharedStatsReader
+{
+public:
+	SharedStatsReader(const std::string &name);
+	virtual ~SharedStatsReader();
+
+	//copies a consistent snapshot of the page into snapshot, which must
+	//hold Bytes() bytes
+	void read(SharedStatsHeader *snapshot) const;
+	size_t Bytes() const { return length; }
+
+private:
+	const SharedStatsHeader *page;
+	size_t length;
+};
+
+}
+
+#endif
+
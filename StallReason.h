@@ -0,0 +1,63 @@
+/****************************************************************************
+*	 DRAMSim2: A Cycle Accurate DRAM simulator 
+*	 
+*	 Copyright (C) 2010   	Elliott Cooper-Balis
+*									Paul Rosenfeld 
+*									Bruce Jacob
+*									University of Maryland
+*
+*	 This program is free software: you can redistribute it and/or modify
+*	 it under the terms of the GNU General Public License as published by
+*	 the Free Software Foundation, either version 3 of the License, or
+*	 (at your option) any later version.
+*
+*	 This program is distributed in the hope that it will be useful,
+*	 but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	 MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	 GNU General Public License for more details.
+*
+*	 You should have received a copy of the GNU General Public License
+*	 along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*****************************************************************************/
+
+
+
+#ifndef STALLREASON_H
+#define STALLREASON_H
+
+//StallReason.h
+//
+//Why the command at the head of a command queue did not issue in a cycle.
+//The timing reasons name the constraint that last pushed the bank's
+//next read/write/activate/precharge time out (see BankState). Data bus
+//occupancy is part of the column-to-column and turnaround constraints.
+//
+
+namespace DRAMSim
+{
+enum StallReason
+{
+	STALL_COMMAND_BUS,	// issuable, but another command took the command bus
+	STALL_TRCD,	// activate to column command
+	STALL_TRP,	// precharge (or auto-precharge) to activate
+	STALL_TRAS,	// activate to precharge, with another row waiting
+	STALL_TRC,	// activate to activate, same bank
+	STALL_TRRD,	// activate to activate, another bank
+	STALL_TFAW,	// four activates already in the tFAW window
+	STALL_TCCD,	// column to column in the same rank, including the data burst
+	STALL_WRITE_TO_READ,	// write to read turnaround
+	STALL_READ_TO_WRITE,	// read to write turnaround
+	STALL_RANK_SWITCH,	// data bus hand-off to another rank (tRTRS)
+	STALL_COLUMN_TO_PRECHARGE,	// read to precharge (tRTP) or write recovery (tWR)
+	STALL_ROW_CONFLICT,	// another row is open and has not been closed yet
+	STALL_REFRESH,	// rank waiting for or busy with a refresh
+	STALL_POWER_DOWN,	// rank powered down or within tXP of power up
+	STALL_ROW_ACCESS_CAP,	// TOTAL_ROW_ACCESSES reached for the open row
+	STALL_REASONS
+};
+
+extern const char *stallReasonNames[STALL_REASONS];
+}
+
+#endif
@@ -0,0 +1,277 @@
+/****************************************************************************
+*	 DRAMSim2: A Cycle Accurate DRAM simulator 
+*	 
+*	 Copyright (C) 2010   	Elliott Cooper-Balis
+*									Paul Rosenfeld 
+*									Bruce Jacob
+*									University of Maryland
+*
+*	 This program is free software: you can redistribute it and/or modify
+*	 it under the terms of the GNU General Public License as published by
+*	 the Free Software Foundation, either version 3 of the License, or
+*	 (at your option) any later version.
+*
+*	 This program is distributed in the hope that it will be useful,
+*	 but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	 MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	 GNU General Public License for more details.
+*
+*	 You should have received a copy of the GNU General Public License
+*	 along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*****************************************************************************/
+
+
+
+//StatsConvert.cpp
+//
+//Turns a binary epoch stats file (see EpochStats.h) back into text: CSV with
+//one row per epoch and bank, or the .vis format that VIS_FILE_OUTPUT writes,
+//so the visualizer can read runs that only kept binary stats. Also turns a
+//sampled latency log (see LatencyBreakdown.h) into CSV, one row per transaction.
+//
+
+#include <iostream>
+#include <fstream>
+#include <getopt.h>
+#include <cstring>
+
+#include "SystemConfiguration.h"
+#include "EpochStats.h"
+#include "LatencyBreakdown.h"
+
+using namespace DRAMSim;
+using namespace std;
+
+void usage()
+{
+	cout << "dramsim-statsconv Usage: " << endl;
+	cout << "dramsim-statsconv [-f csv|vis] [-o output] input.stats|input.lat" << endl;
+	cout << "\t-f, --format=FORMAT \tcsv (default) for one row per epoch and bank, or vis for a .vis file" << endl;
+	cout << "\t\t\t\ta latency log only converts to csv, one row per transaction" << endl;
+	cout << "\t-o, --output=FILE \twhere to write the result (default: standard output)" << endl;
+}
+
+//the power of a rank over an epoch, in watts, as printStats() computes it
+double rankPower(uint64_t energy, const EpochStatsRecord &record, const EpochStatsHeader &header)
+{
+	return ((double)energy / (double)(record.cyclesElapsed)) * header.Vdd / 1000.0;
+}
+
+//part over whole, 0 if there is no whole
+double ratio(uint64_t part, uint64_t whole)
+{
+	return whole == 0 ? 0.0 : (double)part / (double)whole;
+}
+
+void writeCSV(EpochStatsReader &reader, ostream &out)
+{
+	const EpochStatsHeader &header = reader.Header();
+	out << "cycle,final,rank,bank,reads,writes,bandwidth_GBps,mean_read_latency_ns,"
+	       "read_p50_ns,read_p99_ns,write_p50_ns,write_p99_ns,"
+	       "background_power_W,actpre_power_W,burst_power_W,refresh_power_W,"
+	       "row_hits,row_misses,row_conflicts,activates_per_column,command_bus_utilization,data_bus_utilization,"
+	       "read_to_write,write_to_read,rank_switches,refresh_fraction,power_down_fraction";
+	for (size_t r=0; r<STALL_REASONS; r++)
+	{
+		out << ",stall_" << stallReasonNames[r];
+	}
+	out << endl;
+
+	EpochStats epoch;
+	while (reader.next(epoch))
+	{
+		const EpochStatsRecord &record = epoch.record;
+		double secondsThisEpoch = (double)record.cyclesElapsed * header.tCK * 1E-9;
+		for (size_t i=0; i<header.numRanks; i++)
+		{
+			for (size_t j=0; j<header.numBanks; j++)
+			{
+				size_t bank = i*header.numBanks + j;
+				uint64_t reads = epoch.bankColumns[EPOCH_READS][bank];
+				uint64_t writes = epoch.bankColumns[EPOCH_WRITES][bank];
+				const LatencyHistogram &readLatency = epoch.readLatency[bank];
+				const LatencyHistogram &writeLatency = epoch.writeLatency[bank];
+
+				out << record.cycle << "," << ((record.flags & EPOCH_STATS_FINAL) ? 1 : 0) << "," << i << "," << j << ","
+				    << reads << "," << writes << ","
+				    << (((double)(reads + writes) * header.bytesPerTransaction)/(1024.0*1024.0*1024.0)) / secondsThisEpoch << ","
+				    << (reads == 0 ? 0.0 : (double)epoch.bankColumns[EPOCH_READ_LATENCY][bank] / reads * header.tCK) << ","
+				    << readLatency.percentile(0.50) * header.tCK << "," << readLatency.percentile(0.99) * header.tCK << ","
+				    << writeLatency.percentile(0.50) * header.tCK << "," << writeLatency.percentile(0.99) * header.tCK << ","
+				    << rankPower(epoch.rankColumns[EPOCH_BACKGROUND_ENERGY][i], record, header) << ","
+				    << rankPower(epoch.rankColumns[EPOCH_ACTPRE_ENERGY][i], record, header) << ","
+				    << rankPower(epoch.rankColumns[EPOCH_BURST_ENERGY][i], record, header) << ","
+				    << rankPower(epoch.rankColumns[EPOCH_REFRESH_ENERGY][i], record, header) << ","
+				    << epoch.bankColumns[EPOCH_ROW_HITS][bank] << "," << epoch.bankColumns[EPOCH_ROW_MISSES][bank] << ","
+				    << epoch.bankColumns[EPOCH_ROW_CONFLICTS][bank] << ","
+				    << ratio(epoch.bankColumns[EPOCH_ACTIVATES][bank], epoch.bankColumns[EPOCH_COLUMN_ACCESSES][bank]) << ","
+				    << ratio(record.commandBusCycles, record.cyclesElapsed) << ","
+				    << ratio(record.dataBusCycles, record.cyclesElapsed) << ","
+				    << record.readToWrite << "," << record.writeToRead << "," << record.rankSwitches << ","
+				    << ratio(epoch.rankColumns[EPOCH_REFRESH_CYCLES][i], record.cyclesElapsed) << ","
+				    << ratio(epoch.rankColumns[EPOCH_POWER_DOWN_CYCLES][i], record.cyclesElapsed);
+				for (size_t r=0; r<STALL_REASONS; r++)
+				{
+					out << "," << epoch.bankColumns[EPOCH_STALL_CYCLES+r][bank];
+				}
+				out << endl;
+			}
+		}
+	}
+}
+
+//stage latencies in ns, in the order of LatencyStage
+void writeLatencyCSV(LatencyLogReader &reader, ostream &out)
+{
+	float tCK = reader.Header().tCK;
+	out << "id,type,address,source,rank,bank,issued,added,completed,latency_ns";
+	for (size_t s=0; s<LATENCY_STAGES; s++)
+	{
+		out << "," << latencyStageNames[s] << "_ns";
+	}
+	out << endl;
+
+	LatencyLogRecord record;
+	while (reader.next(record))
+	{
+		out << record.id << "," << (record.isWrite ? "write" : "read") << ",0x" << hex << record.address << dec << ","
+		    << record.sourceID << "," << record.rank << "," << record.bank << ","
+		    << record.issued << "," << record.added << "," << record.completed << ","
+		    << (record.completed - record.added) * tCK;
+		for (size_t s=0; s<LATENCY_STAGES; s++)
+		{
+			out << "," << record.stageCycles[s] * tCK;
+		}
+		out << endl;
+	}
+}
+
+//mirrors the VIS_FILE_OUTPUT lines of MemoryController::printStats()
+void writeVis(EpochStatsReader &reader, ostream &out)
+{
+	const EpochStatsHeader &header = reader.Header();
+	out << reader.IniText();
+
+	LatencyHistogram allReadLatency;
+	EpochStats epoch;
+	while (reader.next(epoch))
+	{
+		const EpochStatsRecord &record = epoch.record;
+		double secondsThisEpoch = (double)record.cyclesElapsed * header.tCK * 1E-9;
+
+		out << record.cycle * header.tCK * 1E-6 << ":";
+		for (size_t i=0; i<header.numRanks; i++)
+		{
+			out << "bgp_"<<i<<"="<<rankPower(epoch.rankColumns[EPOCH_BACKGROUND_ENERGY][i], record, header)<<",";
+			out << "ap_"<<i<<"="<<rankPower(epoch.rankColumns[EPOCH_ACTPRE_ENERGY][i], record, header)<<",";
+			out << "bp_"<<i<<"="<<rankPower(epoch.rankColumns[EPOCH_BURST_ENERGY][i], record, header)<<",";
+			out << "rp_"<<i<<"="<<rankPower(epoch.rankColumns[EPOCH_REFRESH_ENERGY][i], record, header)<<",";
+			for (size_t j=0; j<header.numBanks; j++)
+			{
+				size_t bank = i*header.numBanks + j;
+				uint64_t reads = epoch.bankColumns[EPOCH_READS][bank];
+				double bandwidth = (((double)(reads + epoch.bankColumns[EPOCH_WRITES][bank]) * (double)header.bytesPerTransaction)/(1024.0*1024.0*1024.0)) / secondsThisEpoch;
+				double averageLatency = ((float)epoch.bankColumns[EPOCH_READ_LATENCY][bank] / (float)reads) * header.tCK;
+				out << "b_" <<i<<"_"<<j<<"="<<bandwidth<<",";
+				out << "l_" <<i<<"_"<<j<<"="<<averageLatency<<",";
+				allReadLatency.merge(epoch.readLatency[bank]);
+			}
+		}
+		out << endl;
+	}
+
+	out << "!!HISTOGRAM_DATA" << endl;
+	for (size_t b=0; b<allReadLatency.NumBuckets(); b++)
+	{
+		if (allReadLatency.BucketCount(b) > 0)
+		{
+			out << LatencyHistogram::bucketLow(b) << "=" << allReadLatency.BucketCount(b) << endl;
+		}
+	}
+}
+
+int main(int argc, char **argv)
+{
+	string format = "csv";
+	string outputFilename;
+
+	while (1)
+	{
+		static struct option long_options[] =
+		{
+			{"format", required_argument, 0, 'f'},
+			{"output", required_argument, 0, 'o'},
+			{"help", no_argument, 0, 'h'},
+			{0, 0, 0, 0}
+		};
+		int option_index=0;
+		int c = getopt_long(argc, argv, "f:o:h", long_options, &option_index);
+		if (c == -1)
+		{
+			break;
+		}
+		switch (c)
+		{
+		case 'f':
+			format = string(optarg);
+			break;
+		case 'o':
+			outputFilename = string(optarg);
+			break;
+		case 'h':
+		case '?':
+			usage();
+			exit(0);
+			break;
+		}
+	}
+
+	if (optind != argc - 1 || (format != "csv" && format != "vis"))
+	{
+		usage();
+		exit(-1);
+	}
+
+	string inputFilename = argv[optind];
+	bool latencyLog = LatencyLogReader::isLatencyLog(inputFilename);
+	if (!latencyLog && !EpochStatsReader::isEpochStats(inputFilename))
+	{
+		ERROR("== '"<<inputFilename<<"' is not a binary stats file or latency log");
+		exit(-1);
+	}
+	if (latencyLog && format != "csv")
+	{
+		ERROR("== A latency log only converts to csv");
+		exit(-1);
+	}
+
+	ofstream outputFile;
+	if (outputFilename.length() > 0)
+	{
+		outputFile.open(outputFilename.c_str());
+		if (!outputFile)
+		{
+			ERROR("== Error - Could not open output file '"<<outputFilename<<"'");
+			exit(-1);
+		}
+	}
+	ostream &out = outputFilename.length() > 0 ? outputFile : cout;
+
+	if (latencyLog)
+	{
+		LatencyLogReader reader(inputFilename);
+		writeLatencyCSV(reader, out);
+	}
+	else if (format == "csv")
+	{
+		EpochStatsReader reader(inputFilename);
+		writeCSV(reader, out);
+	}
+	else
+	{
+		EpochStatsReader reader(inputFilename);
+		writeVis(reader, out);
+	}
+	return 0;
+}
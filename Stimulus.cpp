@@ -60,17 +60,13 @@ void Stimulus::run()
 	idleState();
 
 	wait(SC_ZERO_TIME);
-	if(_ptraceFile == NULL)
+	if(_pTraceReader == NULL)
 	{
 		ERROR("No trace input file")
 			exit(0); 
 	}
 
-	std::string				line;
-	void *					pBuffer;
-	TransactionType			transType;
-	uint64_t				nDestAddr;
-	uint64_t				nSyncClk = 0;
+	TraceRecord				record;
 
 	while(1)
 	{
@@ -114,22 +110,23 @@ void Stimulus::run()
 #else
         if(_pfCallback == NULL)
         {
-            if(_ptraceFile->eof() != true)
+            if(_bTraceDone != true)
             {
                 if(_prtRB->read() == false)
                 {
                     //
                     // stimulus issues I/O to memory only if the bus interface unit has room
                     //
-                    getline(*_ptraceFile, line);
-
-                    if (line.size() > 0)
+                    if (_pTraceReader->next(record))
                     {
-                        pBuffer = parseTraceFileLine(line, nDestAddr, transType, nSyncClk, _traceType);
-
-                        //DEBUG("Stimulus issues (address) :" << std::hex << nDestAddr << std::dec);
+                        //DEBUG("Stimulus issues (address) :" << std::hex << record.address << std::dec);
 
-                        sendIo(nDestAddr, transType, pBuffer);
+                        sendIo(record.address, record.type, record.data);
+                    }
+                    else
+                    {
+                        _bTraceDone = true;
+                        idleState();
                     }
                 }
             }
@@ -365,218 +362,3 @@ void Stimulus::getDataPort(uint64_t *pData)
 		pData[buffIdx] = _prtDataIn[buffIdx]->read();
 	}
 }
-
-
-
-//////////////////////////////////////////////////////////////////////////////// 
-//
-// Method:    parseTraceFileLine
-// FullName:  Stimulus::parseTraceFileLine
-// Access:    public 
-// Returns:   void *
-// Parameter: string & line
-// Parameter: uint64_t & addr
-// Parameter: enum TransactionType & transType
-// Parameter: uint64_t & clockCycle
-// Parameter: TraceType type
-//
-// Descriptions -
-// 
-//////////////////////////////////////////////////////////////////////////////
-void * Stimulus::parseTraceFileLine(string &line, uint64_t &addr, enum TransactionType &transType, uint64_t &clockCycle, TraceType type)
-{
-	size_t previousIndex=0;
-	size_t spaceIndex=0;
-	uint64_t *dataBuffer = NULL;
-	string addressStr="", cmdStr="", dataStr="", ccStr="";
-
-#if (USE_SYSTEM_C_INTERFACE == 1)
-	bool useClockCycle = true;
-#else
-#ifndef _SIM_ 
-	bool useClockCycle = false;
-#else
-	bool useClockCycle = true;
-#endif
-#endif
-
-	switch (type)
-	{
-	case k6:
-		{
-			spaceIndex = line.find_first_of(" ", 0);
-
-			addressStr = line.substr(0, spaceIndex);
-			previousIndex = spaceIndex;
-
-			spaceIndex = line.find_first_not_of(" ", previousIndex);
-			cmdStr = line.substr(spaceIndex, line.find_first_of(" ", spaceIndex) - spaceIndex);
-			previousIndex = line.find_first_of(" ", spaceIndex);
-
-			spaceIndex = line.find_first_not_of(" ", previousIndex);
-			ccStr = line.substr(spaceIndex, line.find_first_of(" ", spaceIndex) - spaceIndex);
-
-			if (cmdStr.compare("P_MEM_WR")==0 ||
-				cmdStr.compare("BOFF")==0)
-			{
-				transType = DATA_WRITE;
-			}
-			else if (cmdStr.compare("P_FETCH")==0 ||
-				cmdStr.compare("P_MEM_RD")==0 ||
-				cmdStr.compare("P_LOCK_RD")==0 ||
-				cmdStr.compare("P_LOCK_WR")==0)
-			{
-				transType = DATA_READ;
-			}
-			else
-			{
-				ERROR("== Unknown Command : "<<cmdStr);
-				exit(0);
-			}
-
-			istringstream a(addressStr.substr(2));//gets rid of 0x
-			a>>hex>>addr;
-
-			//if this is set to false, clockCycle will remain at 0, and every line read from the trace
-			//  will be allowed to be issued
-			if (useClockCycle)
-			{
-				istringstream b(ccStr);
-				b>>clockCycle;
-			}
-			break;
-		}
-	case mase:
-		{
-			spaceIndex = line.find_first_of(" ", 0);
-
-			addressStr = line.substr(0, spaceIndex);
-			previousIndex = spaceIndex;
-
-			spaceIndex = line.find_first_not_of(" ", previousIndex);
-			cmdStr = line.substr(spaceIndex, line.find_first_of(" ", spaceIndex) - spaceIndex);
-			previousIndex = line.find_first_of(" ", spaceIndex);
-
-			spaceIndex = line.find_first_not_of(" ", previousIndex);
-			ccStr = line.substr(spaceIndex, line.find_first_of(" ", spaceIndex) - spaceIndex);
-
-			if (cmdStr.compare("IFETCH")==0||
-				cmdStr.compare("READ")==0)
-			{
-				transType = DATA_READ;
-			}
-			else if (cmdStr.compare("WRITE")==0)
-			{
-				transType = DATA_WRITE;
-			}
-			else
-			{
-				ERROR("== Unknown command in tracefile : "<<cmdStr);
-			}
-
-			istringstream a(addressStr.substr(2));//gets rid of 0x
-			a>>hex>>addr;
-
-			//if this is set to false, clockCycle will remain at 0, and every line read from the trace
-			//  will be allowed to be issued
-			if (useClockCycle)
-			{
-				istringstream b(ccStr);
-				b>>clockCycle;
-			}
-
-			break;
-		}
-	case misc:
-		spaceIndex = line.find_first_of(" ", spaceIndex+1);
-		if (spaceIndex == string::npos)
-		{
-			ERROR("Malformed line: '"<< line <<"'");
-		}
-
-		addressStr = line.substr(previousIndex,spaceIndex);
-		previousIndex=spaceIndex;
-
-		spaceIndex = line.find_first_of(" ", spaceIndex+1);
-		if (spaceIndex == string::npos)
-		{
-			cmdStr = line.substr(previousIndex+1);
-		}
-		else
-		{
-			cmdStr = line.substr(previousIndex+1,spaceIndex-previousIndex-1);
-			dataStr = line.substr(spaceIndex+1);
-		}
-
-		//convert address string -> number
-		istringstream b(addressStr.substr(2)); //substr(2) chops off 0x characters
-		b >>hex>> addr;
-
-		// parse command
-		if (cmdStr.compare("read") == 0)
-		{
-			transType=DATA_READ;
-		}
-		else if (cmdStr.compare("write") == 0)
-		{
-			transType=DATA_WRITE;
-		}
-		else
-		{
-			ERROR("INVALID COMMAND '"<<cmdStr<<"'");
-			exit(-1);
-		}
-		if (SHOW_SIM_OUTPUT)
-		{
-			DEBUGN("ADDR='"<<hex<<addr<<dec<<"',CMD='"<<transType<<"'");//',DATA='"<<dataBuffer[0]<<"'");
-		}
-
-		//parse data
-		//if we are running in a no storage mode, don't allocate space, just return NULL
-#ifndef NO_STORAGE
-		if (dataStr.size() > 0 && transType == DATA_WRITE)
-		{
-			// 32 bytes of data per transaction
-			dataBuffer = (uint64_t *)calloc(sizeof(uint64_t),4);
-			size_t strlen = dataStr.size();
-			for (int i=0; i < 4; i++)
-			{
-				size_t startIndex = i*16;
-				if (startIndex > strlen)
-				{
-					break;
-				}
-				size_t charsLeft = min(((size_t)16), strlen - startIndex + 1);
-				string piece = dataStr.substr(i*16,charsLeft);
-				istringstream iss(piece);
-				iss >> hex >> dataBuffer[i];
-			}
-			PRINTN("\tDATA=");
-			BusPacket::printData(dataBuffer);
-		}
-
-		PRINT("");
-#endif
-		break;
-	}
-	return dataBuffer;
-}
-
-void Stimulus::Initialize()
-{
-    _pfCallback     = NULL;
-#if (UNIT_TEST_SEQUENTIAL_DATA == 1)
-    _nAddrKeeper		= 0;
-    _bWrite				= false;
-#endif
-}
-
-void Stimulus::Reset()
-{
-    Initialize();
-    resetDataOutPort();
-}
-
-
-
-
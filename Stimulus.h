@@ -52,6 +52,8 @@ typedef enum {
 
 #define		UNIT_TEST_SEQUENTIAL_DATA				(0)
 
+#include "TraceReader.h"
+
 
 typedef     void (*GETRESP_PF)(uint32_t nTransId, uint32_t nAddr, uint32_t nData, STIMUL_IO_TYPE nIoType);
 
@@ -83,10 +85,10 @@ SC_MODULE(Stimulus)
 	/* INTERNAL STATE                                                       */
 	/************************************************************************/
 	uint64_t			_nClockCycle;
-	ifstream			*_ptraceFile;
+	TraceReader			*_pTraceReader;
+	bool				_bTraceDone;
 	uint64_t			_nReadBuffer[4];
     uint64_t			_nWriteBuffer[4];
-	TraceType			_traceType;
     GETRESP_PF          _pfCallback;
 
     std::map<uint32_t, uint32_t>    _writeTransIdMap;  // address, trans id
@@ -100,7 +102,7 @@ SC_MODULE(Stimulus)
     /* public                                                               */
     /************************************************************************/
     void        Initialize();
-	void	    AttachTracefile(ifstream *pfStream, TraceType traceType) { _ptraceFile = pfStream; _traceType = traceType;};
+	void	    AttachTraceReader(TraceReader *pReader) { _pTraceReader = pReader; _bTraceDone = false;};
     void        RegisterCallback(GETRESP_PF pfCallback);
     uint32_t    IssueRequest(uint32_t nTransId, uint32_t nAddr, uint32_t nData, STIMUL_IO_TYPE nIoType);
     void        Reset();
@@ -118,13 +120,12 @@ SC_MODULE(Stimulus)
 	void	    resetDataOutPort();
 	void	    getDataPort(uint64_t *pData);
 	void	    idleState();
-	void*	    parseTraceFileLine(string &line, uint64_t &addr, TransactionType &transType, uint64_t &clockCycle, TraceType type);
 #if (UNIT_TEST_SEQUENTIAL_DATA == 1)
 	void	    verifyData();
 	bool	    sequentialIo(uint64_t nMaxAddrTest);
 #endif
 
-    SC_CTOR(Stimulus) : _nClockCycle(0)
+    SC_CTOR(Stimulus) : _nClockCycle(0), _pTraceReader(NULL), _bTraceDone(false)
     {
         Initialize();
 
@@ -38,9 +38,11 @@
 
 
 
-//number of latencies per bucket in the latency histogram
+//the latency histograms (LatencyHistogram.h) split every power of two into
+//2^HISTOGRAM_SUB_BUCKET_BITS buckets; larger latencies count as the maximum
 //TODO: move to system ini file
-#define HISTOGRAM_BIN_SIZE 10
+#define HISTOGRAM_SUB_BUCKET_BITS 5
+#define HISTOGRAM_MAX_VALUE 0xFFFFFFFFULL
 
 extern std::ofstream cmd_verify_out; //used by BusPacket.cpp if VERIFICATION_OUTPUT is enabled
 //extern std::ofstream visDataOut;
@@ -57,6 +59,25 @@ extern bool DEBUG_BANKS;
 extern bool DEBUG_POWER;
 extern bool USE_LOW_POWER;
 extern bool VIS_FILE_OUTPUT;
+extern bool BINARY_STATS_OUTPUT;
+extern bool ASYNC_LOG_OUTPUT;
+extern bool SHARED_STATS_OUTPUT;
+extern bool LATENCY_LOG_OUTPUT;
+extern bool ROW_HEAT_OUTPUT;
+extern bool STALL_STATS_OUTPUT;
+//empty unless a timeline is wanted, see Timeline.h
+extern std::string TIMELINE_WINDOW;
+
+//the DEBUG_* switches are only compiled in up to the build's TRACE_LEVEL
+//(make TRACE_LEVEL=#): 0 drops all of them, 1 keeps the ones that print per
+//command or transaction (bus, banks, address mapping), 2 also keeps the
+//per-cycle dumps (queues, bank states, power)
+#ifndef TRACE_LEVEL
+#define TRACE_LEVEL 2
+#endif
+#define TRACE_COMMANDS 1
+#define TRACE_CYCLES 2
+#define TRACE_ON(level, flag) (TRACE_LEVEL >= (level) && (flag))
 
 extern uint64_t TOTAL_STORAGE;
 extern uint NUM_BANKS;
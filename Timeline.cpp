@@ -0,0 +1,415 @@
+/****************************************************************************
+*	 DRAMSim2: A Cycle Accurate DRAM simulator 
+*	 
+*	 Copyright (C) 2010   	Elliott Cooper-Balis
+*									Paul Rosenfeld 
+*									Bruce Jacob
+*									University of Maryland
+*
+*	 This program is free software: you can redistribute it and/or modify
+*	 it under the terms of the GNU General Public License as published by
+*	 the Free Software Foundation, either version 3 of the License, or
+*	 (at your option) any later version.
+*
+*	 This program is distributed in the hope that it will be useful,
+*	 but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	 MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	 GNU General Public License for more details.
+*
+*	 You should have received a copy of the GNU General Public License
+*	 along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*****************************************************************************/
+
+
+
+//Timeline.cpp
+//
+//Class file for the Chrome trace-event timeline writer
+//
+
+#include "Timeline.h"
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+using namespace DRAMSim;
+using namespace std;
+
+namespace
+{
+const char *commandNames[] = {"READ", "READ_P", "WRITE", "WRITE_P", "ACT", "PRE", "REF", "DATA"};
+
+//track ids within a memory system's process
+enum
+{
+	COMMAND_BUS_TRACK,
+	DATA_BUS_TRACK,
+	FIRST_BANK_TRACK
+};
+
+//cycles to the microseconds trace events are timed in
+inline double microseconds(uint64_t cycle)
+{
+	return (double)cycle * tCK * 1E-3;
+}
+
+//starts one element of the traceEvents array
+inline void nextEvent(ostream &out, bool &first)
+{
+	out << (first ? "\n" : ",\n");
+	first = false;
+}
+
+void writeTrackName(ostream &out, bool &first, unsigned pid, unsigned tid, const string &name)
+{
+	nextEvent(out, first);
+	out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << tid
+	    << ",\"args\":{\"name\":\"" << name << "\"}}";
+	nextEvent(out, first);
+	out << "{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << tid
+	    << ",\"args\":{\"sort_index\":" << tid << "}}";
+}
+}
+
+TimelineWriter::TimelineWriter(const string &filename, const string &window, unsigned systemID) :
+		filename(filename),
+		systemID(systemID),
+		start(0),
+		cycles(TIMELINE_DEFAULT_CYCLES),
+		end(0),
+		latencyTrigger(0),
+		triggerCycle(0),
+		triggered(false),
+		done(false)
+{
+	size_t begin = 0;
+	while (begin < window.size())
+	{
+		size_t comma = window.find(',', begin);
+		string item = window.substr(begin, comma == string::npos ? string::npos : comma - begin);
+		begin = comma == string::npos ? window.size() : comma + 1;
+
+		size_t colon = item.find(':');
+		char *valueEnd = NULL;
+		uint64_t value = colon == string::npos ? 0 : strtoull(item.c_str() + colon + 1, &valueEnd, 10);
+		if (colon == string::npos || valueEnd == item.c_str() + colon + 1 || *valueEnd != '\0')
+		{
+			ERROR("== Error - TIMELINE_WINDOW entry '"<<item<<"' is not key:number");
+			exit(-1);
+		}
+		string key = item.substr(0, colon);
+		if (key == "start")
+		{
+			start = value;
+		}
+		else if (key == "cycles")
+		{
+			cycles = value;
+		}
+		else if (key == "latency")
+		{
+			latencyTrigger = value;
+		}
+		else
+		{
+			ERROR("== Error - unknown TIMELINE_WINDOW key '"<<key<<"', expected start, cycles or latency");
+			exit(-1);
+		}
+	}
+	if (cycles == 0)
+	{
+		ERROR("== Error - TIMELINE_WINDOW needs a window of at least one cycle");
+		exit(-1);
+	}
+
+	//a trigger keeps the last half window around until it fires
+	end = latencyTrigger == 0 ? start + cycles : numeric_limits<uint64_t>::max();
+
+	BankTrack idle;
+	idle.state = Idle;
+	idle.row = 0;
+	idle.since = 0;
+	banks = vector<BankTrack>(NUM_RANKS*NUM_BANKS, idle);
+}
+
+TimelineWriter::~TimelineWriter()
+{
+}
+
+void TimelineWriter::push(const TimelineEvent &event)
+{
+	events.push_back(event);
+}
+
+void TimelineWriter::command(const BusPacket &packet, uint64_t cycle)
+{
+	if (!recording(cycle))
+	{
+		return;
+	}
+
+	TimelineEvent event = TimelineEvent();
+	event.begin = cycle;
+	event.end = cycle + max(tCMD, 1U);
+	event.id = packet.row;
+	event.address = packet.physicalAddress;
+	event.rank = packet.rank;
+	event.bank = packet.bank;
+	event.kind = TIMELINE_COMMAND;
+	event.type = packet.busPacketType;
+	push(event);
+
+	if (packet.busPacketType == READ || packet.busPacketType == READ_P ||
+	        packet.busPacketType == WRITE || packet.busPacketType == WRITE_P)
+	{
+		bool isRead = packet.busPacketType == READ || packet.busPacketType == READ_P;
+		event.begin = cycle + (isRead ? RL : WL);
+		event.end = event.begin + BL/2;
+		event.kind = TIMELINE_DATA;
+		push(event);
+	}
+}
+
+void TimelineWriter::transaction(bool isWrite, uint64_t id, uint64_t address, unsigned rank, unsigned bank,
+                                 uint64_t added, uint64_t completed, const uint64_t stageCycles[LATENCY_STAGES])
+{
+	if (!recording(completed))
+	{
+		return;
+	}
+
+	TimelineEvent event = TimelineEvent();
+	event.begin = added;
+	event.end = completed;
+	event.id = id;
+	event.address = address;
+	for (size_t s=0; s<LATENCY_STAGES; s++)
+	{
+		event.stageCycles[s] = (uint32_t)stageCycles[s];
+	}
+	event.rank = rank;
+	event.bank = bank;
+	event.kind = TIMELINE_TRANSACTION;
+	event.type = isWrite ? 1 : 0;
+	push(event);
+
+	if (latencyTrigger != 0 && !triggered && completed - added > latencyTrigger)
+	{
+		triggered = true;
+		triggerCycle = completed;
+		end = completed + (cycles - cycles/2);
+		cerr << "timeline triggered at cycle " << completed << " by transaction " << id
+		     << " (" << completed - added << " cycles)" << endl;
+	}
+}
+
+//closes the current state interval of a bank, Idle isn't drawn
+void TimelineWriter::endInterval(size_t bank, uint64_t cycle)
+{
+	BankTrack &track = banks[bank];
+	if (track.state != Idle && cycle > track.since)
+	{
+		TimelineEvent event = TimelineEvent();
+		event.begin = track.since;
+		event.end = cycle;
+		event.id = track.row;
+		event.rank = bank / NUM_BANKS;
+		event.bank = bank % NUM_BANKS;
+		event.kind = TIMELINE_BANK_STATE;
+		event.type = track.state;
+		push(event);
+	}
+	track.since = cycle;
+}
+
+void TimelineWriter::update(const vector< vector<BankState> > &bankStates, uint64_t cycle)
+{
+	if (done || cycle < start)
+	{
+		return;
+	}
+	if (cycle >= end)
+	{
+		write(end);
+		return;
+	}
+
+	for (size_t i=0; i<NUM_RANKS; i++)
+	{
+		for (size_t j=0; j<NUM_BANKS; j++)
+		{
+			const BankState &state = bankStates[i][j];
+			BankTrack &track = banks[i*NUM_BANKS+j];
+			if (cycle == start)
+			{
+				track.since = cycle;
+			}
+			if (state.currentBankState != track.state ||
+			        (state.currentBankState == RowActive && state.openRowAddress != track.row))
+			{
+				endInterval(i*NUM_BANKS+j, cycle);
+				track.state = state.currentBankState;
+				track.row = state.openRowAddress;
+			}
+		}
+	}
+
+	//until the trigger fires, only the last half window is kept
+	if (latencyTrigger != 0 && !triggered)
+	{
+		uint64_t keep = cycles/2;
+		while (!events.empty() && events.front().end + keep < cycle)
+		{
+			events.pop_front();
+		}
+	}
+}
+
+void TimelineWriter::close(uint64_t cycle)
+{
+	if (!done && cycle > start)
+	{
+		if (latencyTrigger != 0 && !triggered)
+		{
+			cerr << "timeline trigger never fired, keeping the last " << cycles/2 << " cycles" << endl;
+		}
+		write(min(cycle, end));
+	}
+}
+
+void TimelineWriter::write(uint64_t cycle)
+{
+	done = true;
+	for (size_t b=0; b<banks.size(); b++)
+	{
+		endInterval(b, cycle);
+	}
+
+	uint64_t windowStart = start;
+	if (latencyTrigger != 0)
+	{
+		uint64_t anchor = triggered ? triggerCycle : cycle;
+		windowStart = max(start, anchor > cycles/2 ? anchor - cycles/2 : 0);
+	}
+
+	ofstream out(filename.c_str());
+	if (!out)
+	{
+		ERROR("== Error - Could not open timeline file '"<<filename<<"'");
+		exit(-1);
+	}
+	out.setf(ios::fixed, ios::floatfield);
+	out.precision(6);
+
+	unsigned pid = systemID;
+	out << "{\"displayTimeUnit\":\"ns\",\"otherData\":{\"system\":" << systemID << ",\"tCK_ns\":" << tCK
+	    << ",\"start_cycle\":" << windowStart << ",\"end_cycle\":" << cycle;
+	if (triggered)
+	{
+		out << ",\"trigger_cycle\":" << triggerCycle << ",\"trigger_latency_cycles\":" << latencyTrigger;
+	}
+	out << "},\"traceEvents\":[";
+
+	bool first = true;
+	nextEvent(out, first);
+	out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"args\":{\"name\":\"DRAMSim system " << systemID << "\"}}";
+	writeTrackName(out, first, pid, COMMAND_BUS_TRACK, "command bus");
+	writeTrackName(out, first, pid, DATA_BUS_TRACK, "data bus");
+	for (size_t i=0; i<NUM_RANKS; i++)
+	{
+		for (size_t j=0; j<NUM_BANKS; j++)
+		{
+			ostringstream name;
+			name << "rank " << i << " bank " << j;
+			writeTrackName(out, first, pid, FIRST_BANK_TRACK + i*NUM_BANKS + j, name.str());
+		}
+	}
+
+	for (size_t e=0; e<events.size(); e++)
+	{
+		const TimelineEvent &event = events[e];
+		if (event.end < windowStart)
+		{
+			continue;
+		}
+		unsigned bankTrack = FIRST_BANK_TRACK + event.rank*NUM_BANKS + event.bank;
+		switch (event.kind)
+		{
+		case TIMELINE_COMMAND:
+			nextEvent(out, first);
+			out << "{\"name\":\"" << commandNames[event.type] << "\",\"cat\":\"command\",\"ph\":\"X\",\"pid\":" << pid
+			    << ",\"tid\":" << COMMAND_BUS_TRACK << ",\"ts\":" << microseconds(event.begin)
+			    << ",\"dur\":" << microseconds(event.end - event.begin)
+			    << ",\"args\":{\"cycle\":" << event.begin << ",\"rank\":" << event.rank << ",\"bank\":" << event.bank;
+			if (event.type != REFRESH)
+			{
+				out << ",\"row\":" << event.id;
+			}
+			out << "}}";
+			if (event.type != REFRESH)
+			{
+				nextEvent(out, first);
+				out << "{\"name\":\"" << commandNames[event.type] << "\",\"cat\":\"command\",\"ph\":\"i\",\"s\":\"t\",\"pid\":" << pid
+				    << ",\"tid\":" << bankTrack << ",\"ts\":" << microseconds(event.begin) << "}";
+			}
+			break;
+		case TIMELINE_DATA:
+			nextEvent(out, first);
+			out << "{\"name\":\"" << (event.type == READ || event.type == READ_P ? "read" : "write")
+			    << "\",\"cat\":\"data\",\"ph\":\"X\",\"pid\":" << pid << ",\"tid\":" << DATA_BUS_TRACK
+			    << ",\"ts\":" << microseconds(event.begin) << ",\"dur\":" << microseconds(event.end - event.begin)
+			    << ",\"args\":{\"rank\":" << event.rank << ",\"bank\":" << event.bank << "}}";
+			break;
+		case TIMELINE_BANK_STATE:
+		{
+			uint64_t begin = max(event.begin, windowStart);
+			nextEvent(out, first);
+			out << "{\"name\":\"";
+			switch (event.type)
+			{
+			case RowActive:
+				out << "active row " << event.id;
+				break;
+			case Precharging:
+				out << "precharging";
+				break;
+			case Refreshing:
+				out << "refreshing";
+				break;
+			default:
+				out << "power down";
+				break;
+			}
+			out << "\",\"cat\":\"bank\",\"ph\":\"X\",\"pid\":" << pid << ",\"tid\":" << bankTrack
+			    << ",\"ts\":" << microseconds(begin) << ",\"dur\":" << microseconds(event.end - begin) << "}";
+			break;
+		}
+		case TIMELINE_TRANSACTION:
+		{
+			const char *name = event.type ? "write" : "read";
+			nextEvent(out, first);
+			out << "{\"name\":\"" << name << "\",\"cat\":\"transaction\",\"ph\":\"b\",\"id\":" << event.id
+			    << ",\"pid\":" << pid << ",\"tid\":" << bankTrack << ",\"ts\":" << microseconds(event.begin)
+			    << ",\"args\":{\"address\":\"0x" << hex << event.address << dec << "\",\"rank\":" << event.rank
+			    << ",\"bank\":" << event.bank << ",\"latency_cycles\":" << event.end - event.begin;
+			for (size_t s=0; s<LATENCY_STAGES; s++)
+			{
+				out << ",\"" << latencyStageNames[s] << "_cycles\":" << event.stageCycles[s];
+			}
+			out << "}}";
+			nextEvent(out, first);
+			out << "{\"name\":\"" << name << "\",\"cat\":\"transaction\",\"ph\":\"e\",\"id\":" << event.id
+			    << ",\"pid\":" << pid << ",\"tid\":" << bankTrack << ",\"ts\":" << microseconds(event.end) << "}";
+			break;
+		}
+		}
+	}
+	out << "\n]}\n";
+	out.close();
+
+	cerr << "wrote timeline of cycles " << windowStart << " to " << cycle << " to " << filename << endl;
+	events.clear();
+}
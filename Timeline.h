@@ -0,0 +1,128 @@
+/****************************************************************************
+*	 DRAMSim2: A Cycle Accurate DRAM simulator 
+*	 
+*	 Copyright (C) 2010   	Elliott Cooper-Balis
+*									Paul Rosenfeld 
+*									Bruce Jacob
+*									University of Maryland
+*
+*	 This program is free software: you can redistribute it and/or modify
+*	 it under the terms of the GNU General Public License as published by
+*	 the Free Software Foundation, either version 3 of the License, or
+*	 (at your option) any later version.
+*
+*	 This program is distributed in the hope that it will be useful,
+*	 but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	 MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	 GNU General Public License for more details.
+*
+*	 You should have received a copy of the GNU General Public License
+*	 along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*****************************************************************************/
+
+
+
+#ifndef TIMELINE_H
+#define TIMELINE_H
+
+//Timeline.h
+//
+//Exports a window of the simulation as Chrome trace-event JSON, which
+//chrome://tracing and ui.perfetto.dev open directly. Every memory system is
+//a process with a command bus track, a data bus track (bursts placed RL or WL
+//after their column command) and one track per bank showing its state
+//(active with the open row, precharging, refreshing, powered down) and its
+//commands. Each transaction is an async span from the transaction queue to
+//completion, with its latency stages as arguments.
+//
+//The window is set with TIMELINE_WINDOW in the system ini file, a comma
+//separated list of
+//	start:<cycle>	first cycle recorded (default 0)
+//	cycles:<n>	length of the window (default TIMELINE_DEFAULT_CYCLES)
+//	latency:<n>	trigger: wait for a transaction that takes more than n
+//			cycles and center the window on its completion
+//ex: TIMELINE_WINDOW=start:2000000,cycles:20000 or TIMELINE_WINDOW=latency:3000
+//Only the window is held in memory, and nothing is recorded outside it.
+//
+
+#include <deque>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "BankState.h"
+
+// default window length, in cycles
+#define TIMELINE_DEFAULT_CYCLES 100000
+
+namespace DRAMSim
+{
+
+enum TimelineEventKind
+{
+	TIMELINE_COMMAND,
+	TIMELINE_BANK_STATE,
+	TIMELINE_DATA,
+	TIMELINE_TRANSACTION
+};
+
+struct TimelineEvent
+{
+	uint64_t begin;	// cycles
+	uint64_t end;
+	uint64_t id;	// transaction id, or the row of a command or active bank
+	uint64_t address;
+	uint32_t stageCycles[LATENCY_STAGES];	// transactions only
+	uint16_t rank;
+	uint16_t bank;
+	uint8_t kind;	// TimelineEventKind
+	uint8_t type;	// BusPacketType, CurrentBankState, or 1 for a write transaction
+};
+
+class TimelineWriter
+{
+public:
+	TimelineWriter(const std::string &filename, const std::string &window, unsigned systemID);
+	virtual ~TimelineWriter();
+
+	//whether events at this cycle go into the timeline
+	bool recording(uint64_t cycle) const { return !done && cycle >= start && cycle < end; }
+
+	void command(const BusPacket &packet, uint64_t cycle);
+	void transaction(bool isWrite, uint64_t id, uint64_t address, unsigned rank, unsigned bank,
+	                 uint64_t added, uint64_t completed, const uint64_t stageCycles[LATENCY_STAGES]);
+	//once per cycle, after the controller has updated the bank states
+	void update(const std::vector< std::vector<BankState> > &bankStates, uint64_t cycle);
+	//writes what has been recorded so far if the window hasn't closed yet
+	void close(uint64_t cycle);
+
+private:
+	//open state interval of a bank
+	struct BankTrack
+	{
+		CurrentBankState state;
+		uint row;
+		uint64_t since;
+	};
+
+	void push(const TimelineEvent &event);
+	void endInterval(size_t bank, uint64_t cycle);
+	void write(uint64_t cycle);
+
+	std::string filename;
+	unsigned systemID;
+	uint64_t start;
+	uint64_t cycles;
+	uint64_t end;
+	uint64_t latencyTrigger;	// 0 if the window doesn't wait for a trigger
+	uint64_t triggerCycle;
+	bool triggered;
+	bool done;
+
+	std::deque<TimelineEvent> events;
+	std::vector<BankTrack> banks;
+};
+
+}
+
+#endif
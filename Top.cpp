@@ -0,0 +1,216 @@
+/****************************************************************************
+*	 DRAMSim2: A Cycle Accurate DRAM simulator 
+*	 
+*	 Copyright (C) 2010   	Elliott Cooper-Balis
+*									Paul Rosenfeld 
+*									Bruce Jacob
+*									University of Maryland
+*
+*	 This program is free software: you can redistribute it and/or modify
+*	 it under the terms of the GNU General Public License as published by
+*	 the Free Software Foundation, either version 3 of the License, or
+*	 (at your option) any later version.
+*
+*	 This program is distributed in the hope that it will be useful,
+*	 but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	 MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	 GNU General Public License for more details.
+*
+*	 You should have received a copy of the GNU General Public License
+*	 along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*****************************************************************************/
+
+
+
+//Top.cpp
+//
+//Watches a running simulation through its shared memory stats segment (see
+//SharedStats.h): simulation speed, bandwidth, power, latency percentiles
+//and queue occupancies, refreshed every few seconds. Only reads the
+//segment, so it can be attached and detached at any time.
+//
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <getopt.h>
+#include <cstdlib>
+#include <cstring>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+#include "SystemConfiguration.h"
+#include "SharedStats.h"
+
+using namespace DRAMSim;
+using namespace std;
+
+void usage()
+{
+	cout << "dramsim-top Usage: " << endl;
+	cout << "dramsim-top [-i seconds] [-s id] [-1] PID|/SEGMENT" << endl;
+	cout << "\t-i, --interval=SECONDS \ttime between refreshes (default: 2)" << endl;
+	cout << "\t-s, --system=ID \tthe memory system of PID to watch (default: 0)" << endl;
+	cout << "\t-1, --once \tprint a single report instead of refreshing the screen" << endl;
+	cout << "\tThe simulation has to run with SHARED_STATS_OUTPUT=true in its system ini file" << endl;
+}
+
+double now()
+{
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec * 1E-6;
+}
+
+//a page copy plus the wall clock time it was taken at
+struct Sample
+{
+	vector<uint64_t> buffer;
+	double time;
+
+	SharedStatsHeader *header() { return (SharedStatsHeader *)&buffer[0]; }
+	uint64_t *rankColumn(unsigned c) { return sharedStatsRankColumn(header(), c); }
+	uint64_t *bankColumn(unsigned c) { return sharedStatsBankColumn(header(), c); }
+};
+
+void take(const SharedStatsReader &reader, Sample &sample)
+{
+	sample.buffer.resize((reader.Bytes() + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+	reader.read(sample.header());
+	sample.time = now();
+}
+
+//everything is a rate over the interval between two samples
+void report(Sample &previous, Sample &current, ostream &out)
+{
+	SharedStatsHeader *h = current.header();
+	uint64_t cycles = h->cycle - previous.header()->cycle;
+	double seconds = (double)cycles * h->tCK * 1E-9;
+	double wallSeconds = current.time - previous.time;
+
+	out << "dramsim-top   pid " << h->pid << " system " << h->systemID
+	    << (h->finished ? "   [finished]" : "") << endl;
+	out << "cycle " << h->cycle << " (" << h->cycle * h->tCK * 1E-6 << " ms simulated)   "
+	    << fixed << setprecision(0) << (wallSeconds > 0 ? cycles / wallSeconds : 0.0) << " cycles/s" << endl;
+	out << "transaction queue " << h->transactionQueue << "   reads in flight " << h->pendingReads << endl;
+	out << setprecision(2);
+	out << "read latency  (ns) p50 " << h->readP50 * h->tCK << "  p90 " << h->readP90 * h->tCK
+	    << "  p99 " << h->readP99 * h->tCK << "  p99.9 " << h->readP999 * h->tCK << endl;
+	out << "write latency (ns) p50 " << h->writeP50 * h->tCK << "  p90 " << h->writeP90 * h->tCK
+	    << "  p99 " << h->writeP99 * h->tCK << "  p99.9 " << h->writeP999 * h->tCK << endl;
+	out << endl;
+
+	out << setw(5) << "rank" << setw(10) << "reads/s" << setw(10) << "writes/s" << setw(10) << "GB/s"
+	    << setw(10) << "power W" << setw(10) << "cmd queue" << endl;
+	for (size_t i=0; i<h->numRanks; i++)
+	{
+		uint64_t reads = 0, writes = 0;
+		for (size_t j=0; j<h->numBanks; j++)
+		{
+			size_t bank = i*h->numBanks + j;
+			reads += current.bankColumn(SHARED_READS)[bank] - previous.bankColumn(SHARED_READS)[bank];
+			writes += current.bankColumn(SHARED_WRITES)[bank] - previous.bankColumn(SHARED_WRITES)[bank];
+		}
+		uint64_t energy = 0;
+		for (unsigned c=0; c<SHARED_STATS_RANK_COUNTERS; c++)
+		{
+			energy += current.rankColumn(c)[i] - previous.rankColumn(c)[i];
+		}
+		double power = cycles == 0 ? 0.0 : ((double)energy / (double)cycles) * h->Vdd / 1000.0;
+		double bandwidth = seconds == 0 ? 0.0 : ((double)(reads + writes) * h->bytesPerTransaction / (1024.0*1024.0*1024.0)) / seconds;
+
+		out << setw(5) << i
+		    << setw(10) << setprecision(0) << (seconds == 0 ? 0.0 : reads / seconds)
+		    << setw(10) << (seconds == 0 ? 0.0 : writes / seconds)
+		    << setw(10) << setprecision(2) << bandwidth
+		    << setw(10) << power
+		    << setw(10) << current.rankColumn(SHARED_COMMAND_QUEUE)[i] << endl;
+	}
+	out.unsetf(ios::floatfield);
+}
+
+int main(int argc, char **argv)
+{
+	double interval = 2.0;
+	unsigned systemID = 0;
+	bool once = false;
+
+	while (1)
+	{
+		static struct option long_options[] =
+		{
+			{"interval", required_argument, 0, 'i'},
+			{"system", required_argument, 0, 's'},
+			{"once", no_argument, 0, '1'},
+			{"help", no_argument, 0, 'h'},
+			{0, 0, 0, 0}
+		};
+		int option_index=0;
+		int c = getopt_long(argc, argv, "i:s:1h", long_options, &option_index);
+		if (c == -1)
+		{
+			break;
+		}
+		switch (c)
+		{
+		case 'i':
+			interval = atof(optarg);
+			break;
+		case 's':
+			systemID = atoi(optarg);
+			break;
+		case '1':
+			once = true;
+			break;
+		case 'h':
+			usage();
+			exit(0);
+		default:
+			usage();
+			exit(-1);
+		}
+	}
+	if (optind != argc - 1 || interval <= 0)
+	{
+		usage();
+		exit(-1);
+	}
+
+	string name = argv[optind];
+	if (name[0] != '/')
+	{
+		name = sharedStatsName(atoi(name.c_str()), systemID);
+	}
+	SharedStatsReader reader(name);
+
+	Sample previous, current;
+	take(reader, previous);
+	while (1)
+	{
+		usleep((useconds_t)(interval * 1E6));
+		take(reader, current);
+
+		if (!once)
+		{
+			cout << "\033[H\033[2J";
+		}
+		report(previous, current, cout);
+
+		//the segment outlives an exited simulation as long as it stays mapped here
+		bool exited = !current.header()->finished && kill(current.header()->pid, 0) != 0 && errno == ESRCH;
+		if (exited)
+		{
+			cout << "simulation exited" << endl;
+		}
+		if (once || exited || current.header()->finished)
+		{
+			break;
+		}
+		previous.buffer.swap(current.buffer);
+		previous.time = current.time;
+	}
+	return 0;
+}
@@ -44,14 +44,10 @@
 #include "SystemConfiguration.h"
 #include "MemorySystem.h"
 #include "Transaction.h"
-
-//#define USE_SYSTEM_C_INTERFACE					(1)
-
-#if (USE_SYSTEM_C_INTERFACE == 1)
-#include "systemc.h"
-#include "SCIC.h"
-#include "Stimulus.h"
-#endif
+#include "TracePipeline.h"
+#include "TrafficGenerator.h"
+#include "ClosedLoopReplay.h"
+#include "MultiTrace.h"
 
 
 using namespace DRAMSim;
@@ -60,9 +56,6 @@ using namespace std;
 //#define RETURN_TRANSACTIONS 1
 
 #ifndef _SIM_
-int SHOW_SIM_OUTPUT = 1;
-ofstream visDataOut; //mostly used in MemoryController
-
 #ifdef RETURN_TRANSACTIONS
 class TransactionReceiver
 {
@@ -145,10 +138,19 @@ void usage()
 {
 	cout << "DRAMSim2 Usage: " << endl;
 	cout << "DRAMSim -t tracefile -s system.ini -d ini/device.ini [-c #] [-p pwd] -q" <<endl;
+	cout << "DRAMSim -g pattern[,key=value...] -s system.ini -d ini/device.ini [-c #] [-p pwd] -q" <<endl;
 	cout << "\t-t, --tracefile=FILENAME \tspecify a tracefile to run  "<<endl;
+	cout << "\t\t\t\t\tgive -t once per core to mix traces; FILENAME[,scale=#][,rate=#][,offset=#]"<<endl;
+	cout << "\t\t\t\t\tissues a trace's requests at its timestamps times scale (or over rate),"<<endl;
+	cout << "\t\t\t\t\tand offsets its addresses"<<endl;
+	cout << "\t-g, --generator=SPEC \t\tgenerate traffic instead of reading a trace; SPEC is uniform, stream, stride"<<endl;
+	cout << "\t\t\t\t\tor rowhostile followed by any of seed=#, rate=# (requests/cycle), outstanding=#,"<<endl;
+	cout << "\t\t\t\t\treads=# (read fraction), stride=# (bytes), rank=#, bank=# (ex: -g uniform,rate=0.25,reads=0.7)"<<endl;
 	cout << "\t-s, --systemini=FILENAME \tspecify an ini file that describes the memory system parameters  "<<endl;
 	cout << "\t-d, --deviceini=FILENAME \tspecify an ini file that describes the device-level parameters"<<endl;
 	cout << "\t-c, --numcycles=# \t\tspecify number of cycles to run the simulation for [default=30] "<<endl;
+	cout << "\t-w, --window=# \t\tclosed-loop replay: stall the trace once # reads are outstanding"<<endl;
+	cout << "\t-T, --thinktime \t\twith -w, keep the trace's cycle gaps as time between requests"<<endl;
 	cout << "\t-q, --quiet \t\t\tflag to suppress simulation output (except final stats) [default=no]"<<endl;
 	cout << "\t-o, --option=OPTION_A=234\t\t\toverwrite any ini file option from the command line"<<endl;
 	cout << "\t-p, --pwd=DIRECTORY\t\tSet the working directory (i.e. usually DRAMSim directory where ini/ and results/ are)"<<endl;
@@ -156,264 +158,21 @@ void usage()
 }
 #endif
 
-void *parseTraceFileLine(string &line, uint64_t &addr, enum TransactionType &transType, uint64_t &clockCycle, TraceType type)
-{
-	size_t previousIndex=0;
-	size_t spaceIndex=0;
-	uint64_t *dataBuffer = NULL;
-	string addressStr="", cmdStr="", dataStr="", ccStr="";
-#ifndef _SIM_
-	bool useClockCycle = false;
-#else
-	bool useClockCycle = true;
-#endif
-
-	switch (type)
-	{
-	case k6:
-	{
-		spaceIndex = line.find_first_of(" ", 0);
-
-		addressStr = line.substr(0, spaceIndex);
-		previousIndex = spaceIndex;
-
-		spaceIndex = line.find_first_not_of(" ", previousIndex);
-		cmdStr = line.substr(spaceIndex, line.find_first_of(" ", spaceIndex) - spaceIndex);
-		previousIndex = line.find_first_of(" ", spaceIndex);
-
-		spaceIndex = line.find_first_not_of(" ", previousIndex);
-		ccStr = line.substr(spaceIndex, line.find_first_of(" ", spaceIndex) - spaceIndex);
-
-		if (cmdStr.compare("P_MEM_WR")==0 ||
-		        cmdStr.compare("BOFF")==0)
-		{
-			transType = DATA_WRITE;
-		}
-		else if (cmdStr.compare("P_FETCH")==0 ||
-		         cmdStr.compare("P_MEM_RD")==0 ||
-		         cmdStr.compare("P_LOCK_RD")==0 ||
-		         cmdStr.compare("P_LOCK_WR")==0)
-		{
-			transType = DATA_READ;
-		}
-		else
-		{
-			ERROR("== Unknown Command : "<<cmdStr);
-			exit(0);
-		}
-
-		istringstream a(addressStr.substr(2));//gets rid of 0x
-		a>>hex>>addr;
-
-		//if this is set to false, clockCycle will remain at 0, and every line read from the trace
-		//  will be allowed to be issued
-		if (useClockCycle)
-		{
-			istringstream b(ccStr);
-			b>>clockCycle;
-		}
-		break;
-	}
-	case mase:
-	{
-		spaceIndex = line.find_first_of(" ", 0);
-
-		addressStr = line.substr(0, spaceIndex);
-		previousIndex = spaceIndex;
-
-		spaceIndex = line.find_first_not_of(" ", previousIndex);
-		cmdStr = line.substr(spaceIndex, line.find_first_of(" ", spaceIndex) - spaceIndex);
-		previousIndex = line.find_first_of(" ", spaceIndex);
-
-		spaceIndex = line.find_first_not_of(" ", previousIndex);
-		ccStr = line.substr(spaceIndex, line.find_first_of(" ", spaceIndex) - spaceIndex);
-
-		if (cmdStr.compare("IFETCH")==0||
-		        cmdStr.compare("READ")==0)
-		{
-			transType = DATA_READ;
-		}
-		else if (cmdStr.compare("WRITE")==0)
-		{
-			transType = DATA_WRITE;
-		}
-		else
-		{
-			ERROR("== Unknown command in tracefile : "<<cmdStr);
-		}
-
-		istringstream a(addressStr.substr(2));//gets rid of 0x
-		a>>hex>>addr;
-
-		//if this is set to false, clockCycle will remain at 0, and every line read from the trace
-		//  will be allowed to be issued
-		if (useClockCycle)
-		{
-			istringstream b(ccStr);
-			b>>clockCycle;
-		}
-
-		break;
-	}
-	case misc:
-		spaceIndex = line.find_first_of(" ", spaceIndex+1);
-		if (spaceIndex == string::npos)
-		{
-			ERROR("Malformed line: '"<< line <<"'");
-		}
-
-		addressStr = line.substr(previousIndex,spaceIndex);
-		previousIndex=spaceIndex;
-
-		spaceIndex = line.find_first_of(" ", spaceIndex+1);
-		if (spaceIndex == string::npos)
-		{
-			cmdStr = line.substr(previousIndex+1);
-		}
-		else
-		{
-			cmdStr = line.substr(previousIndex+1,spaceIndex-previousIndex-1);
-			dataStr = line.substr(spaceIndex+1);
-		}
-
-		//convert address string -> number
-		istringstream b(addressStr.substr(2)); //substr(2) chops off 0x characters
-		b >>hex>> addr;
-
-		// parse command
-		if (cmdStr.compare("read") == 0)
-		{
-			transType=DATA_READ;
-		}
-		else if (cmdStr.compare("write") == 0)
-		{
-			transType=DATA_WRITE;
-		}
-		else
-		{
-			ERROR("INVALID COMMAND '"<<cmdStr<<"'");
-			exit(-1);
-		}
-		if (SHOW_SIM_OUTPUT)
-		{
-			DEBUGN("ADDR='"<<hex<<addr<<dec<<"',CMD='"<<transType<<"'");//',DATA='"<<dataBuffer[0]<<"'");
-		}
-
-		//parse data
-		//if we are running in a no storage mode, don't allocate space, just return NULL
-#ifndef NO_STORAGE
-		if (dataStr.size() > 0 && transType == DATA_WRITE)
-		{
-			// 32 bytes of data per transaction
-			dataBuffer = (uint64_t *)calloc(sizeof(uint64_t),4);
-			size_t strlen = dataStr.size();
-			for (int i=0; i < 4; i++)
-			{
-				size_t startIndex = i*16;
-				if (startIndex > strlen)
-				{
-					break;
-				}
-				size_t charsLeft = min(((size_t)16), strlen - startIndex + 1);
-				string piece = dataStr.substr(i*16,charsLeft);
-				istringstream iss(piece);
-				iss >> hex >> dataBuffer[i];
-			}
-			PRINTN("\tDATA=");
-			BusPacket::printData(dataBuffer);
-		}
-
-		PRINT("");
-#endif
-		break;
-	}
-	return dataBuffer;
-}
-
 #ifndef _SIM_
 
-void alignTransactionAddress(Transaction &trans)
-{
-	// zero out the low order bits which correspond to the size of a transaction
-
-	unsigned throwAwayBits = dramsim_log2((BL*JEDEC_DATA_BUS_BITS/8));
-
-	trans.address >>= throwAwayBits;
-	trans.address <<= throwAwayBits;
-}
-
-#if ((USE_SYSTEM_C_INTERFACE == 1) && (USE_SCIC_MEMSYS_QUERY == 1) )
-void ExampleforDisplayingStatistics( SCIC &memSystemSc ) 
+unsigned transactionAlignmentBits()
 {
-
-	//
-	// test for displaying performance
-	// In practice, you don't need buch of these vector to query memory system information.
-	// It is just for test (comparison to original statistics)
-	//
-
-	// energy test
-	vector<double> energyInfos[SCIC_NUMS_ENERGY_TYPE];
-	for(int nQueryType = 0; nQueryType < SCIC_NUMS_ENERGY_TYPE; nQueryType++)
-	{
-		energyInfos[nQueryType] = vector<double>(NUM_RANKS,0.0);
-		memSystemSc.GetElapsedEnergyInfo(energyInfos[nQueryType], (SCIC_ENERGY_QUERY)nQueryType);
-	}
-	vector<double> averageEnergyInfo					= vector<double>(NUM_RANKS,0.0);
-	memSystemSc.GetElapsedEnergyInfo(averageEnergyInfo, SCIC_ENERGY_AVERAGE);
-
-	// performance test
-	vector<double> latencyInfo						= vector<double>(NUM_RANKS*NUM_BANKS,0.0);
-	vector<double> bandwidthInfo					= vector<double>(NUM_RANKS*NUM_BANKS,0.0);
-
-	// statistics test
-	vector<uint64_t> numsRead						= vector<uint64_t>(NUM_RANKS*NUM_BANKS,0.0);
-	vector<uint64_t> numsWrite						= vector<uint64_t>(NUM_RANKS*NUM_BANKS,0.0);
-
-
-	PRINT( " =====================SCIC==============================" );
-
-	PRINTN( "   Total Return Transactions : " << memSystemSc.GetTotalNumsTransactions() );
-	PRINT( " ("<<memSystemSc.GetTotalNumsTransactions() * memSystemSc.GetBytePerTransaction() <<" bytes) aggregate average bandwidth "<<memSystemSc.GetElapsedPerfromanceInfo(bandwidthInfo, SCIC_PERF_BANDWIDTH)<<"GB/s");
-
-
-	cout << "Total write requests : " << memSystemSc.GetNumsElapsedIo(numsWrite, SCIC_STAT_WRITE)  << endl;
-	cout << "Total read requests : " << memSystemSc.GetNumsElapsedIo(numsRead, SCIC_STAT_READ)  << endl;
-
-	memSystemSc.GetElapsedPerfromanceInfo(latencyInfo, SCIC_PERF_LATENCY);
-	for (size_t i=0;i<NUM_RANKS;i++)
-	{
-
-		PRINT( "      -Rank   "<<i<<" : ");
-		PRINTN( "        -Reads  : " << numsRead[i]);
-		PRINT( " ("<<numsRead[i] * memSystemSc.GetBytePerTransaction()<<" bytes)");
-		PRINTN( "        -Writes : " << numsWrite[i]);
-		PRINT( " ("<<numsWrite[i] * memSystemSc.GetBytePerTransaction()<<" bytes)");
-
-		for (size_t j=0;j<NUM_BANKS;j++)
-		{
-			PRINT( "        -Bandwidth / Latency  (Bank " <<j<<"): " <<bandwidthInfo[SEQUENTIAL(i,j)] << " GB/s\t\t" <<latencyInfo[SEQUENTIAL(i,j)] << " ns");
-		}
-
-		PRINT( " == Power Data for Rank        " << i );
-		PRINT( "   Average Power (watts)     : " << averageEnergyInfo[i] );
-		PRINT( "     -Background (watts)     : " << energyInfos[SCIC_ENERGY_BACKGROUND][i] );
-		PRINT( "     -Act/Pre    (watts)     : " << energyInfos[SCIC_ENERGY_PRECHARGE][i] );
-		PRINT( "     -Burst      (watts)     : " << energyInfos[SCIC_ENERGY_BURST][i]);
-		PRINT( "     -Refresh    (watts)     : " << energyInfos[SCIC_ENERGY_REFRESH][i] );
-
-
-	}
+	// the low order bits which correspond to the size of a transaction get zeroed out
+	return dramsim_log2((BL*JEDEC_DATA_BUS_BITS/8));
 }
 
-#endif
-
 
 int main(int argc, char **argv)
 {
 	int c;
 	string traceFileName = "";
-	TraceType traceType;
+	vector<string> traceSpecs;
+	string generatorSpec = "";
 	string systemIniFilename = "system.ini";
 	string deviceIniFilename = "";
 	string pwdString = "";
@@ -426,6 +185,8 @@ int main(int argc, char **argv)
 	size_t equalsign;
 
 	uint numCycles=1000;
+	unsigned window=0;
+	bool thinkTime=false;
 	//getopt stuff
 	while (1)
 	{
@@ -433,9 +194,12 @@ int main(int argc, char **argv)
 		{
 			{"deviceini", required_argument, 0, 'd'},
 			{"tracefile", required_argument, 0, 't'},
+			{"generator", required_argument, 0, 'g'},
 			{"systemini", required_argument, 0, 's'},
 			{"pwd", required_argument, 0, 'p'},
 			{"numcycles",  required_argument,	0, 'c'},
+			{"window",  required_argument,	0, 'w'},
+			{"thinktime",  no_argument,	0, 'T'},
 			{"option",  required_argument,	0, 'o'},
 			{"quiet",  no_argument, &SHOW_SIM_OUTPUT, 'q'},
 			{"help", no_argument, 0, 'h'},
@@ -443,7 +207,7 @@ int main(int argc, char **argv)
 			{0, 0	, 0, 0}
 		};
 		int option_index=0; //for getopt
-		c = getopt_long (argc, argv, "t:s:c:d:o:p:S:bkq", long_options, &option_index);
+		c = getopt_long (argc, argv, "t:g:s:c:w:Td:o:p:S:bkq", long_options, &option_index);
 		if (c == -1)
 		{
 			break;
@@ -469,6 +233,10 @@ int main(int argc, char **argv)
 			break;
 		case 't':
 			traceFileName = string(optarg);
+			traceSpecs.push_back(traceFileName);
+			break;
+		case 'g':
+			generatorSpec = string(optarg);
 			break;
 		case 's':
 			systemIniFilename = string(optarg);
@@ -479,6 +247,12 @@ int main(int argc, char **argv)
 		case 'c':
 			numCycles = atoi(optarg);
 			break;
+		case 'w':
+			window = atoi(optarg);
+			break;
+		case 'T':
+			thinkTime = true;
+			break;
 		case 'S':
 			megsOfMemory=atoi(optarg);
 			break;
@@ -502,30 +276,6 @@ int main(int argc, char **argv)
 		}
 	}
 
-	// get the trace filename
-	string temp = traceFileName.substr(traceFileName.find_last_of("/")+1);
-
-	//get the prefix of the trace name
-	temp = temp.substr(0,temp.find_first_of("_"));
-	if (temp=="mase")
-	{
-		traceType = mase;
-	}
-	else if (temp=="k6")
-	{
-		traceType = k6;
-	}
-	else if (temp=="misc")
-	{
-		traceType = misc;
-	}
-	else
-	{
-		ERROR("== Unknown Tracefile Type : "<<temp);
-		exit(0);
-	}
-
-
 	// no default value for the default model name
 	if (deviceIniFilename.length() == 0)
 	{
@@ -535,20 +285,68 @@ int main(int argc, char **argv)
 	}
 
 
-	//ignore the pwd argument if the argument is an absolute path
-	if (pwdString.length() > 0 && traceFileName[0] != '/')
+	if (generatorSpec.length() > 0)
 	{
-		traceFileName = pwdString + "/" +traceFileName;
+		TrafficGeneratorConfig generatorConfig = TrafficGenerator::parseSpec(generatorSpec);
+		MemorySystem *memorySystem = new MemorySystem(0, deviceIniFilename, systemIniFilename, pwdString, "generator_"+generatorSpec, megsOfMemory);
+		TrafficGenerator *generator = new TrafficGenerator(memorySystem, generatorConfig);
+		for (size_t i=0;i<numCycles;i++)
+		{
+			generator->update();
+			memorySystem->update();
+		}
+		memorySystem->printStats(true);
+		generator->printStats();
+
+		delete(generator);
+		delete(memorySystem);
+		return 0;
+	}
+
+	//every -t is one source (core); a single plain trace is read as it is
+	vector<TraceReader *> sources;
+	bool mixedTraces = traceSpecs.size() > 1 || (traceSpecs.size() == 1 && traceSpecs[0].find(',') != string::npos);
+	if (mixedTraces)
+	{
+		for (size_t i=0;i<traceSpecs.size();i++)
+		{
+			sources.push_back(SourceTraceReader::open(traceSpecs[i], i, pwdString, i == 0 ? &traceFileName : NULL));
+		}
 	}
+	else
+	{
+		//ignore the pwd argument if the argument is an absolute path
+		if (pwdString.length() > 0 && traceFileName[0] != '/')
+		{
+			traceFileName = pwdString + "/" +traceFileName;
+		}
 
-	DEBUG("== Loading trace file '"<<traceFileName<<"' == ");
+		DEBUG("== Loading trace file '"<<traceFileName<<"' == ");
 
-	ifstream traceFile;
-	string line;
+		sources.push_back(TraceReader::open(traceFileName));
+	}
 
 	MemorySystem *memorySystem = new MemorySystem(0, deviceIniFilename, systemIniFilename, pwdString, traceFileName, megsOfMemory);
 
+	if (window > 0)
+	{
+		ClosedLoopReplay *replay = new ClosedLoopReplay(memorySystem, window, thinkTime);
+		for (size_t i=0;i<sources.size();i++)
+		{
+			replay->addSource(new PipelinedTraceReader(sources[i], transactionAlignmentBits()));
+		}
+		for (size_t i=0;i<numCycles;i++)
+		{
+			replay->update();
+			memorySystem->update();
+		}
+		memorySystem->printStats(true);
+		replay->printStats();
 
+		delete(replay);
+		delete(memorySystem);
+		return 0;
+	}
 
 #ifdef RETURN_TRANSACTIONS
 	TransactionReceiver transactionReceiver; 
@@ -558,136 +356,34 @@ int main(int argc, char **argv)
 	memorySystem->RegisterCallbacks(read_cb, write_cb, NULL);
 #endif
 
-	uint64_t	addr;
+	//if this is set to false, clockCycle will remain at 0, and every line read from the trace
+	//  will be allowed to be issued. Mixed traces go in at their merged, scaled timestamps
+	//  so that scale= and rate= pace each source
+	bool useClockCycle = mixedTraces;
 	uint64_t	clockCycle	=	0;
-	enum TransactionType transType;
-
-	void *data	= NULL;
-	int lineNumber = 0;
 	Transaction trans;
+	TraceRecord record;
 	bool pendingTrans = false;
+	bool traceDone = false;
 
-	traceFile.open(traceFileName.c_str());
-
-	if (!traceFile.is_open())
-	{
-		cout << "== Error - Could not open trace file"<<endl;
-		exit(0);
-	}
-
-
-
-#if (USE_SYSTEM_C_INTERFACE  == 1)
-
-	sc_set_time_resolution(1, SC_NS);
-	sc_set_default_time_unit(1, SC_NS);
-	sc_clock				sysClk("clock", 2, SC_NS, 0.5, 0, SC_NS, true);
-	sc_signal<uint64_t>		sgnDestAddr;
-	sc_signal<uint64_t>		sgnBuffAddr;
-	sc_signal<bool>			sgnWriteEnable;
-
-	sc_signal<bool>			sgnDimmEnable;
-	sc_signal<bool>			sgnBiuBusy;
-	sc_signal<uint64_t>		sgnAddrOut;
-	sc_signal<bool>			sgnWriteOut;
-	sc_signal<bool>			sgnCompAck;
-
-
-	sc_signal<uint64_t>		sgnDataMemIn[4];
-	sc_signal<uint64_t>		sgnDataMemOut[4];
-
-	//
-	// make connection between system c interface and memory system
-	//
-	SCIC memSystemSc("SC_MemorySystem");
-	memSystemSc.AttachLegacyMemorySystem(memorySystem);
-	memSystemSc._prtCLK(sysClk.signal());
-
-	memSystemSc._prtDA(sgnDestAddr);
-	memSystemSc._prtWE(sgnWriteEnable);
-
-	memSystemSc._prtDE(sgnDimmEnable);
-	memSystemSc._prtRB(sgnBiuBusy);
-	memSystemSc._prtAO(sgnAddrOut);
-	memSystemSc._prtWO(sgnWriteOut);
-	memSystemSc._prtCA(sgnCompAck);
-
-	//
-	// Initializing Stimulus
-	//
-	Stimulus stimulus("Stimulus");
-	stimulus.AttachTracefile(&traceFile, traceType);
-	stimulus._prtAO(sgnDestAddr);
-	stimulus._prtRB(sgnBiuBusy);
-	stimulus._prtCLK(sysClk.signal());
-	stimulus._prtDE(sgnDimmEnable);
-	stimulus._prtWE(sgnWriteEnable);
-	stimulus._prtCA(sgnCompAck);
-	stimulus._prtAI(sgnAddrOut);
-	stimulus._prtWI(sgnWriteOut);
-
-	//
-	// System C trace
-	//
-	sc_trace_file *pfScTrace = sc_create_vcd_trace_file("wave");
-	sc_trace(pfScTrace, sysClk, "CLK");
-	sc_trace(pfScTrace, sgnDestAddr, "DA");
-	sc_trace(pfScTrace, sgnBuffAddr, "buffAddr");
-	sc_trace(pfScTrace, sgnWriteEnable, "WE");
-
-	sc_trace(pfScTrace, sgnDimmEnable, "DE");
-	sc_trace(pfScTrace, sgnBiuBusy, "RB");
-	sc_trace(pfScTrace, sgnAddrOut, "AO");
-	sc_trace(pfScTrace, sgnWriteOut, "WO");
-	sc_trace(pfScTrace, sgnCompAck, "CA");
-
-	//
-	// make connection of data port between memory and stimulus
-	//
-	for(int nBuffIdx = 0; nBuffIdx < 4; nBuffIdx++)
-	{
-		stringstream strStreamName;
-
-		memSystemSc._prtDOUT[nBuffIdx](sgnDataMemOut[nBuffIdx]);
-		stimulus._prtDataIn[nBuffIdx](sgnDataMemOut[nBuffIdx]);
-		
-		strStreamName << "DOUT(" << nBuffIdx << ")";
-		sc_trace(pfScTrace, sgnDataMemOut[nBuffIdx], strStreamName.str());
-		
-		memSystemSc._prtDIN[nBuffIdx](sgnDataMemIn[nBuffIdx]);
-		stimulus._prtDataOut[nBuffIdx](sgnDataMemIn[nBuffIdx]);
-		
-		strStreamName.str("");
-		strStreamName << "DIN(" << nBuffIdx << ")";
-		sc_trace(pfScTrace, sgnDataMemIn[nBuffIdx], strStreamName.str());
-		
-	}
-
-
-#if (USE_CALIBRATION_1CYCLE != 1)
-	//
-	// Since System C interface for DRAMSim works on double data rate, calibration for ignoring the end of cycle is needed
-	//
-	sc_start(numCycles, SC_NS);
-#else
-	sc_start(numCycles+1, SC_NS);
-#endif
-
-#else
+	//parsing, merging and address alignment run on their own thread from here on
+	TraceReader *traceReader = sources.size() == 1 ? sources[0] : new MergedTraceReader(sources);
+	traceReader = new PipelinedTraceReader(traceReader, transactionAlignmentBits());
 
 	for (size_t i=0;i<numCycles;i++)
 	{
 		if (!pendingTrans)
 		{
-			if (!traceFile.eof())
+			if (!traceDone)
 			{
-				getline(traceFile, line);
-
-				if (line.size() > 0)
+				if (traceReader->next(record))
 				{
-					data = parseTraceFileLine(line, addr, transType,clockCycle, traceType);
-					trans = Transaction(transType, addr, data);
-					alignTransactionAddress(trans); 
+					if (useClockCycle)
+					{
+						clockCycle = record.cycle;
+					}
+					trans = Transaction(record.type, record.address, record.data, record.lineNumber);
+					trans.sourceID = record.sourceID;
 
 					if (i>=clockCycle)
 					{
@@ -709,14 +405,10 @@ int main(int argc, char **argv)
 				}
 				else
 				{
-					DEBUG("WARNING: Skipping line "<<lineNumber<< " ('" << line << "') in tracefile");
+					//we're out of trace, set pending=false and let the thing spin without adding transactions
+					traceDone = true;
+					pendingTrans = false; 
 				}
-				lineNumber++;
-			}
-			else
-			{
-				//we're out of trace, set pending=false and let the thing spin without adding transactions
-				pendingTrans = false; 
 			}
 		}
 
@@ -733,11 +425,9 @@ int main(int argc, char **argv)
 
 		(*memorySystem).update();
 	}
-#endif
 
-	traceFile.close();
+	delete(traceReader);
 	(*memorySystem).printStats(true);
-	ExampleforDisplayingStatistics(memSystemSc);
 
 
 	// make valgrind happy
@@ -0,0 +1,325 @@
+/****************************************************************************
+*	 DRAMSim2: A Cycle Accurate DRAM simulator 
+*	 
+*	 Copyright (C) 2010   	Elliott Cooper-Balis
+*									Paul Rosenfeld 
+*									Bruce Jacob
+*									University of Maryland
+*
+*	 SCIC: A System C Interface Converter for DRAMSim
+*	 
+*	 Copyright (C) 2011  	Myoungsoo Jung
+*									Pennsylvania State University
+*							David Donofrio
+*							John Shalf
+*									Lawrence Berkeley National Lab.
+*
+*	 This program is free software: you can redistribute it and/or modify
+*	 it under the terms of the GNU General Public License as published by
+*	 the Free Software Foundation, either version 3 of the License, or
+*	 (at your option) any later version.
+*
+*	 This program is distributed in the hope that it will be useful,
+*	 but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	 MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	 GNU General Public License for more details.
+*
+*	 You should have received a copy of the GNU General Public License
+*	 along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*****************************************************************************/
+
+//TraceBasedSimSC.cpp
+//
+//SystemC front end for a trace-based simulation: the Stimulus module replays
+//the trace through SCIC, which adapts the SystemC ports to the core library
+//
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <getopt.h>
+
+#include "SystemConfiguration.h"
+#include "MemorySystem.h"
+#include "Transaction.h"
+#include "TraceReader.h"
+
+#include "systemc.h"
+#include "SCIC.h"
+#include "Stimulus.h"
+
+using namespace DRAMSim;
+using namespace std;
+
+void usage()
+{
+	cout << "DRAMSim2 (SystemC) Usage: " << endl;
+	cout << "DRAMSim_sc -t tracefile -s system.ini -d ini/device.ini [-c #] [-p pwd] -q" <<endl;
+	cout << "\t-t, --tracefile=FILENAME \tspecify a tracefile to run  "<<endl;
+	cout << "\t-s, --systemini=FILENAME \tspecify an ini file that describes the memory system parameters  "<<endl;
+	cout << "\t-d, --deviceini=FILENAME \tspecify an ini file that describes the device-level parameters"<<endl;
+	cout << "\t-c, --numcycles=# \t\tspecify number of cycles to run the simulation for [default=30] "<<endl;
+	cout << "\t-q, --quiet \t\t\tflag to suppress simulation output (except final stats) [default=no]"<<endl;
+	cout << "\t-p, --pwd=DIRECTORY\t\tSet the working directory (i.e. usually DRAMSim directory where ini/ and results/ are)"<<endl;
+	cout << "\t-S, --size=# \t\t\tSize of the memory system in megabytes"<<endl;
+	cout << "\t-a, --async=# \t\t\tRun the memory system on its own thread, delivering completions # cycles late (0 = RL+tCMD)"<<endl;
+}
+
+void ExampleforDisplayingStatistics( SCIC &memSystemSc ) 
+{
+
+	//
+	// test for displaying performance
+	// In practice, you don't need buch of these vector to query memory system information.
+	// It is just for test (comparison to original statistics)
+	//
+
+	// energy test
+	vector<double> energyInfos[SCIC_NUMS_ENERGY_TYPE];
+	for(int nQueryType = 0; nQueryType < SCIC_NUMS_ENERGY_TYPE; nQueryType++)
+	{
+		energyInfos[nQueryType] = vector<double>(NUM_RANKS,0.0);
+		memSystemSc.GetElapsedEnergyInfo(energyInfos[nQueryType], (SCIC_ENERGY_QUERY)nQueryType);
+	}
+	vector<double> averageEnergyInfo					= vector<double>(NUM_RANKS,0.0);
+	memSystemSc.GetElapsedEnergyInfo(averageEnergyInfo, SCIC_ENERGY_AVERAGE);
+
+	// performance test
+	vector<double> latencyInfo						= vector<double>(NUM_RANKS*NUM_BANKS,0.0);
+	vector<double> bandwidthInfo					= vector<double>(NUM_RANKS*NUM_BANKS,0.0);
+
+	// statistics test
+	vector<uint64_t> numsRead						= vector<uint64_t>(NUM_RANKS*NUM_BANKS,0.0);
+	vector<uint64_t> numsWrite						= vector<uint64_t>(NUM_RANKS*NUM_BANKS,0.0);
+
+
+	PRINT( " =====================SCIC==============================" );
+
+	PRINTN( "   Total Return Transactions : " << memSystemSc.GetTotalNumsTransactions() );
+	PRINT( " ("<<memSystemSc.GetTotalNumsTransactions() * memSystemSc.GetBytePerTransaction() <<" bytes) aggregate average bandwidth "<<memSystemSc.GetElapsedPerfromanceInfo(bandwidthInfo, SCIC_PERF_BANDWIDTH)<<"GB/s");
+
+
+	cout << "Total write requests : " << memSystemSc.GetNumsElapsedIo(numsWrite, SCIC_STAT_WRITE)  << endl;
+	cout << "Total read requests : " << memSystemSc.GetNumsElapsedIo(numsRead, SCIC_STAT_READ)  << endl;
+
+	memSystemSc.GetElapsedPerfromanceInfo(latencyInfo, SCIC_PERF_LATENCY);
+	for (size_t i=0;i<NUM_RANKS;i++)
+	{
+
+		PRINT( "      -Rank   "<<i<<" : ");
+		PRINTN( "        -Reads  : " << numsRead[i]);
+		PRINT( " ("<<numsRead[i] * memSystemSc.GetBytePerTransaction()<<" bytes)");
+		PRINTN( "        -Writes : " << numsWrite[i]);
+		PRINT( " ("<<numsWrite[i] * memSystemSc.GetBytePerTransaction()<<" bytes)");
+
+		for (size_t j=0;j<NUM_BANKS;j++)
+		{
+			PRINT( "        -Bandwidth / Latency  (Bank " <<j<<"): " <<bandwidthInfo[SEQUENTIAL(i,j)] << " GB/s\t\t" <<latencyInfo[SEQUENTIAL(i,j)] << " ns");
+		}
+
+		PRINT( " == Power Data for Rank        " << i );
+		PRINT( "   Average Power (watts)     : " << averageEnergyInfo[i] );
+		PRINT( "     -Background (watts)     : " << energyInfos[SCIC_ENERGY_BACKGROUND][i] );
+		PRINT( "     -Act/Pre    (watts)     : " << energyInfos[SCIC_ENERGY_PRECHARGE][i] );
+		PRINT( "     -Burst      (watts)     : " << energyInfos[SCIC_ENERGY_BURST][i]);
+		PRINT( "     -Refresh    (watts)     : " << energyInfos[SCIC_ENERGY_REFRESH][i] );
+
+
+	}
+}
+
+int main(int argc, char **argv)
+{
+	int c;
+	string traceFileName = "";
+	string systemIniFilename = "system.ini";
+	string deviceIniFilename = "";
+	string pwdString = "";
+	unsigned megsOfMemory=2048;
+	int asyncLag=-1;
+
+	uint numCycles=1000;
+	//getopt stuff
+	while (1)
+	{
+		static struct option long_options[] =
+		{
+			{"deviceini", required_argument, 0, 'd'},
+			{"tracefile", required_argument, 0, 't'},
+			{"systemini", required_argument, 0, 's'},
+			{"pwd", required_argument, 0, 'p'},
+			{"numcycles",  required_argument,	0, 'c'},
+			{"quiet",  no_argument, &SHOW_SIM_OUTPUT, 'q'},
+			{"help", no_argument, 0, 'h'},
+			{"size", required_argument, 0, 'S'},
+			{"async", required_argument, 0, 'a'},
+			{0, 0	, 0, 0}
+		};
+		int option_index=0; //for getopt
+		c = getopt_long (argc, argv, "t:s:c:d:p:S:qa:", long_options, &option_index);
+		if (c == -1)
+		{
+			break;
+		}
+		switch (c)
+		{
+		case 'h':
+			usage();
+			exit(0);
+			break;
+		case 't':
+			traceFileName = string(optarg);
+			break;
+		case 's':
+			systemIniFilename = string(optarg);
+			break;
+		case 'd':
+			deviceIniFilename = string(optarg);
+			break;
+		case 'c':
+			numCycles = atoi(optarg);
+			break;
+		case 'S':
+			megsOfMemory=atoi(optarg);
+			break;
+		case 'p':
+			pwdString = string(optarg);
+			break;
+		case 'q':
+			SHOW_SIM_OUTPUT=false;
+			break;
+		case 'a':
+			asyncLag=atoi(optarg);
+			break;
+		case '?':
+			usage();
+			exit(-1);
+			break;
+		}
+	}
+
+	if (deviceIniFilename.length() == 0)
+	{
+		ERROR("Please provide a device ini file");
+		usage();
+		exit(-1);
+	}
+
+	//ignore the pwd argument if the argument is an absolute path
+	if (pwdString.length() > 0 && traceFileName[0] != '/')
+	{
+		traceFileName = pwdString + "/" +traceFileName;
+	}
+
+	DEBUG("== Loading trace file '"<<traceFileName<<"' == ");
+
+	TraceReader *traceReader = TraceReader::open(traceFileName);
+	MemorySystem *memorySystem = new MemorySystem(0, deviceIniFilename, systemIniFilename, pwdString, traceFileName, megsOfMemory);
+
+	sc_set_time_resolution(1, SC_NS);
+	sc_set_default_time_unit(1, SC_NS);
+	sc_clock				sysClk("clock", 2, SC_NS, 0.5, 0, SC_NS, true);
+	sc_signal<uint64_t>		sgnDestAddr;
+	sc_signal<uint64_t>		sgnBuffAddr;
+	sc_signal<bool>			sgnWriteEnable;
+
+	sc_signal<bool>			sgnDimmEnable;
+	sc_signal<bool>			sgnBiuBusy;
+	sc_signal<uint64_t>		sgnAddrOut;
+	sc_signal<bool>			sgnWriteOut;
+	sc_signal<bool>			sgnCompAck;
+
+
+	sc_signal<uint64_t>		sgnDataMemIn[4];
+	sc_signal<uint64_t>		sgnDataMemOut[4];
+
+	//
+	// make connection between system c interface and memory system
+	//
+	SCIC memSystemSc("SC_MemorySystem");
+	memSystemSc.AttachLegacyMemorySystem(memorySystem);
+	if (asyncLag >= 0)
+	{
+		memSystemSc.EnableAsyncMode(asyncLag);
+	}
+	memSystemSc._prtCLK(sysClk.signal());
+
+	memSystemSc._prtDA(sgnDestAddr);
+	memSystemSc._prtWE(sgnWriteEnable);
+
+	memSystemSc._prtDE(sgnDimmEnable);
+	memSystemSc._prtRB(sgnBiuBusy);
+	memSystemSc._prtAO(sgnAddrOut);
+	memSystemSc._prtWO(sgnWriteOut);
+	memSystemSc._prtCA(sgnCompAck);
+
+	//
+	// Initializing Stimulus
+	//
+	Stimulus stimulus("Stimulus");
+	stimulus.AttachTraceReader(traceReader);
+	stimulus._prtAO(sgnDestAddr);
+	stimulus._prtRB(sgnBiuBusy);
+	stimulus._prtCLK(sysClk.signal());
+	stimulus._prtDE(sgnDimmEnable);
+	stimulus._prtWE(sgnWriteEnable);
+	stimulus._prtCA(sgnCompAck);
+	stimulus._prtAI(sgnAddrOut);
+	stimulus._prtWI(sgnWriteOut);
+
+	//
+	// System C trace
+	//
+	sc_trace_file *pfScTrace = sc_create_vcd_trace_file("wave");
+	sc_trace(pfScTrace, sysClk, "CLK");
+	sc_trace(pfScTrace, sgnDestAddr, "DA");
+	sc_trace(pfScTrace, sgnBuffAddr, "buffAddr");
+	sc_trace(pfScTrace, sgnWriteEnable, "WE");
+
+	sc_trace(pfScTrace, sgnDimmEnable, "DE");
+	sc_trace(pfScTrace, sgnBiuBusy, "RB");
+	sc_trace(pfScTrace, sgnAddrOut, "AO");
+	sc_trace(pfScTrace, sgnWriteOut, "WO");
+	sc_trace(pfScTrace, sgnCompAck, "CA");
+
+	//
+	// make connection of data port between memory and stimulus
+	//
+	for(int nBuffIdx = 0; nBuffIdx < 4; nBuffIdx++)
+	{
+		stringstream strStreamName;
+
+		memSystemSc._prtDOUT[nBuffIdx](sgnDataMemOut[nBuffIdx]);
+		stimulus._prtDataIn[nBuffIdx](sgnDataMemOut[nBuffIdx]);
+		
+		strStreamName << "DOUT(" << nBuffIdx << ")";
+		sc_trace(pfScTrace, sgnDataMemOut[nBuffIdx], strStreamName.str());
+		
+		memSystemSc._prtDIN[nBuffIdx](sgnDataMemIn[nBuffIdx]);
+		stimulus._prtDataOut[nBuffIdx](sgnDataMemIn[nBuffIdx]);
+		
+		strStreamName.str("");
+		strStreamName << "DIN(" << nBuffIdx << ")";
+		sc_trace(pfScTrace, sgnDataMemIn[nBuffIdx], strStreamName.str());
+		
+	}
+
+
+#if (USE_CALIBRATION_1CYCLE != 1)
+	//
+	// Since System C interface for DRAMSim works on double data rate, calibration for ignoring the end of cycle is needed
+	//
+	sc_start(numCycles, SC_NS);
+#else
+	sc_start(numCycles+1, SC_NS);
+#endif
+
+	memSystemSc.StopAsyncMode();
+	delete(traceReader);
+	(*memorySystem).printStats(true);
+	ExampleforDisplayingStatistics(memSystemSc);
+
+	// make valgrind happy
+	delete(memorySystem);
+}
@@ -0,0 +1,130 @@
+/****************************************************************************
+*	 DRAMSim2: A Cycle Accurate DRAM simulator 
+*	 
+*	 Copyright (C) 2010   	Elliott Cooper-Balis
+*									Paul Rosenfeld 
+*									Bruce Jacob
+*									University of Maryland
+*
+*	 This program is free software: you can redistribute it and/or modify
+*	 it under the terms of the GNU General Public License as published by
+*	 the Free Software Foundation, either version 3 of the License, or
+*	 (at your option) any later version.
+*
+*	 This program is distributed in the hope that it will be useful,
+*	 but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	 MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	 GNU General Public License for more details.
+*
+*	 You should have received a copy of the GNU General Public License
+*	 along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*****************************************************************************/
+
+//TraceConvert.cpp
+//
+//Converts a k6, mase or misc text trace (plain or compressed) into the
+//binary trace format (see BinaryTrace.h). The type of the input trace is
+//taken from its filename prefix, as in the simulator. With -z it instead
+//compresses the input with the bundled LZ codec (see LZCodec.h).
+//
+
+#include <iostream>
+#include <cstring>
+#include <vector>
+
+#include "SystemConfiguration.h"
+#include "BinaryTrace.h"
+#include "LZCodec.h"
+
+using namespace DRAMSim;
+using namespace std;
+
+void usage()
+{
+	cout << "dramsim-traceconv Usage: " << endl;
+	cout << "dramsim-traceconv input.trc output.btr" << endl;
+	cout << "dramsim-traceconv -z input.trc output.trc.lz" << endl;
+	cout << "\tThe input must be a k6, mase or misc text trace, optionally gzip or LZ compressed;" << endl;
+	cout << "\twrite data in misc traces is kept. -z compresses the input with the bundled LZ codec." << endl;
+}
+
+void compressFile(const string &inputFilename, const string &outputFilename)
+{
+	FILE *in = fopen(inputFilename.c_str(), "rb");
+	if (in == NULL)
+	{
+		ERROR("== Error - Could not open input file '"<<inputFilename<<"'");
+		exit(-1);
+	}
+	FILE *out = fopen(outputFilename.c_str(), "wb");
+	if (out == NULL)
+	{
+		ERROR("== Error - Could not open output file '"<<outputFilename<<"'");
+		exit(-1);
+	}
+
+	vector<uint8_t> raw(LZ_BLOCK_SIZE);
+	vector<uint8_t> compressed(lzCompressBound(LZ_BLOCK_SIZE));
+	uint64_t rawTotal = 0, compressedTotal = 0;
+
+	fwrite(LZ_STREAM_MAGIC, 1, strlen(LZ_STREAM_MAGIC), out);
+	size_t n;
+	while ((n = fread(&raw[0], 1, LZ_BLOCK_SIZE, in)) > 0)
+	{
+		uint32_t sizes[2];	// uncompressed, compressed
+		sizes[0] = n;
+		sizes[1] = lzCompress(&raw[0], n, &compressed[0]);
+		fwrite(sizes, sizeof(uint32_t), 2, out);
+		fwrite(&compressed[0], 1, sizes[1], out);
+		rawTotal += sizes[0];
+		compressedTotal += sizes[1] + sizeof(sizes);
+	}
+	fclose(in);
+	if (fclose(out) != 0)
+	{
+		ERROR("== Error - Could not write '"<<outputFilename<<"'");
+		exit(-1);
+	}
+	cout << "Compressed "<<rawTotal<<" bytes to "<<compressedTotal<<" bytes in '"<<outputFilename<<"'"<<endl;
+}
+
+int main(int argc, char **argv)
+{
+	if (argc == 4 && strcmp(argv[1], "-z") == 0)
+	{
+		compressFile(argv[2], argv[3]);
+		return 0;
+	}
+	if (argc != 3)
+	{
+		usage();
+		exit(-1);
+	}
+
+	//keep the misc parser's per-line chatter out of the way
+	SHOW_SIM_OUTPUT = 0;
+
+	string inputFilename = argv[1];
+	string outputFilename = argv[2];
+
+	if (BinaryTraceReader::isBinaryTrace(inputFilename))
+	{
+		ERROR("== '"<<inputFilename<<"' is already a binary trace");
+		exit(-1);
+	}
+
+	TraceReader *reader = TraceReader::open(inputFilename, true);
+	BinaryTraceWriter writer(outputFilename, reader->sourceFormat());
+	TraceRecord record;
+	while (reader->next(record))
+	{
+		writer.write(record);
+		free(record.data);
+	}
+	writer.close();
+	delete reader;
+
+	cout << "Wrote "<<writer.records()<<" records to '"<<outputFilename<<"'"<<endl;
+	return 0;
+}
@@ -0,0 +1,131 @@
+/****************************************************************************
+*	 DRAMSim2: A Cycle Accurate DRAM simulator 
+*	 
+*	 Copyright (C) 2010   	Elliott Cooper-Balis
+*									Paul Rosenfeld 
+*									Bruce Jacob
+*									University of Maryland
+*
+*	 This program is free software: you can redistribute it and/or modify
+*	 it under the terms of the GNU General Public License as published by
+*	 the Free Software Foundation, either version 3 of the License, or
+*	 (at your option) any later version.
+*
+*	 This program is distributed in the hope that it will be useful,
+*	 but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	 MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	 GNU General Public License for more details.
+*
+*	 You should have received a copy of the GNU General Public License
+*	 along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*****************************************************************************/
+
+
+
+//TracePipeline.cpp
+//
+//Class file for the pipelined trace reader
+//
+
+#include "TracePipeline.h"
+#include <sched.h>
+
+using namespace DRAMSim;
+using namespace std;
+
+PipelinedTraceReader::PipelinedTraceReader(TraceReader *source, unsigned alignBits, unsigned depth) :
+		source(source),
+		addressMask(~((1ULL << alignBits) - 1)),
+		ring(depth),
+		producerSleeping(false),
+		sourceDone(false),
+		stopRequested(false)
+{
+	pthread_mutex_init(&lock, NULL);
+	pthread_cond_init(&drained, NULL);
+	if (pthread_create(&thread, NULL, threadMain, this) != 0)
+	{
+		ERROR("== Error - could not start the trace pipeline thread");
+		exit(-1);
+	}
+}
+
+PipelinedTraceReader::~PipelinedTraceReader()
+{
+	pthread_mutex_lock(&lock);
+	__atomic_store_n(&stopRequested, true, __ATOMIC_SEQ_CST);
+	pthread_cond_signal(&drained);
+	pthread_mutex_unlock(&lock);
+	pthread_join(thread, NULL);
+
+	//free the data of records nobody consumed
+	TraceRecord record;
+	while (ring.pop(record))
+	{
+		free(record.data);
+	}
+
+	pthread_cond_destroy(&drained);
+	pthread_mutex_destroy(&lock);
+	delete source;
+}
+
+void *PipelinedTraceReader::threadMain(void *arg)
+{
+	((PipelinedTraceReader *)arg)->run();
+	return NULL;
+}
+
+void PipelinedTraceReader::run()
+{
+	TraceRecord record;
+	while (source->next(record))
+	{
+		record.address &= addressMask;
+		while (!ring.push(record))
+		{
+			pthread_mutex_lock(&lock);
+			__atomic_store_n(&producerSleeping, true, __ATOMIC_SEQ_CST);
+			__atomic_thread_fence(__ATOMIC_SEQ_CST);
+			while (ring.count() > ring.capacity() / 2 && !__atomic_load_n(&stopRequested, __ATOMIC_SEQ_CST))
+			{
+				pthread_cond_wait(&drained, &lock);
+			}
+			__atomic_store_n(&producerSleeping, false, __ATOMIC_SEQ_CST);
+			bool stop = stopRequested;
+			pthread_mutex_unlock(&lock);
+			if (stop)
+			{
+				free(record.data);
+				return;
+			}
+		}
+	}
+	__atomic_store_n(&sourceDone, true, __ATOMIC_RELEASE);
+}
+
+bool PipelinedTraceReader::next(TraceRecord &record)
+{
+	while (!ring.pop(record))
+	{
+		//the ring has to be checked again after seeing sourceDone, the
+		//producer may have pushed its last records in between
+		if (__atomic_load_n(&sourceDone, __ATOMIC_ACQUIRE))
+		{
+			return ring.pop(record);
+		}
+		sched_yield();
+	}
+
+	//pairs with the store in run(): either the producer sees the ring
+	//drained or we see it sleeping
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&producerSleeping, __ATOMIC_RELAXED) && ring.count() <= ring.capacity() / 2)
+	{
+		pthread_mutex_lock(&lock);
+		pthread_cond_signal(&drained);
+		pthread_mutex_unlock(&lock);
+	}
+	return true;
+}
@@ -0,0 +1,72 @@
+/****************************************************************************
+*	 DRAMSim2: A Cycle Accurate DRAM simulator 
+*	 
+*	 Copyright (C) 2010   	Elliott Cooper-Balis
+*									Paul Rosenfeld 
+*									Bruce Jacob
+*									University of Maryland
+*
+*	 This program is free software: you can redistribute it and/or modify
+*	 it under the terms of the GNU General Public License as published by
+*	 the Free Software Foundation, either version 3 of the License, or
+*	 (at your option) any later version.
+*
+*	 This program is distributed in the hope that it will be useful,
+*	 but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	 MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	 GNU General Public License for more details.
+*
+*	 You should have received a copy of the GNU General Public License
+*	 along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*****************************************************************************/
+#ifndef TRACEPIPELINE_H
+#define TRACEPIPELINE_H
+
+//TracePipeline.h
+//
+//Moves trace parsing off the simulation thread. A producer thread pulls
+//records from another TraceReader, aligns their addresses and pushes them
+//into a single-producer single-consumer ring; next() on the simulation
+//thread only pops ready records. Records come out in trace order with their
+//cycle stamps untouched, so a simulation gives the same results as reading
+//the trace directly.
+//
+
+#include "TraceReader.h"
+#include "LockFreeRing.h"
+#include <pthread.h>
+
+#define TRACE_PIPELINE_DEPTH 4096
+
+namespace DRAMSim
+{
+class PipelinedTraceReader : public TraceReader
+{
+public:
+	//takes ownership of source; the low alignBits bits of every address are cleared
+	PipelinedTraceReader(TraceReader *source, unsigned alignBits, unsigned depth = TRACE_PIPELINE_DEPTH);
+	virtual ~PipelinedTraceReader();
+	virtual bool next(TraceRecord &record);
+	virtual TraceType sourceFormat() const { return source->sourceFormat(); }
+
+private:
+	static void *threadMain(void *arg);
+	void run();
+
+	TraceReader *source;
+	uint64_t addressMask;
+	SPSCRing<TraceRecord> ring;
+	pthread_t thread;
+
+	//the producer sleeps while the ring is full and is woken once the
+	//consumer has drained it to half
+	pthread_mutex_t lock;
+	pthread_cond_t drained;
+	bool producerSleeping;
+	bool sourceDone;
+	bool stopRequested;
+};
+}
+
+#endif
@@ -0,0 +1,343 @@
+/****************************************************************************
+*	 DRAMSim2: A Cycle Accurate DRAM simulator 
+*	 
+*	 Copyright (C) 2010   	Elliott Cooper-Balis
+*									Paul Rosenfeld 
+*									Bruce Jacob
+*									University of Maryland
+*
+*	 This program is free software: you can redistribute it and/or modify
+*	 it under the terms of the GNU General Public License as published by
+*	 the Free Software Foundation, either version 3 of the License, or
+*	 (at your option) any later version.
+*
+*	 This program is distributed in the hope that it will be useful,
+*	 but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	 MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	 GNU General Public License for more details.
+*
+*	 You should have received a copy of the GNU General Public License
+*	 along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*****************************************************************************/
+
+
+
+//TraceReader.cpp
+//
+//Class file for the trace readers
+//
+
+#include "TraceReader.h"
+#include "BinaryTrace.h"
+#include "CompressedTrace.h"
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace DRAMSim;
+using namespace std;
+
+namespace
+{
+//maps a character to its hex digit value, or -1
+struct HexTable
+{
+	signed char value[256];
+	HexTable()
+	{
+		memset(value, -1, sizeof(value));
+		for (int i=0;i<10;i++)
+		{
+			value['0'+i] = i;
+		}
+		for (int i=0;i<6;i++)
+		{
+			value['a'+i] = 10+i;
+			value['A'+i] = 10+i;
+		}
+	}
+};
+const HexTable hexTable;
+
+//parses hex digits until the first non-hex character or maxDigits digits
+inline uint64_t parseHex(const char *&p, const char *end, unsigned maxDigits = 16)
+{
+	uint64_t v = 0;
+	int d;
+	while (p < end && maxDigits > 0 && (d = hexTable.value[(unsigned char)*p]) >= 0)
+	{
+		v = (v << 4) | (unsigned)d;
+		p++;
+		maxDigits--;
+	}
+	return v;
+}
+
+inline uint64_t parseDecimal(const char *&p, const char *end)
+{
+	uint64_t v = 0;
+	while (p < end && *p >= '0' && *p <= '9')
+	{
+		v = v*10 + (unsigned)(*p - '0');
+		p++;
+	}
+	return v;
+}
+
+inline const char *skipSpaces(const char *p, const char *end)
+{
+	while (p < end && *p == ' ')
+	{
+		p++;
+	}
+	return p;
+}
+
+inline const char *findSpace(const char *p, const char *end)
+{
+	const char *s = (const char *)memchr(p, ' ', end - p);
+	return s == NULL ? end : s;
+}
+
+inline bool tokenIs(const char *begin, const char *end, const char *word)
+{
+	size_t len = strlen(word);
+	return (size_t)(end - begin) == len && memcmp(begin, word, len) == 0;
+}
+
+//the address field is written as 0x....
+inline uint64_t parseAddress(const char *begin, const char *end)
+{
+	const char *p = begin + 2;
+	return p < end ? parseHex(p, end) : 0;
+}
+}
+
+bool DRAMSim::parseTraceLine(const char *line, const char *lineEnd, TraceType type, TraceRecord &record, bool withData)
+{
+	if (lineEnd > line && lineEnd[-1] == '\r')
+	{
+		lineEnd--;
+	}
+	if (line == lineEnd)
+	{
+		return false;
+	}
+
+	record.cycle = 0;
+	record.data = NULL;
+	record.sourceID = 0;
+
+	const char *addrEnd = findSpace(line, lineEnd);
+	record.address = parseAddress(line, addrEnd);
+
+	const char *cmd = skipSpaces(addrEnd, lineEnd);
+	const char *cmdEnd = findSpace(cmd, lineEnd);
+
+	switch (type)
+	{
+	case k6:
+	case mase:
+	{
+		if (type == k6)
+		{
+			if (tokenIs(cmd, cmdEnd, "P_MEM_WR") || tokenIs(cmd, cmdEnd, "BOFF"))
+			{
+				record.type = DATA_WRITE;
+			}
+			else if (tokenIs(cmd, cmdEnd, "P_FETCH") || tokenIs(cmd, cmdEnd, "P_MEM_RD") ||
+			         tokenIs(cmd, cmdEnd, "P_LOCK_RD") || tokenIs(cmd, cmdEnd, "P_LOCK_WR"))
+			{
+				record.type = DATA_READ;
+			}
+			else
+			{
+				ERROR("== Unknown Command : "<<string(cmd, cmdEnd));
+				exit(0);
+			}
+		}
+		else
+		{
+			if (tokenIs(cmd, cmdEnd, "IFETCH") || tokenIs(cmd, cmdEnd, "READ"))
+			{
+				record.type = DATA_READ;
+			}
+			else if (tokenIs(cmd, cmdEnd, "WRITE"))
+			{
+				record.type = DATA_WRITE;
+			}
+			else
+			{
+				ERROR("== Unknown command in tracefile : "<<string(cmd, cmdEnd));
+				exit(0);
+			}
+		}
+
+		const char *cc = skipSpaces(cmdEnd, lineEnd);
+		record.cycle = parseDecimal(cc, lineEnd);
+		break;
+	}
+	case misc:
+	{
+		if (addrEnd == lineEnd)
+		{
+			ERROR("Malformed line: '"<< string(line, lineEnd) <<"'");
+		}
+
+		//misc lines are separated by exactly one space
+		cmd = addrEnd < lineEnd ? addrEnd + 1 : lineEnd;
+		cmdEnd = findSpace(cmd, lineEnd);
+
+		if (tokenIs(cmd, cmdEnd, "read"))
+		{
+			record.type = DATA_READ;
+		}
+		else if (tokenIs(cmd, cmdEnd, "write"))
+		{
+			record.type = DATA_WRITE;
+		}
+		else
+		{
+			ERROR("INVALID COMMAND '"<<string(cmd, cmdEnd)<<"'");
+			exit(-1);
+		}
+
+		//unless the caller keeps write data (not in a no storage build), don't allocate space, just return NULL
+		const char *dataStr = cmdEnd < lineEnd ? cmdEnd + 1 : lineEnd;
+		if (withData && dataStr < lineEnd && record.type == DATA_WRITE)
+		{
+			// 32 bytes of data per transaction, 16 hex digits per word
+			uint64_t *dataBuffer = (uint64_t *)calloc(sizeof(uint64_t),4);
+			for (int i=0; i < 4 && dataStr + i*16 < lineEnd; i++)
+			{
+				const char *p = dataStr + i*16;
+				dataBuffer[i] = parseHex(p, lineEnd);
+			}
+			record.data = dataBuffer;
+		}
+		break;
+	}
+	}
+	return true;
+}
+
+bool TraceReader::typeFromFilename(const string &filename, TraceType &type)
+{
+	string prefix = filename.substr(filename.find_last_of("/")+1);
+	prefix = prefix.substr(0,prefix.find_first_of("_"));
+	if (prefix=="mase")
+	{
+		type = mase;
+	}
+	else if (prefix=="k6")
+	{
+		type = k6;
+	}
+	else if (prefix=="misc")
+	{
+		type = misc;
+	}
+	else
+	{
+		return false;
+	}
+	return true;
+}
+
+TraceReader *TraceReader::open(const string &filename, bool withData)
+{
+	if (BinaryTraceReader::isBinaryTrace(filename))
+	{
+		return new BinaryTraceReader(filename, withData);
+	}
+
+	TraceType type;
+	if (!typeFromFilename(filename, type))
+	{
+		ERROR("== Unknown Tracefile Type : "<<filename);
+		exit(0);
+	}
+
+	TraceCodec codec;
+	if (CompressedTraceReader::isCompressedTrace(filename, codec))
+	{
+		return new CompressedTraceReader(filename, codec, type, withData);
+	}
+	return new TextTraceReader(filename, type, withData);
+}
+
+TextTraceReader::TextTraceReader(const string &filename, TraceType type, bool withData) :
+		traceType(type),
+		base(NULL),
+		cursor(NULL),
+		end(NULL),
+		mappedLength(0),
+		lineNumber(0),
+		withData(withData)
+{
+	int fd = ::open(filename.c_str(), O_RDONLY);
+	if (fd < 0)
+	{
+		ERROR("== Error - Could not open trace file '"<<filename<<"'");
+		exit(0);
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0)
+	{
+		ERROR("== Error - Could not stat trace file '"<<filename<<"'");
+		exit(0);
+	}
+
+	mappedLength = st.st_size;
+	if (mappedLength > 0)
+	{
+		void *m = mmap(NULL, mappedLength, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (m == MAP_FAILED)
+		{
+			ERROR("== Error - Could not map trace file '"<<filename<<"'");
+			exit(0);
+		}
+		madvise(m, mappedLength, MADV_SEQUENTIAL);
+		base = (const char *)m;
+	}
+	::close(fd);
+
+	cursor = base;
+	end = base + mappedLength;
+}
+
+TextTraceReader::~TextTraceReader()
+{
+	if (base != NULL)
+	{
+		munmap((void *)base, mappedLength);
+	}
+}
+
+bool TextTraceReader::next(TraceRecord &record)
+{
+	while (cursor < end)
+	{
+		const char *lineEnd = (const char *)memchr(cursor, '\n', end - cursor);
+		if (lineEnd == NULL)
+		{
+			lineEnd = end;
+		}
+
+		const char *line = cursor;
+		cursor = lineEnd < end ? lineEnd + 1 : end;
+
+		bool parsed = parseTraceLine(line, lineEnd, traceType, record, withData);
+		record.lineNumber = lineNumber++;
+		if (parsed)
+		{
+			return true;
+		}
+		DEBUG("WARNING: Skipping line "<<record.lineNumber<< " in tracefile");
+	}
+	return false;
+}
@@ -0,0 +1,104 @@
+/****************************************************************************
+*	 DRAMSim2: A Cycle Accurate DRAM simulator 
+*	 
+*	 Copyright (C) 2010   	Elliott Cooper-Balis
+*									Paul Rosenfeld 
+*									Bruce Jacob
+*									University of Maryland
+*
+*	 This program is free software: you can redistribute it and/or modify
+*	 it under the terms of the GNU General Public License as published by
+*	 the Free Software Foundation, either version 3 of the License, or
+*	 (at your option) any later version.
+*
+*	 This program is distributed in the hope that it will be useful,
+*	 but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	 MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	 GNU General Public License for more details.
+*
+*	 You should have received a copy of the GNU General Public License
+*	 along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*****************************************************************************/
+#ifndef TRACEREADER_H
+#define TRACEREADER_H
+
+//TraceReader.h
+//
+//Reads k6, mase and misc trace files into compact request records. The
+//file is mapped into memory and every line is parsed in place, without
+//copying it into strings or streams. Binary traces (BinaryTrace.h) are
+//read through the same interface.
+//
+
+#include "SystemConfiguration.h"
+#include "Transaction.h"
+
+namespace DRAMSim
+{
+
+//one request read from a trace
+//write data is only kept when the simulator stores data
+#ifdef NO_STORAGE
+#define TRACE_KEEP_DATA false
+#else
+#define TRACE_KEEP_DATA true
+#endif
+
+struct TraceRecord
+{
+	uint64_t cycle;			// clock cycle stamp (k6/mase only, 0 for misc)
+	uint64_t address;
+	uint64_t lineNumber;	// position in the trace, used as the transaction id
+	void *data;				// write data for misc traces (NULL unless the data is kept)
+	TransactionType type;
+	unsigned sourceID;		// core the request came from when several traces are mixed
+};
+
+class TraceReader
+{
+public:
+	//opens the trace with the reader that fits it: binary traces are
+	//recognized by their magic number, text traces by their filename
+	//prefix; gzip and LZ compressed text traces are streamed. Exits on failure
+	static TraceReader *open(const string &filename, bool withData = TRACE_KEEP_DATA);
+	//picks the trace type from the filename prefix (k6_, mase_ or misc_)
+	static bool typeFromFilename(const string &filename, TraceType &type);
+
+	virtual ~TraceReader() {}
+	//returns false once the trace is exhausted
+	virtual bool next(TraceRecord &record) = 0;
+	//the text format the trace is (or was converted from)
+	virtual TraceType sourceFormat() const = 0;
+
+protected:
+	TraceReader() {}
+};
+
+//memory mapped reader for the text formats
+class TextTraceReader : public TraceReader
+{
+public:
+	TextTraceReader(const string &filename, TraceType type, bool withData);
+	virtual ~TextTraceReader();
+	virtual bool next(TraceRecord &record);
+	virtual TraceType sourceFormat() const { return traceType; }
+
+private:
+	TraceType traceType;
+	const char *base;
+	const char *cursor;
+	const char *end;
+	size_t mappedLength;
+	uint64_t lineNumber;
+	bool withData;
+};
+
+//parses the line [line, lineEnd) (no line terminator) into record; returns
+//false for an empty line. Write data is only parsed if withData is set
+bool parseTraceLine(const char *line, const char *lineEnd, TraceType type, TraceRecord &record,
+                    bool withData = TRACE_KEEP_DATA);
+
+}
+
+#endif
@@ -0,0 +1,354 @@
+/****************************************************************************
+*	 DRAMSim2: A Cycle Accurate DRAM simulator 
+*	 
+*	 Copyright (C) 2010   	Elliott Cooper-Balis
+*									Paul Rosenfeld 
+*									Bruce Jacob
+*									University of Maryland
+*
+*	 This program is free software: you can redistribute it and/or modify
+*	 it under the terms of the GNU General Public License as published by
+*	 the Free Software Foundation, either version 3 of the License, or
+*	 (at your option) any later version.
+*
+*	 This program is distributed in the hope that it will be useful,
+*	 but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	 MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	 GNU General Public License for more details.
+*
+*	 You should have received a copy of the GNU General Public License
+*	 along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*****************************************************************************/
+
+
+
+//TrafficGenerator.cpp
+//
+//Class file for the synthetic traffic generators
+//
+
+#include "TrafficGenerator.h"
+#include <cstdlib>
+
+using namespace DRAMSim;
+using namespace std;
+
+TrafficGeneratorConfig::TrafficGeneratorConfig() :
+		pattern(TRAFFIC_UNIFORM),
+		seed(1),
+		rate(1.0),
+		maxOutstanding(32),
+		readFraction(1.0),
+		stride(4096),
+		rank(0),
+		bank(0)
+{
+}
+
+TrafficGeneratorConfig TrafficGenerator::parseSpec(const string &spec)
+{
+	TrafficGeneratorConfig config;
+	size_t start = 0;
+	bool first = true;
+	while (start <= spec.size())
+	{
+		size_t comma = spec.find(',', start);
+		if (comma == string::npos)
+		{
+			comma = spec.size();
+		}
+		string field = spec.substr(start, comma - start);
+		start = comma + 1;
+
+		if (first)
+		{
+			first = false;
+			if (field == "uniform")
+			{
+				config.pattern = TRAFFIC_UNIFORM;
+			}
+			else if (field == "stream")
+			{
+				config.pattern = TRAFFIC_STREAM;
+			}
+			else if (field == "stride")
+			{
+				config.pattern = TRAFFIC_STRIDE;
+			}
+			else if (field == "rowhostile")
+			{
+				config.pattern = TRAFFIC_ROW_HOSTILE;
+			}
+			else
+			{
+				ERROR("== Unknown traffic pattern '"<<field<<"' (uniform, stream, stride or rowhostile)");
+				exit(-1);
+			}
+			continue;
+		}
+
+		size_t equalsign = field.find('=');
+		if (equalsign == string::npos)
+		{
+			ERROR("== Malformed traffic generator option '"<<field<<"', expected key=value");
+			exit(-1);
+		}
+		string key = field.substr(0, equalsign);
+		const char *value = field.c_str() + equalsign + 1;
+
+		if (key == "seed")
+		{
+			config.seed = strtoull(value, NULL, 0);
+		}
+		else if (key == "rate")
+		{
+			config.rate = atof(value);
+		}
+		else if (key == "outstanding")
+		{
+			config.maxOutstanding = atoi(value);
+		}
+		else if (key == "reads")
+		{
+			config.readFraction = atof(value);
+		}
+		else if (key == "stride")
+		{
+			config.stride = strtoull(value, NULL, 0);
+		}
+		else if (key == "rank")
+		{
+			config.rank = atoi(value);
+		}
+		else if (key == "bank")
+		{
+			config.bank = atoi(value);
+		}
+		else
+		{
+			ERROR("== Unknown traffic generator option '"<<key<<"'");
+			exit(-1);
+		}
+	}
+
+	if (config.rate <= 0 || config.maxOutstanding == 0 || config.readFraction < 0 || config.readFraction > 1)
+	{
+		ERROR("== Traffic generator needs rate > 0, outstanding > 0 and 0 <= reads <= 1");
+		exit(-1);
+	}
+	return config;
+}
+
+TrafficGenerator::TrafficGenerator(MemorySystem *ms, const TrafficGeneratorConfig &config) :
+		memorySystem(ms),
+		config(config),
+		rngState(config.seed),
+		tokens(0),
+		haveRequest(false),
+		cursor(0),
+		lastRow(0),
+		issuedReads(0),
+		issuedWrites(0),
+		completed(0),
+		outstanding(0),
+		nextTxID(0),
+		measureStart(0),
+		measureIssuedBase(0),
+		measureCompletedBase(0)
+{
+	transactionSize = (JEDEC_DATA_BUS_BITS/8)*BL;
+	addressSpace = TOTAL_STORAGE << 20;
+
+	if (config.rank >= NUM_RANKS || config.bank >= NUM_BANKS)
+	{
+		ERROR("== Traffic generator bank "<<config.rank<<":"<<config.bank<<" does not exist");
+		exit(-1);
+	}
+
+	//every mapping scheme places each field in a contiguous run of address
+	//bits, so a single set bit lands in exactly one field (or none)
+	for (unsigned i=0; i<64; i++)
+	{
+		uint rank, bank, row, col;
+		memorySystem->memoryController->addressMapping(1ULL << i, rank, bank, row, col);
+		if (rank != 0)
+		{
+			rankBits.push_back(i);
+		}
+		else if (bank != 0)
+		{
+			bankBits.push_back(i);
+		}
+		else if (row != 0)
+		{
+			rowBits.push_back(i);
+		}
+		else if (col != 0)
+		{
+			colBits.push_back(i);
+		}
+	}
+
+	readCB = new Callback_4Param<TrafficGenerator, void, uint, uint64_t, uint64_t, uint64_t>(this, &TrafficGenerator::readComplete);
+	writeCB = new Callback_4Param<TrafficGenerator, void, uint, uint64_t, uint64_t, uint64_t>(this, &TrafficGenerator::writeComplete);
+	memorySystem->RegisterCallbacks(readCB, writeCB, NULL);
+}
+
+TrafficGenerator::~TrafficGenerator()
+{
+	memorySystem->RegisterCallbacks(NULL, NULL, NULL);
+	delete readCB;
+	delete writeCB;
+}
+
+//splitmix64, so a seed gives the same stream on every host
+uint64_t TrafficGenerator::random()
+{
+	uint64_t z = (rngState += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+uint64_t TrafficGenerator::randomField(const vector<unsigned> &bits)
+{
+	return random() & ((1ULL << bits.size()) - 1);
+}
+
+uint64_t TrafficGenerator::composeAddress(uint64_t rank, uint64_t bank, uint64_t row, uint64_t col)
+{
+	uint64_t address = 0;
+	for (size_t i=0; i<rankBits.size(); i++)
+	{
+		address |= ((rank >> i) & 1) << rankBits[i];
+	}
+	for (size_t i=0; i<bankBits.size(); i++)
+	{
+		address |= ((bank >> i) & 1) << bankBits[i];
+	}
+	for (size_t i=0; i<rowBits.size(); i++)
+	{
+		address |= ((row >> i) & 1) << rowBits[i];
+	}
+	for (size_t i=0; i<colBits.size(); i++)
+	{
+		address |= ((col >> i) & 1) << colBits[i];
+	}
+	return address;
+}
+
+uint64_t TrafficGenerator::nextAddress()
+{
+	uint64_t address = 0;
+	switch (config.pattern)
+	{
+	case TRAFFIC_UNIFORM:
+		address = composeAddress(randomField(rankBits) % NUM_RANKS, randomField(bankBits),
+		                         randomField(rowBits), randomField(colBits));
+		break;
+	case TRAFFIC_STREAM:
+		address = cursor;
+		cursor = (cursor + transactionSize) % addressSpace;
+		break;
+	case TRAFFIC_STRIDE:
+		address = cursor;
+		cursor = (cursor + config.stride) % addressSpace;
+		break;
+	case TRAFFIC_ROW_HOSTILE:
+	{
+		//a different row every time, so every access is a row conflict
+		uint64_t row = randomField(rowBits);
+		if (rowBits.size() > 0 && row == lastRow)
+		{
+			row = (row + 1) & ((1ULL << rowBits.size()) - 1);
+		}
+		lastRow = row;
+		address = composeAddress(config.rank, config.bank, row, randomField(colBits));
+		break;
+	}
+	}
+	return address & ~(uint64_t)(transactionSize - 1);
+}
+
+void TrafficGenerator::update()
+{
+	//requests the controller or the outstanding cap held back are not made up
+	//for later, so the offered load never exceeds the rate
+	tokens += config.rate;
+	while (tokens >= 1.0 && outstanding < config.maxOutstanding)
+	{
+		if (!haveRequest)
+		{
+			bool isWrite = (random() >> 11) * (1.0/9007199254740992.0) >= config.readFraction;
+			nextRequest = Transaction(isWrite ? DATA_WRITE : DATA_READ, nextAddress(), NULL, nextTxID);
+			haveRequest = true;
+		}
+		if (!memorySystem->addTransaction(nextRequest))
+		{
+			break;
+		}
+		haveRequest = false;
+		nextTxID++;
+		outstanding++;
+		tokens -= 1.0;
+		if (nextRequest.transactionType == DATA_WRITE)
+		{
+			issuedWrites++;
+		}
+		else
+		{
+			issuedReads++;
+			readIssueCycles[nextTxID - 1] = memorySystem->currentClockCycle;
+		}
+	}
+
+	double maxTokens = config.rate > 1.0 ? config.rate : 1.0;
+	if (tokens > maxTokens)
+	{
+		tokens = maxTokens;
+	}
+}
+
+void TrafficGenerator::readComplete(uint id, uint64_t address, uint64_t doneCycle, uint64_t txID)
+{
+	outstanding--;
+	completed++;
+
+	map<uint64_t, uint64_t>::iterator it = readIssueCycles.find(txID);
+	if (it == readIssueCycles.end())
+	{
+		ERROR("== Traffic generator got a completion for read "<<txID<<" it never issued");
+		exit(-1);
+	}
+	//reads issued during warmup still count, they completed in the window
+	uint64_t latency = doneCycle - it->second;
+	readIssueCycles.erase(it);
+	readLatencies.record(latency);
+}
+
+void TrafficGenerator::writeComplete(uint id, uint64_t address, uint64_t doneCycle, uint64_t txID)
+{
+	outstanding--;
+	completed++;
+}
+
+void TrafficGenerator::startMeasurement()
+{
+	measureStart = memorySystem->currentClockCycle;
+	measureIssuedBase = Issued();
+	measureCompletedBase = completed;
+	readLatencies.reset();
+}
+
+void TrafficGenerator::printStats()
+{
+	static const char *patternNames[] = {"uniform", "stream", "stride", "rowhostile"};
+	uint64_t cycles = memorySystem->currentClockCycle;
+	PRINT(" == Traffic generator ("<<patternNames[config.pattern]<<", seed "<<config.seed<<") ==");
+	PRINT("   Offered rate      : "<<config.rate<<" requests/cycle, at most "<<config.maxOutstanding<<" outstanding");
+	PRINT("   Issued            : "<<Issued()<<" ("<<issuedReads<<" reads, "<<issuedWrites<<" writes)");
+	PRINT("   Accepted rate     : "<<(cycles ? (double)Issued()/cycles : 0)<<" requests/cycle");
+	PRINT("   Completed         : "<<completed<<" ("<<outstanding<<" still outstanding)");
+	PRINT("   Read latency      : mean "<<MeanReadLatency()<<", p50 "<<ReadLatencyPercentile(0.5)<<", p99 "<<ReadLatencyPercentile(0.99)<<" cycles");
+}
@@ -0,0 +1,142 @@
+/****************************************************************************
+*	 DRAMSim2: A Cycle Accurate DRAM simulator 
+*	 
+*	 Copyright (C) 2010   	Elliott Cooper-Balis
+*									Paul Rosenfeld 
+*									Bruce Jacob
+*									University of Maryland
+*
+*	 This program is free software: you can redistribute it and/or modify
+*	 it under the terms of the GNU General Public License as published by
+*	 the Free Software Foundation, either version 3 of the License, or
+*	 (at your option) any later version.
+*
+*	 This program is distributed in the hope that it will be useful,
+*	 but WITHOUT ANY WARRANTY; without even the implied warranty of
+*	 MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*	 GNU General Public License for more details.
+*
+*	 You should have received a copy of the GNU General Public License
+*	 along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*****************************************************************************/
+#ifndef TRAFFICGENERATOR_H
+#define TRAFFICGENERATOR_H
+
+//TrafficGenerator.h
+//
+//Synthetic request streams fed straight into MemorySystem::addTransaction,
+//so a device configuration can be characterized without trace I/O. Every
+//pattern has a seed, a target injection rate (requests per cycle), a cap on
+//outstanding requests and a read fraction:
+//
+//	uniform		random rank, bank, row and column
+//	stream		consecutive transactions through the whole address space
+//	stride		like stream, but stride bytes apart
+//	rowhostile	one bank (bank=, rank=), a different random row every time
+//
+//Call update() once per cycle, before MemorySystem::update().
+//
+//Read latencies (issue to callback, in cycles) and completions are
+//measured from the last startMeasurement() on, so that a warmup phase can
+//be left out.
+//
+
+#include "MemorySystem.h"
+#include <map>
+#include "LatencyHistogram.h"
+
+namespace DRAMSim
+{
+enum TrafficPattern
+{
+	TRAFFIC_UNIFORM,
+	TRAFFIC_STREAM,
+	TRAFFIC_STRIDE,
+	TRAFFIC_ROW_HOSTILE
+};
+
+struct TrafficGeneratorConfig
+{
+	TrafficPattern pattern;
+	uint64_t seed;
+	double rate;			// offered requests per cycle
+	unsigned maxOutstanding;
+	double readFraction;
+	uint64_t stride;		// bytes, stride pattern only
+	unsigned rank;			// rowhostile pattern only
+	unsigned bank;
+
+	TrafficGeneratorConfig();
+};
+
+class TrafficGenerator
+{
+public:
+	//registers the generator's read and write callbacks with ms
+	TrafficGenerator(MemorySystem *ms, const TrafficGeneratorConfig &config);
+	virtual ~TrafficGenerator();
+
+	//parses "pattern[,key=value...]" with keys seed, rate, outstanding,
+	//reads, stride, rank and bank; exits on a malformed spec
+	static TrafficGeneratorConfig parseSpec(const string &spec);
+
+	void update();
+	void printStats();
+
+	uint64_t Issued() const { return issuedReads + issuedWrites; }
+	uint64_t Completed() const { return completed; }
+	unsigned Outstanding() const { return outstanding; }
+
+	void startMeasurement();
+	uint64_t MeasuredCycles() const { return memorySystem->currentClockCycle - measureStart; }
+	uint64_t MeasuredIssued() const { return Issued() - measureIssuedBase; }
+	uint64_t MeasuredCompleted() const { return completed - measureCompletedBase; }
+	uint64_t MeasuredReads() const { return readLatencies.Count(); }
+	double MeanReadLatency() const { return readLatencies.Mean(); }
+	//smallest latency that covers the given fraction (0..1) of measured reads,
+	//to within the histogram's bucket width
+	uint64_t ReadLatencyPercentile(double fraction) const { return readLatencies.percentile(fraction); }
+
+	void readComplete(uint id, uint64_t address, uint64_t doneCycle, uint64_t txID);
+	void writeComplete(uint id, uint64_t address, uint64_t doneCycle, uint64_t txID);
+
+private:
+	uint64_t random();
+	uint64_t randomField(const vector<unsigned> &bits);
+	uint64_t composeAddress(uint64_t rank, uint64_t bank, uint64_t row, uint64_t col);
+	uint64_t nextAddress();
+
+	MemorySystem *memorySystem;
+	TrafficGeneratorConfig config;
+	Callback_t *readCB;
+	Callback_t *writeCB;
+
+	uint64_t rngState;
+	double tokens;			// requests the rate allows but that have not been issued yet
+	bool haveRequest;		// the next request was generated but not accepted yet
+	Transaction nextRequest;	// offered again as is, so its admission wait is timed
+
+	uint64_t cursor;		// stream and stride patterns
+	uint64_t addressSpace;	// bytes
+	uint64_t transactionSize;
+	uint64_t lastRow;
+
+	//address bit positions of each field, found by probing the controller's address mapping
+	vector<unsigned> rankBits, bankBits, rowBits, colBits;
+
+	uint64_t issuedReads;
+	uint64_t issuedWrites;
+	uint64_t completed;
+	unsigned outstanding;
+	uint64_t nextTxID;
+
+	map<uint64_t, uint64_t> readIssueCycles;	// by transaction id
+	LatencyHistogram readLatencies;
+	uint64_t measureStart;
+	uint64_t measureIssuedBase;
+	uint64_t measureCompletedBase;
+};
+}
+
+#endif
@@ -46,21 +46,32 @@ Transaction::Transaction(TransactionType transType, uint64_t addr, void *dat, ui
 	address = addr;
 	data = dat;
 	id=txID;
+	timeIssued=TRANSACTION_NOT_ISSUED;
+	sourceID=0;
 }
 
 void Transaction::print()
 {
-	if (transactionType == DATA_READ)
+	if (transactionType <= RETURN_DATA)
 	{
-		PRINT("T [Read] [0x" << hex << address << "]" << dec );
+		PRINT_DEFERRED(transaction(*this), *this);
 	}
-	else if (transactionType == DATA_WRITE)
+}
+
+std::ostream &DRAMSim::operator<<(std::ostream &out, const Transaction &transaction)
+{
+	if (transaction.transactionType == DATA_READ)
+	{
+		out << "T [Read] [0x" << hex << transaction.address << "]" << dec;
+	}
+	else if (transaction.transactionType == DATA_WRITE)
 	{
-		PRINT("T [Write] [0x" << hex << address << "] [" << dec << data << "]" );
+		out << "T [Write] [0x" << hex << transaction.address << "] [" << dec << transaction.data << "]";
 	}
-	else if (transactionType == RETURN_DATA)
+	else if (transaction.transactionType == RETURN_DATA)
 	{
-		PRINT("T [Data] [0x" << hex << address << "] [" << dec << data << "]" );
+		out << "T [Data] [0x" << hex << transaction.address << "] [" << dec << transaction.data << "]";
 	}
+	return out;
 }
 
@@ -34,9 +34,17 @@
 //Header file for transaction object
 
 #include "SystemConfiguration.h"
+#include "LatencyBreakdown.h"
 
 using namespace std;
 
+//timeIssued of a transaction that hasn't been offered to a memory system yet
+#define TRANSACTION_NOT_ISSUED ((uint64_t)-1)
+
+//per-source statistics are kept for this many sources; source ids from
+//MAX_SOURCES-1 up (ex: thread ids or tags used as producer ids) share the last
+#define MAX_SOURCES 64
+
 namespace DRAMSim
 {
 enum TransactionType
@@ -55,7 +63,10 @@ public:
 	void *data;
 	uint64_t timeAdded;
 	uint64_t timeReturned;
+	uint64_t timeIssued;
 	uint64_t id;
+	unsigned sourceID;	// core/trace the request came from, for per-source stats
+	LatencyStamps stamps;	// for read data on its way back, see LatencyBreakdown.h
 
 	//functions
 	Transaction(TransactionType transType, uint64_t addr, void *data, uint64_t txTD);
@@ -64,6 +75,8 @@ public:
 	void print();
 };
 
+std::ostream &operator<<(std::ostream &out, const Transaction &transaction);
+
 }
 
 #endif